@@ -4,8 +4,10 @@
 
 #include "bench.h"
 
+#include "chainparams.h"
 #include "crypto/sha256.h"
 #include "key.h"
+#include "prime/sieve_kernels.h"
 #include "validation.h"
 #include "util.h"
 #include "random.h"
@@ -14,10 +16,12 @@ int
 main(int argc, char** argv)
 {
     SHA256AutoDetect();
+    SieveKernelsAutoDetect();
     RandomInit();
     ECC_Start();
     SetupEnvironment();
     fPrintToDebugLog = false; // don't want to write to debug.log file
+    SelectParams(CBaseChainParams::MAIN);
 
     benchmark::BenchRunner::RunAll();
 
@@ -0,0 +1,30 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench_util.h"
+
+#include "chainparams.h"
+#include "hash.h"
+
+mpz_class BenchHeaderHash(uint32_t nSeed)
+{
+    CHashWriter ss(SER_GETHASH, 0);
+    ss << std::string("Datacoin bench") << nSeed;
+    uint256 hash = ss.GetHash();
+    *(hash.end() - 1) |= 0x80;
+    mpz_class mpzHash;
+    mpz_set_uint256(mpzHash.get_mpz_t(), hash);
+    return mpzHash;
+}
+
+BenchSelectParams::BenchSelectParams(const std::string& chain) :
+    strChainSaved(Params().NetworkIDString())
+{
+    SelectParams(chain);
+}
+
+BenchSelectParams::~BenchSelectParams()
+{
+    SelectParams(strChainSaved);
+}
@@ -0,0 +1,34 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BENCH_BENCH_UTIL_H
+#define BITCOIN_BENCH_BENCH_UTIL_H
+
+#include "prime/prime.h"
+
+#include <stdint.h>
+#include <string>
+
+/** Deterministic block header hash above hashBlockHeaderLimit */
+mpz_class BenchHeaderHash(uint32_t nSeed);
+
+/**
+ * Selects the params of a chain for code that reads Params(), such as the
+ * chain length bounds of CheckPrimeProofOfWork, and selects the previous
+ * ones again when it goes out of scope.
+ */
+class BenchSelectParams
+{
+public:
+    explicit BenchSelectParams(const std::string& chain);
+    ~BenchSelectParams();
+
+    BenchSelectParams(const BenchSelectParams&) = delete;
+    BenchSelectParams& operator=(const BenchSelectParams&) = delete;
+
+private:
+    const std::string strChainSaved;
+};
+
+#endif // BITCOIN_BENCH_BENCH_UTIL_H
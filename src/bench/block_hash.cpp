@@ -0,0 +1,49 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "hash.h"
+#include "primitives/block.h"
+#include "uint256.h"
+
+static CBlockHeader CreateBenchHeader()
+{
+    CBlockHeader header;
+    header.nVersion = 2;
+    header.hashPrevBlock = uint256S("0x8a8b2b1b1a5f8b2e92b4b3a6a1b6f4e3c20f7b4b1c55e1fa6e4a2c7e80d9b2a1");
+    header.hashMerkleRoot = uint256S("0x5e1ab0bd1b2ec5a4c1b7cb41e7b9fd3b7b5a2f3b4c4b0b6a2c7cd2e04e6e1f3c");
+    header.nTime = 1500000000;
+    header.nBits = 0x0a8d5b29;
+    header.nNonce = 178734;
+    // a multiplier of the size found in mined blocks
+    header.bnPrimeChainMultiplier.SetHex("3f32ab0edb8b84d9e5cb5e");
+    return header;
+}
+
+// Block hash as computed by CBlockHeader::GetHash
+static void BlockHeaderHash(benchmark::State& state)
+{
+    const CBlockHeader header = CreateBenchHeader();
+    uint256 hash;
+    while (state.KeepRunning()) {
+        hash = header.GetHash();
+    }
+}
+
+// The same hash with the multiplier serialized through CBigNum::getvch, as
+// CBigNum::Serialize used to do
+static void BlockHeaderHashGetVch(benchmark::State& state)
+{
+    const CBlockHeader header = CreateBenchHeader();
+    uint256 hash;
+    while (state.KeepRunning()) {
+        CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+        ss << header.nVersion << header.hashPrevBlock << header.hashMerkleRoot << header.nTime << header.nBits << header.nNonce << header.bnPrimeChainMultiplier.getvch();
+        hash = ss.GetHash();
+    }
+}
+
+BENCHMARK(BlockHeaderHash);
+BENCHMARK(BlockHeaderHashGetVch);
@@ -3,54 +3,108 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "bench.h"
+#include "bench_util.h"
 
 #include "chainparams.h"
 #include "validation.h"
+#include "prime/prime.h"
 #include "streams.h"
 #include "consensus/validation.h"
 
+// block_main_genesis is the mainnet genesis block. block_regtest_payments
+// (1000 payment transactions) and block_regtest_data (seven transactions
+// with 128 KiB data payloads) are regtest blocks on top of the regtest
+// genesis block with a valid proof-of-work.
 namespace block_bench {
-#include "bench/data/block413567.raw.h"
+#include "bench/data/block_main_genesis.raw.h"
+#include "bench/data/block_regtest_payments.raw.h"
+#include "bench/data/block_regtest_data.raw.h"
 } // namespace block_bench
 
 // These are the two major time-sinks which happen after we have fully received
 // a block off the wire, but before we can relay the block on to peers using
 // compact block relay.
 
-static void DeserializeBlockTest(benchmark::State& state)
+static void DeserializeBlock(benchmark::State& state, const unsigned char* pblock, size_t nSize)
 {
-    CDataStream stream((const char*)block_bench::block413567,
-            (const char*)&block_bench::block413567[sizeof(block_bench::block413567)],
-            SER_NETWORK, PROTOCOL_VERSION);
+    CDataStream stream((const char*)pblock, (const char*)&pblock[nSize], SER_NETWORK, PROTOCOL_VERSION);
     char a = '\0';
     stream.write(&a, 1); // Prevent compaction
 
     while (state.KeepRunning()) {
         CBlock block;
         stream >> block;
-        assert(stream.Rewind(sizeof(block_bench::block413567)));
+        assert(stream.Rewind(nSize));
     }
 }
 
-static void DeserializeAndCheckBlockTest(benchmark::State& state)
+static void DeserializeAndCheckBlock(benchmark::State& state, const unsigned char* pblock, size_t nSize, const std::string& chain, bool fCheckPOW)
 {
-    CDataStream stream((const char*)block_bench::block413567,
-            (const char*)&block_bench::block413567[sizeof(block_bench::block413567)],
-            SER_NETWORK, PROTOCOL_VERSION);
+    CDataStream stream((const char*)pblock, (const char*)&pblock[nSize], SER_NETWORK, PROTOCOL_VERSION);
     char a = '\0';
     stream.write(&a, 1); // Prevent compaction
 
-    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    const std::unique_ptr<CChainParams> chainParams = CreateChainParams(chain);
+    const Consensus::Params& consensusParams = chainParams->GetConsensus();
+    // CheckPrimeProofOfWork still takes the chain length bounds from Params()
+    BenchSelectParams selectParams(chain);
 
     while (state.KeepRunning()) {
         CBlock block; // Note that CBlock caches its checked state, so we need to recreate it here
         stream >> block;
-        assert(stream.Rewind(sizeof(block_bench::block413567)));
+        assert(stream.Rewind(nSize));
+
+        // The proof-of-work is checked without the cache of verified proofs,
+        // as for a block seen for the first time
+        if (fCheckPOW) {
+            unsigned int nChainType = 0, nChainLength = 0;
+            assert(CheckPrimeProofOfWork(block.GetHeaderHash(), block.nBits, block.bnPrimeChainMultiplier, nChainType, nChainLength));
+        }
 
         CValidationState validationState;
-        assert(CheckBlock(block, validationState, chainParams->GetConsensus()));
+        assert(CheckBlock(block, validationState, consensusParams, fCheckPOW));
     }
 }
 
+static void DeserializeBlockTest(benchmark::State& state)
+{
+    DeserializeBlock(state, block_bench::block_regtest_payments, sizeof(block_bench::block_regtest_payments));
+}
+
+static void DeserializeDataBlockTest(benchmark::State& state)
+{
+    DeserializeBlock(state, block_bench::block_regtest_data, sizeof(block_bench::block_regtest_data));
+}
+
+static void DeserializeAndCheckBlockTest(benchmark::State& state)
+{
+    DeserializeAndCheckBlock(state, block_bench::block_regtest_payments, sizeof(block_bench::block_regtest_payments), CBaseChainParams::REGTEST, true);
+}
+
+static void DeserializeAndCheckBlockNoPowTest(benchmark::State& state)
+{
+    DeserializeAndCheckBlock(state, block_bench::block_regtest_payments, sizeof(block_bench::block_regtest_payments), CBaseChainParams::REGTEST, false);
+}
+
+static void DeserializeAndCheckDataBlockTest(benchmark::State& state)
+{
+    DeserializeAndCheckBlock(state, block_bench::block_regtest_data, sizeof(block_bench::block_regtest_data), CBaseChainParams::REGTEST, true);
+}
+
+static void DeserializeAndCheckDataBlockNoPowTest(benchmark::State& state)
+{
+    DeserializeAndCheckBlock(state, block_bench::block_regtest_data, sizeof(block_bench::block_regtest_data), CBaseChainParams::REGTEST, false);
+}
+
+static void DeserializeAndCheckGenesisBlockTest(benchmark::State& state)
+{
+    DeserializeAndCheckBlock(state, block_bench::block_main_genesis, sizeof(block_bench::block_main_genesis), CBaseChainParams::MAIN, true);
+}
+
 BENCHMARK(DeserializeBlockTest);
+BENCHMARK(DeserializeDataBlockTest);
 BENCHMARK(DeserializeAndCheckBlockTest);
+BENCHMARK(DeserializeAndCheckBlockNoPowTest);
+BENCHMARK(DeserializeAndCheckDataBlockTest);
+BENCHMARK(DeserializeAndCheckDataBlockNoPowTest);
+BENCHMARK(DeserializeAndCheckGenesisBlockTest);
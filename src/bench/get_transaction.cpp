@@ -0,0 +1,147 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "chainparams.h"
+#include "hash.h"
+#include "streams.h"
+#include "sync.h"
+#include "txdb.h"
+#include "util.h"
+#include "validation.h"
+
+#include <thread>
+
+namespace block_bench {
+#include "bench/data/block_regtest_data.raw.h"
+} // namespace block_bench
+
+static const int GETDATA_READERS = 4;
+
+// The data block in blk00000.dat of a temporary data directory, and the
+// position of its last transaction as the tx index and the data index store it
+static CDiskTxPos WriteDataBlock(fs::path& dir, CDiskDataPos* pposData = nullptr)
+{
+    dir = fs::temp_directory_path() / fs::unique_path("bench_getdata_%%%%%%%%");
+    fs::create_directories(dir / "blocks");
+    gArgs.ForceSetArg("-datadir", dir.string());
+    ClearDatadirCache();
+
+    CDataStream stream((const char*)block_bench::block_regtest_data,
+            (const char*)&block_bench::block_regtest_data[sizeof(block_bench::block_regtest_data)],
+            SER_NETWORK, PROTOCOL_VERSION);
+    CBlock block;
+    stream >> block;
+
+    CDiskBlockPos pos(0, 0);
+    CAutoFile file(OpenBlockFile(pos), SER_DISK, CLIENT_VERSION);
+    assert(!file.IsNull());
+    file << block;
+
+    CDiskTxPos postx(pos, GetSizeOfCompactSize(block.vtx.size()));
+    for (size_t i = 0; i + 1 < block.vtx.size(); i++)
+        postx.nTxOffset += ::GetSerializeSize(*block.vtx[i], SER_DISK, CLIENT_VERSION);
+
+    if (pposData) {
+        const CTransaction& tx = *block.vtx.back();
+        uint256 hashData;
+        CSHA256().Write(tx.data.data(), tx.data.size()).Finalize(hashData.begin());
+        unsigned int nEnd = ::GetSerializeSize(block.GetBlockHeader(), SER_DISK, CLIENT_VERSION) + postx.nTxOffset + ::GetSerializeSize(tx, SER_DISK, CLIENT_VERSION);
+        *pposData = CDiskDataPos(CDiskBlockPos(pos.nFile, pos.nPos + nEnd - tx.data.size()), tx.data.size(), hashData);
+    }
+    return postx;
+}
+
+static void RemoveDataBlock(const fs::path& dir)
+{
+    fs::remove_all(dir);
+    gArgs.ForceSetArg("-datadir", "");
+    ClearDatadirCache();
+}
+
+// getdata readers of one 128 KiB payload, with or without cs_main held
+// during the read as GetTransaction used to do
+static void ReadDataTransaction(benchmark::State& state, int nReaders, bool fLocked)
+{
+    fs::path dir;
+    const CDiskTxPos postx = WriteDataBlock(dir);
+
+    auto read = [&postx, fLocked]() {
+        CTransactionRef tx;
+        uint256 hashBlock;
+        if (fLocked) {
+            LOCK(cs_main);
+            assert(ReadTransactionFromDisk(postx, tx, hashBlock));
+        } else {
+            assert(ReadTransactionFromDisk(postx, tx, hashBlock));
+        }
+    };
+
+    while (state.KeepRunning()) {
+        std::vector<std::thread> threads;
+        for (int i = 1; i < nReaders; i++)
+            threads.emplace_back(read);
+        read();
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    RemoveDataBlock(dir);
+}
+
+// getdata of the same payload through the data index
+static void ReadDataPayload(benchmark::State& state, int nReaders)
+{
+    fs::path dir;
+    CDiskDataPos posData;
+    WriteDataBlock(dir, &posData);
+
+    auto read = [&posData]() {
+        std::vector<unsigned char> data;
+        assert(ReadDataFromDisk(posData, data));
+    };
+
+    while (state.KeepRunning()) {
+        std::vector<std::thread> threads;
+        for (int i = 1; i < nReaders; i++)
+            threads.emplace_back(read);
+        read();
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    RemoveDataBlock(dir);
+}
+
+static void GetDataFromDisk(benchmark::State& state)
+{
+    ReadDataTransaction(state, 1, false);
+}
+
+static void GetDataFromDiskConcurrent(benchmark::State& state)
+{
+    ReadDataTransaction(state, GETDATA_READERS, false);
+}
+
+static void GetDataFromDiskConcurrentLocked(benchmark::State& state)
+{
+    ReadDataTransaction(state, GETDATA_READERS, true);
+}
+
+static void GetDataFromIndex(benchmark::State& state)
+{
+    ReadDataPayload(state, 1);
+}
+
+static void GetDataFromIndexConcurrent(benchmark::State& state)
+{
+    ReadDataPayload(state, GETDATA_READERS);
+}
+
+BENCHMARK(GetDataFromDisk);
+BENCHMARK(GetDataFromDiskConcurrent);
+BENCHMARK(GetDataFromDiskConcurrentLocked);
+BENCHMARK(GetDataFromIndex);
+BENCHMARK(GetDataFromIndexConcurrent);
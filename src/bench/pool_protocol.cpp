@@ -0,0 +1,107 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "madpool/pool.h"
+#include "uint256.h"
+
+static const uint256 hashBenchHeader = uint256S("0x9bbd7e12e3f5f1b8d1e1fd2b19a8e6a92c15ad8ed7d5a1cf5b3d0e6f8a2c4e61");
+static const uint256 hashBenchMerkleRoot = uint256S("0x4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+
+// SHARE request of a miner, with the hashes of the share in hex or in binary
+static std::string MakeShareRequest(bool fBinary)
+{
+    const CBigNum bnMultiplier = CBigNum(2 * 3 * 5 * 7 * 11 * 13 * 17 * 19 * 23) * 1234567;
+
+    proto::Request req;
+    req.set_type(proto::Request::SHARE);
+    req.set_reqid(1);
+    req.set_version(fBinary ? POOL_BINARY_VERSION : 10);
+    req.set_reqnonce(std::string(32, '\0'));
+
+    proto::Share* share = req.mutable_share();
+    share->set_addr("DBenchPoolAddressXXXXXXXXXXXXXXXXX");
+    share->set_name("bench");
+    share->set_clientid(1);
+    share->set_time(1500000000);
+    share->set_bits(TargetFromInt(9));
+    share->set_nonce(12345);
+    share->set_height(1000);
+    share->set_length(7);
+    share->set_chaintype(0);
+    share->set_isblock(false);
+    if (fBinary) {
+        const std::vector<unsigned char> vchMultiplier = bnMultiplier.getvch();
+        share->set_hash(std::string());
+        share->set_merkle(std::string());
+        share->set_multi(std::string());
+        share->set_hashbin(hashBenchHeader.begin(), hashBenchHeader.size());
+        share->set_merklebin(hashBenchMerkleRoot.begin(), hashBenchMerkleRoot.size());
+        share->set_multibin(vchMultiplier.data(), vchMultiplier.size());
+    } else {
+        share->set_hash(hashBenchHeader.GetHex());
+        share->set_merkle(hashBenchMerkleRoot.GetHex());
+        share->set_multi(bnMultiplier.GetHex());
+    }
+    return req.SerializeAsString();
+}
+
+// What a pool worker does with a SHARE message before checking the header
+static void ParseShare(benchmark::State& state, bool fBinary)
+{
+    const std::string msg = MakeShareRequest(fBinary);
+    proto::Request req;
+    uint256 hashHeader, hashMerkleRoot;
+    CBigNum bnMultiplier;
+    while (state.KeepRunning()) {
+        bool fOk = req.ParseFromString(msg) && ReadShareHashes(req.share(), hashHeader, hashMerkleRoot, bnMultiplier);
+        assert(fOk);
+    }
+    assert(hashHeader == hashBenchHeader && hashMerkleRoot == hashBenchMerkleRoot);
+}
+
+// GETWORK reply of a pool worker
+static void SerializeWork(benchmark::State& state, unsigned nVersion)
+{
+    proto::Reply rep;
+    std::string msg;
+    while (state.KeepRunning()) {
+        rep.Clear();
+        rep.set_type(proto::Request::GETWORK);
+        rep.set_reqid(1);
+        rep.set_error(proto::Reply::NONE);
+        proto::Work* work = rep.mutable_work();
+        work->set_height(1000);
+        SetWorkMerkleRoot(*work, hashBenchMerkleRoot, nVersion);
+        work->set_time(1500000000);
+        work->set_bits(TargetFromInt(9));
+        rep.SerializeToString(&msg);
+    }
+}
+
+static void PoolParseShareHex(benchmark::State& state)
+{
+    ParseShare(state, false);
+}
+
+static void PoolParseShareBinary(benchmark::State& state)
+{
+    ParseShare(state, true);
+}
+
+static void PoolSerializeWorkHex(benchmark::State& state)
+{
+    SerializeWork(state, 10);
+}
+
+static void PoolSerializeWorkBinary(benchmark::State& state)
+{
+    SerializeWork(state, POOL_BINARY_VERSION);
+}
+
+BENCHMARK(PoolParseShareHex);
+BENCHMARK(PoolParseShareBinary);
+BENCHMARK(PoolSerializeWorkHex);
+BENCHMARK(PoolSerializeWorkBinary);
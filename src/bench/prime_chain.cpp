@@ -0,0 +1,131 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "bench_util.h"
+
+#include "primitives/block.h"
+#include "prime/prime.h"
+
+// Chain origins of the first sieve candidates of a mainnet sized sieve, of
+// the size the miner tests
+struct BenchCandidates
+{
+    std::vector<mpz_class> vOrigins;
+    std::vector<unsigned int> vCandidateTypes;
+
+    BenchCandidates()
+    {
+        if (vPrimes.empty())
+            GeneratePrimeTable();
+
+        mpz_class mpzHash = BenchHeaderHash(0);
+        mpz_class mpzFixedMultiplier;
+        Primorial(nInitialPrimorialMultiplier, mpzFixedMultiplier);
+
+        CSieveOfEratosthenes sieve;
+        sieve.Reset(nDefaultSieveSize, nDefaultSieveFilterPrimes, nDefaultSieveExtensions, nDefaultL1CacheSize, TargetFromInt(10), mpzHash, mpzFixedMultiplier, nullptr, 1);
+        sieve.Weave();
+
+        unsigned int nMultiplier = 0, nCandidateType = 0;
+        while (vOrigins.size() < 1024 && sieve.GetNextCandidateMultiplier(nMultiplier, nCandidateType)) {
+            vOrigins.push_back(mpzHash * mpzFixedMultiplier * nMultiplier);
+            vCandidateTypes.push_back(nCandidateType);
+        }
+        assert(!vOrigins.empty());
+    }
+};
+
+// Fermat test of the first number of a candidate chain
+static void PrimeFermatTest(benchmark::State& state)
+{
+    const BenchCandidates candidates;
+    CPrimalityTestParams testParams;
+    mpz_class mpzN;
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        const mpz_class& mpzOrigin = candidates.vOrigins[i];
+        if (candidates.vCandidateTypes[i] == PRIME_CHAIN_CUNNINGHAM2)
+            mpzN = mpzOrigin + 1;
+        else
+            mpzN = mpzOrigin - 1;
+        ProbablePrimalityTestWithTrialDivision(mpzN, 0, testParams);
+        i = (i + 1) % candidates.vOrigins.size();
+    }
+}
+
+// Chain test of the candidates as done by CheckPrimeProofOfWork
+static void PrimeChainTestVerify(benchmark::State& state)
+{
+    const BenchCandidates candidates;
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        unsigned int nCC1 = 0, nCC2 = 0, nTWN = 0, nCC1Fermat = 0, nCC2Fermat = 0, nTWNFermat = 0;
+        ProbablePrimeChainTestVerify(candidates.vOrigins[i], TargetFromInt(10), nCC1, nCC2, nTWN, nCC1Fermat, nCC2Fermat, nTWNFermat);
+        i = (i + 1) % candidates.vOrigins.size();
+    }
+}
+
+// The same chain test with the OpenSSL based reference implementation
+static void PrimeChainTestReference(benchmark::State& state)
+{
+    const BenchCandidates candidates;
+    std::vector<CBigNum> vOrigins(candidates.vOrigins.size());
+    for (size_t i = 0; i < vOrigins.size(); i++)
+        vOrigins[i].SetHex(candidates.vOrigins[i].get_str(16));
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        unsigned int nCC1 = 0, nCC2 = 0, nTWN = 0;
+        ProbablePrimeChainTest(vOrigins[i], TargetFromInt(10), false, nCC1, nCC2, nTWN);
+        i = (i + 1) % vOrigins.size();
+    }
+}
+
+// One call of the miner for a ten long chain target, testing up to 500
+// candidates. The sieve is rebuilt for the next header whenever it is
+// depleted, in the same proportion as while mining.
+static void PrimeMineChain(benchmark::State& state)
+{
+    if (vPrimes.empty())
+        GeneratePrimeTable();
+
+    CBlock block;
+    block.nBits = TargetFromInt(10);
+    mpz_class mpzFixedMultiplier;
+    Primorial(nInitialPrimorialMultiplier, mpzFixedMultiplier);
+
+    CSieveOfEratosthenes sieve;
+    CPrimalityTestParams testParams;
+    unsigned int vChainsFound[nMaxChainLength] = {};
+    mpz_class mpzHash;
+    uint32_t nSeed = 0;
+    bool fNewBlock = true;
+    while (state.KeepRunning()) {
+        if (fNewBlock)
+            mpzHash = BenchHeaderHash(nSeed++);
+        unsigned int nTests = 0, nPrimesHit = 0;
+        MineProbablePrimeChain(block, mpzFixedMultiplier, fNewBlock, nTests, nPrimesHit, mpzHash, nullptr, vChainsFound, sieve, testParams);
+    }
+}
+
+// Prime probability estimate of the mining statistics
+static void PrimeEstimateProbability(benchmark::State& state)
+{
+    if (vPrimes.empty())
+        GeneratePrimeTable();
+
+    double dProbability = 0.0;
+    while (state.KeepRunning()) {
+        for (unsigned int n = 0; n < 10; n++)
+            dProbability += EstimateCandidatePrimeProbability(nInitialPrimorialMultiplier, n, 1);
+    }
+    assert(dProbability > 0.0);
+}
+
+BENCHMARK(PrimeFermatTest);
+BENCHMARK(PrimeChainTestVerify);
+BENCHMARK(PrimeChainTestReference);
+BENCHMARK(PrimeMineChain);
+BENCHMARK(PrimeEstimateProbability);
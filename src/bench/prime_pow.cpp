@@ -0,0 +1,61 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "bench_util.h"
+
+#include "chainparams.h"
+#include "hash.h"
+#include "prime/prime.h"
+
+// Consensus check of the prime proof-of-work of a genesis block header
+static void CheckGenesisProofOfWork(benchmark::State& state, const std::string& chain)
+{
+    // CheckPrimeProofOfWork takes the chain length bounds from Params()
+    BenchSelectParams selectParams(chain);
+    const CBlockHeader header = Params().GenesisBlock().GetBlockHeader();
+    const uint256 hash = header.GetHeaderHash();
+    while (state.KeepRunning()) {
+        unsigned int nChainType = 0, nChainLength = 0;
+        bool fValid = CheckPrimeProofOfWork(hash, header.nBits, header.bnPrimeChainMultiplier, nChainType, nChainLength);
+        assert(fValid);
+    }
+}
+
+static void PrimeCheckPowMainGenesis(benchmark::State& state)
+{
+    CheckGenesisProofOfWork(state, CBaseChainParams::MAIN);
+}
+
+static void PrimeCheckPowTestnetGenesis(benchmark::State& state)
+{
+    CheckGenesisProofOfWork(state, CBaseChainParams::TESTNET);
+}
+
+// Rejection of headers whose multiplier is not the origin of a prime chain,
+// the cost of a header with an invalid proof-of-work
+static void PrimeCheckPowInvalid(benchmark::State& state)
+{
+    BenchSelectParams selectParams(CBaseChainParams::MAIN);
+    std::vector<uint256> vHashes;
+    for (uint32_t nSeed = 0; vHashes.size() < 64; nSeed++) {
+        CHashWriter ss(SER_GETHASH, 0);
+        ss << std::string("Datacoin pow bench") << nSeed;
+        uint256 hash = ss.GetHash();
+        *(hash.end() - 1) |= 0x80; // above hashBlockHeaderLimit
+        vHashes.push_back(hash);
+    }
+    const CBigNum bnMultiplier = CBigNum(2 * 3 * 5 * 7 * 11 * 13 * 17 * 19 * 23) * 1234567;
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        unsigned int nChainType = 0, nChainLength = 0;
+        CheckPrimeProofOfWork(vHashes[i], TargetFromInt(10), bnMultiplier, nChainType, nChainLength, true);
+        i = (i + 1) % vHashes.size();
+    }
+}
+
+BENCHMARK(PrimeCheckPowMainGenesis);
+BENCHMARK(PrimeCheckPowTestnetGenesis);
+BENCHMARK(PrimeCheckPowInvalid);
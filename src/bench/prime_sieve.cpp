@@ -0,0 +1,105 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "bench_util.h"
+
+#include "prime/prime.h"
+#include "util.h"
+
+// Weave a sieve for a ten long chain target with the given parameters
+static void WeaveSieve(benchmark::State& state, unsigned int nSize, unsigned int nFilterPrimes, unsigned int nExtensions, unsigned int nWeaveThreads)
+{
+    if (vPrimes.empty())
+        GeneratePrimeTable();
+
+    mpz_class mpzHash = BenchHeaderHash(0);
+    mpz_class mpzFixedMultiplier;
+    Primorial(nInitialPrimorialMultiplier, mpzFixedMultiplier);
+
+    CSieveOfEratosthenes sieve;
+    while (state.KeepRunning()) {
+        sieve.Reset(nSize, nFilterPrimes, nExtensions, nDefaultL1CacheSize, TargetFromInt(10), mpzHash, mpzFixedMultiplier, nullptr, nWeaveThreads);
+        sieve.Weave();
+    }
+}
+
+// Mainnet sized sieve (default size, filter primes and extensions)
+static void PrimeSieveWeave(benchmark::State& state)
+{
+    WeaveSieve(state, nDefaultSieveSize, nDefaultSieveFilterPrimes, nDefaultSieveExtensions, 1);
+}
+
+static void PrimeSieveWeaveThreads(benchmark::State& state)
+{
+    WeaveSieve(state, nDefaultSieveSize, nDefaultSieveFilterPrimes, nDefaultSieveExtensions, std::max(2, GetNumCores()));
+}
+
+static void PrimeSieveWeaveSmall(benchmark::State& state)
+{
+    WeaveSieve(state, nDefaultSieveSize / 4, nDefaultSieveFilterPrimes, nDefaultSieveExtensions, 1);
+}
+
+static void PrimeSieveWeaveLarge(benchmark::State& state)
+{
+    WeaveSieve(state, nDefaultSieveSize * 4, nDefaultSieveFilterPrimes, nDefaultSieveExtensions, 1);
+}
+
+static void PrimeSieveWeaveNoExtensions(benchmark::State& state)
+{
+    WeaveSieve(state, nDefaultSieveSize, nDefaultSieveFilterPrimes, 0, 1);
+}
+
+static void PrimeSieveWeaveTestnetExtensions(benchmark::State& state)
+{
+    WeaveSieve(state, nDefaultSieveSize, nDefaultSieveFilterPrimes, nDefaultSieveExtensionsTestnet, 1);
+}
+
+static void PrimeSieveWeaveMaxExtensions(benchmark::State& state)
+{
+    WeaveSieve(state, nDefaultSieveSize, nDefaultSieveFilterPrimes, nMaxSieveExtensions, 1);
+}
+
+static void PrimeSieveWeaveFewPrimes(benchmark::State& state)
+{
+    WeaveSieve(state, nDefaultSieveSize, nMinSieveFilterPrimes, nDefaultSieveExtensions, 1);
+}
+
+static void PrimeSieveWeaveManyPrimes(benchmark::State& state)
+{
+    WeaveSieve(state, nDefaultSieveSize, nDefaultSieveFilterPrimes * 4, nDefaultSieveExtensions, 1);
+}
+
+// Scan all the candidates of a woven mainnet sized sieve, as the miner does
+// between the primality tests
+static void PrimeSieveCandidates(benchmark::State& state)
+{
+    if (vPrimes.empty())
+        GeneratePrimeTable();
+
+    mpz_class mpzHash = BenchHeaderHash(0);
+    mpz_class mpzFixedMultiplier;
+    Primorial(nInitialPrimorialMultiplier, mpzFixedMultiplier);
+
+    CSieveOfEratosthenes sieve;
+    sieve.Reset(nDefaultSieveSize, nDefaultSieveFilterPrimes, nDefaultSieveExtensions, nDefaultL1CacheSize, TargetFromInt(10), mpzHash, mpzFixedMultiplier, nullptr, 1);
+    sieve.Weave();
+
+    unsigned int nMultiplier = 0, nCandidateType = 0;
+    while (state.KeepRunning()) {
+        // The scan starts over after the last candidate
+        while (sieve.GetNextCandidateMultiplier(nMultiplier, nCandidateType));
+    }
+}
+
+BENCHMARK(PrimeSieveWeave);
+BENCHMARK(PrimeSieveWeaveThreads);
+BENCHMARK(PrimeSieveWeaveSmall);
+BENCHMARK(PrimeSieveWeaveLarge);
+BENCHMARK(PrimeSieveWeaveNoExtensions);
+BENCHMARK(PrimeSieveWeaveTestnetExtensions);
+BENCHMARK(PrimeSieveWeaveMaxExtensions);
+BENCHMARK(PrimeSieveWeaveFewPrimes);
+BENCHMARK(PrimeSieveWeaveManyPrimes);
+BENCHMARK(PrimeSieveCandidates);
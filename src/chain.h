@@ -7,8 +7,11 @@
 #define BITCOIN_CHAIN_H
 
 #include "arith_uint256.h"
+#include "memusage.h"
+#include "prevector.h"
 #include "primitives/block.h"
 #include "pow.h"
+#include "serialize.h"
 #include "tinyformat.h"
 #include "uint256.h"
 
@@ -162,6 +165,65 @@ enum BlockStatus: uint32_t {
     BLOCK_OPT_WITNESS       =   128, //!< block data in blk*.data was received with a witness-enforcing client
 };
 
+/**
+ * Prime chain multiplier of a block index entry. It is kept in the byte
+ * format CBigNum serializes to (little endian magnitude, sign in the top bit)
+ * so that realistic multipliers fit inline, where a CBigNum is an OpenSSL
+ * BIGNUM with a heap allocation of its own. Larger multipliers spill to the
+ * heap. Serializes exactly like the CBigNum it holds.
+ */
+class CCompactMultiplier
+{
+public:
+    //! Multipliers up to this many bytes, sign included, are stored inline
+    static const unsigned int INLINE_SIZE = 20;
+
+private:
+    typedef prevector<INLINE_SIZE, unsigned char> vch_type;
+    vch_type vch;
+
+public:
+    CCompactMultiplier() {}
+
+    CCompactMultiplier& operator=(const CBigNum& bn)
+    {
+        std::vector<unsigned char> vchBigNum = bn.getvch();
+        vch = vch_type(vchBigNum.begin(), vchBigNum.end());
+        return *this;
+    }
+
+    void SetNull() { vch = vch_type(); }
+    bool IsNull() const { return vch.empty(); }
+
+    CBigNum GetBigNum() const
+    {
+        CBigNum bn;
+        bn.setvch(std::vector<unsigned char>(vch.begin(), vch.end()));
+        return bn;
+    }
+
+    std::string ToString() const { return GetBigNum().ToString(); }
+
+    //! Whether the multiplier did not fit inline
+    bool IsSpilled() const { return vch.allocated_memory() != 0; }
+
+    size_t DynamicMemoryUsage() const { return memusage::DynamicUsage(vch); }
+
+    //! Memory a CBigNum holding this multiplier would take, for comparison
+    size_t BigNumMemoryUsage() const
+    {
+        size_t nWords = (vch.size() + sizeof(BN_ULONG) - 1) / sizeof(BN_ULONG);
+        return sizeof(CBigNum) + (nWords ? memusage::MallocUsage(nWords * sizeof(BN_ULONG)) : 0);
+    }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(vch);
+    }
+};
+
 /** The block chain is a tree shaped structure starting with the
  * genesis block at the root, with each block potentially having multiple
  * candidates to be the next block. A blockindex may have multiple pprev pointing
@@ -220,7 +282,7 @@ public:
     uint32_t nTime;
     uint32_t nBits;
     uint32_t nNonce;
-	CBigNum bnPrimeChainMultiplier; //DATACOIN ADDED
+	CCompactMultiplier bnPrimeChainMultiplier; //DATACOIN ADDED
 
     //! (memory only) Sequential id assigned to distinguish order in which blocks are received.
     int32_t nSequenceId;
@@ -255,7 +317,7 @@ public:
         nTime          = 0;
         nBits          = 0;
         nNonce         = 0;
-		bnPrimeChainMultiplier = 0;
+		bnPrimeChainMultiplier.SetNull();
     }
 
     CBlockIndex()
@@ -324,7 +386,7 @@ public:
         block.nTime          = nTime;
         block.nBits          = nBits;
         block.nNonce         = nNonce;
-        block.bnPrimeChainMultiplier = bnPrimeChainMultiplier;
+        block.bnPrimeChainMultiplier = bnPrimeChainMultiplier.GetBigNum();
         //DATACOIN CHANGED !!! XPM CBlockIndex не содержит bnPrimeChainMultiplier.
         //block.bnPrimeChainMultiplier = bnPrimeChainMultiplier; 
         //Вследствие по сети в HEADERS отправляется тоже пустое поле и приемник 
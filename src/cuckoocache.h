@@ -475,6 +475,30 @@ public:
             }
         return false;
     }
+
+    /* get is contains for Elements carrying a payload next to the part that
+     * operator== compares: on a hit the stored element is copied into e.
+     *
+     * @param e the element to look up, overwritten with the stored element
+     * if found
+     * @param erase
+     *
+     * @post if erase is true and the element is found, then the garbage collect
+     * flag is set
+     * @returns true if the element is found, false otherwise
+     */
+    inline bool get(Element& e, const bool erase) const
+    {
+        std::array<uint32_t, 8> locs = compute_hashes(e);
+        for (uint32_t loc : locs)
+            if (table[loc] == e) {
+                e = table[loc];
+                if (erase)
+                    allow_erase(loc);
+                return true;
+            }
+        return false;
+    }
 };
 } // namespace CuckooCache
 
@@ -0,0 +1,212 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "datahashindex.h"
+
+#include "chain.h"
+#include "chainparams.h"
+#include "crypto/sha256.h"
+#include "primitives/block.h"
+#include "util.h"
+#include "utilstrencodings.h"
+#include "validation.h"
+
+#include <boost/thread.hpp>
+
+static const char DB_DATAHASH = 'h';
+static const char DB_BEST_BLOCK = 'B';
+
+std::unique_ptr<CDataHashIndex> g_datahashindex;
+
+CDataHashIndex::CDataHashIndex(size_t nCacheSize, bool fMemory, bool fWipe) :
+    db(GetDataDir() / "blocks" / "datahash", nCacheSize, fMemory, fWipe),
+    pindexBest(nullptr),
+    fSynced(false)
+{
+}
+
+bool CDataHashIndex::FindData(const uint256& hash, std::vector<std::pair<uint256, int> >& vTx, size_t nMaxCount)
+{
+    // Entries of one payload are adjacent, so this is a single seek
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(std::make_pair(DB_DATAHASH, hash));
+
+    std::pair<char, std::pair<uint256, uint256> > key;
+    while (pcursor->Valid() && vTx.size() < nMaxCount) {
+        if (!pcursor->GetKey(key) || key.first != DB_DATAHASH || key.second.first != hash)
+            break;
+        int nHeight;
+        if (!pcursor->GetValue(nHeight))
+            return error("%s: failed to read entry of %s", __func__, HexStr(hash.begin(), hash.end()));
+        vTx.emplace_back(key.second.second, nHeight);
+        pcursor->Next();
+    }
+    return true;
+}
+
+int CDataHashIndex::GetHeight() const
+{
+    const CBlockIndex* pindex = pindexBest;
+    return pindex ? pindex->nHeight : -1;
+}
+
+bool CDataHashIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    CDBBatch batch(db);
+    for (const auto& tx : block.vtx) {
+        if (tx->data.empty())
+            continue;
+        uint256 hashData;
+        CSHA256().Write(tx->data.data(), tx->data.size()).Finalize(hashData.begin());
+        batch.Write(std::make_pair(DB_DATAHASH, std::make_pair(hashData, tx->GetHash())), pindex->nHeight);
+    }
+    batch.Write(DB_BEST_BLOCK, pindex->GetBlockHash());
+    if (!db.WriteBatch(batch))
+        return error("%s: failed to write block %s", __func__, pindex->GetBlockHash().ToString());
+    pindexBest = pindex;
+    return true;
+}
+
+bool CDataHashIndex::EraseBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    CDBBatch batch(db);
+    for (const auto& tx : block.vtx) {
+        if (tx->data.empty())
+            continue;
+        uint256 hashData;
+        CSHA256().Write(tx->data.data(), tx->data.size()).Finalize(hashData.begin());
+        batch.Erase(std::make_pair(DB_DATAHASH, std::make_pair(hashData, tx->GetHash())));
+    }
+    if (pindex->pprev)
+        batch.Write(DB_BEST_BLOCK, pindex->pprev->GetBlockHash());
+    else
+        batch.Erase(DB_BEST_BLOCK);
+    if (!db.WriteBatch(batch))
+        return error("%s: failed to erase block %s", __func__, pindex->GetBlockHash().ToString());
+    pindexBest = pindex->pprev;
+    return true;
+}
+
+void CDataHashIndex::ThreadSync()
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+
+    const CBlockIndex* pindex = nullptr;
+    uint256 hashBest;
+    if (db.Read(DB_BEST_BLOCK, hashBest)) {
+        LOCK(cs_main);
+        BlockMap::const_iterator it = mapBlockIndex.find(hashBest);
+        if (it != mapBlockIndex.end())
+            pindex = it->second;
+        else
+            LogPrintf("%s: last indexed block %s is unknown, indexing from genesis\n", __func__, hashBest.ToString());
+    }
+    pindexBest = pindex;
+    LogPrintf("%s: data hash index at height %d\n", __func__, GetHeight());
+
+    while (true) {
+        boost::this_thread::interruption_point();
+
+        const CBlockIndex* pindexNext = nullptr;
+        const CBlockIndex* pindexFork = nullptr;
+        {
+            LOCK(cs_main);
+            if (pindex && !chainActive.Contains(pindex)) {
+                pindexFork = chainActive.FindFork(pindex);
+            } else {
+                pindexNext = pindex ? chainActive.Next(pindex) : chainActive.Genesis();
+                if (!pindexNext) {
+                    // Blocks connected from now on reach BlockConnected under cs_main
+                    fSynced = true;
+                    LogPrintf("%s: data hash index synced at height %d\n", __func__, GetHeight());
+                    return;
+                }
+            }
+        }
+
+        // Unwind the blocks indexed on a branch that is no longer active
+        while (pindexFork && pindex != pindexFork) {
+            boost::this_thread::interruption_point();
+            CBlock block;
+            if (!ReadBlockFromDisk(block, pindex, consensusParams) || !EraseBlock(block, pindex)) {
+                LogPrintf("%s: failed to unwind block %s, data hash index stopped\n", __func__, pindex->GetBlockHash().ToString());
+                return;
+            }
+            pindex = pindex->pprev;
+        }
+        if (pindexFork)
+            continue;
+
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindexNext, consensusParams) || !WriteBlock(block, pindexNext)) {
+            LogPrintf("%s: failed to index block %s, data hash index stopped\n", __func__, pindexNext->GetBlockHash().ToString());
+            return;
+        }
+        pindex = pindexNext;
+    }
+}
+
+bool CDataHashIndex::Resync(const CBlockIndex* pindexTarget)
+{
+    AssertLockHeld(cs_main);
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+
+    // Unwind the blocks indexed on another branch, as ThreadSync does
+    const CBlockIndex* pindex = pindexBest;
+    const CBlockIndex* pindexFork = (pindex && pindexTarget) ? LastCommonAncestor(pindex, pindexTarget) : nullptr;
+    while (pindex != pindexFork) {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, consensusParams) || !EraseBlock(block, pindex))
+            return error("%s: failed to unwind block %s", __func__, pindex->GetBlockHash().ToString());
+        pindex = pindex->pprev;
+    }
+
+    std::vector<const CBlockIndex*> vToIndex;
+    for (pindex = pindexTarget; pindex != pindexFork; pindex = pindex->pprev)
+        vToIndex.push_back(pindex);
+    for (auto it = vToIndex.rbegin(); it != vToIndex.rend(); ++it) {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, *it, consensusParams) || !WriteBlock(block, *it))
+            return error("%s: failed to index block %s", __func__, (*it)->GetBlockHash().ToString());
+    }
+    return true;
+}
+
+void CDataHashIndex::BlockConnected(const std::shared_ptr<const CBlock> &block, const CBlockIndex *pindex, const std::vector<CTransactionRef> &txnConflicted)
+{
+    if (!fSynced)
+        return;
+
+    // A block the index missed, or failed to write, leaves it behind the
+    // chain: it catches up from the last block it indexed
+    if (pindex->pprev != pindexBest) {
+        LogPrintf("%s: block %s does not extend the last indexed block, resyncing\n", __func__, pindex->GetBlockHash().ToString());
+        if (!Resync(pindex->pprev)) {
+            fSynced = false;
+            LogPrintf("%s: data hash index stopped\n", __func__);
+            return;
+        }
+    }
+    if (!WriteBlock(*block, pindex)) {
+        fSynced = false;
+        LogPrintf("%s: data hash index stopped\n", __func__);
+    }
+}
+
+void CDataHashIndex::BlockDisconnected(const std::shared_ptr<const CBlock> &block)
+{
+    if (!fSynced)
+        return;
+
+    const CBlockIndex* pindex = pindexBest;
+    if (pindex && pindex->GetBlockHash() == block->GetHash() && EraseBlock(*block, pindex))
+        return;
+
+    // The tip is already the parent of the disconnected block
+    LogPrintf("%s: block %s is not the last indexed block, resyncing\n", __func__, block->GetHash().ToString());
+    if (!Resync(chainActive.Tip())) {
+        fSynced = false;
+        LogPrintf("%s: data hash index stopped\n", __func__);
+    }
+}
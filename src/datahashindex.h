@@ -0,0 +1,78 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_DATAHASHINDEX_H
+#define BITCOIN_DATAHASHINDEX_H
+
+#include "dbwrapper.h"
+#include "uint256.h"
+#include "validationinterface.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+
+//! -datahashindex default
+static const bool DEFAULT_DATAHASHINDEX = false;
+//! Max memory allocated to the data hash index specific cache (MiB)
+static const int64_t nMaxDataHashIndexCache = 64;
+//! Default number of transactions returned for one payload hash
+static const unsigned int DEFAULT_DATAHASH_RESULTS = 100;
+//! Max number of transactions returned for one payload hash
+static const unsigned int MAX_DATAHASH_RESULTS = 10000;
+
+/**
+ * Index from the SHA256 of transaction data payloads to the transactions of
+ * the active chain carrying them (blocks/datahash/).
+ *
+ * ThreadSync builds it in the background from the block files, resuming from
+ * the last block it indexed. Once it has caught up with the tip, the index
+ * follows the active chain through the validation interface.
+ */
+class CDataHashIndex : public CValidationInterface
+{
+public:
+    explicit CDataHashIndex(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    CDataHashIndex(const CDataHashIndex&) = delete;
+    CDataHashIndex& operator=(const CDataHashIndex&) = delete;
+
+    /** Transactions whose payload hashes to hash, with the height of their block */
+    bool FindData(const uint256& hash, std::vector<std::pair<uint256, int> >& vTx, size_t nMaxCount);
+
+    /** Whether the index has caught up with the active chain */
+    bool IsSynced() const { return fSynced; }
+
+    /** Height of the last indexed block, -1 if none */
+    int GetHeight() const;
+
+    /** Index the active chain up to its tip. Run in its own thread. */
+    void ThreadSync();
+
+protected:
+    void BlockConnected(const std::shared_ptr<const CBlock> &block, const CBlockIndex *pindex, const std::vector<CTransactionRef> &txnConflicted) override;
+    void BlockDisconnected(const std::shared_ptr<const CBlock> &block) override;
+
+private:
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex);
+    bool EraseBlock(const CBlock& block, const CBlockIndex* pindex);
+
+    /** Move the index from the last indexed block to pindexTarget under cs_main */
+    bool Resync(const CBlockIndex* pindexTarget);
+
+    CDBWrapper db;
+
+    //! Last indexed block; only moved by ThreadSync until fSynced, then under cs_main
+    std::atomic<const CBlockIndex*> pindexBest;
+    std::atomic<bool> fSynced;
+};
+
+/** The data hash index, if -datahashindex */
+extern std::unique_ptr<CDataHashIndex> g_datahashindex;
+
+#endif // BITCOIN_DATAHASHINDEX_H
@@ -0,0 +1,52 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_FILEMANIFEST_H
+#define BITCOIN_FILEMANIFEST_H
+
+#include "serialize.h"
+#include "uint256.h"
+
+#include <ios>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//! Max number of data transactions of a file stored by storefile
+static const unsigned int MAX_FILE_CHUNKS = 512;
+//! Number of chunks retrievefile fetches at once
+static const unsigned int RETRIEVEFILE_THREADS = 4;
+
+/** Payload of the last transaction of a file stored by storefile: the
+ *  transactions holding the file, in order, and what the file should hash to. */
+struct CFileManifest
+{
+    static const uint32_t MAGIC = 0x46435444; // "DTCF"
+    static const int CURRENT_VERSION = 1;
+
+    int nVersion;
+    std::string strName;
+    uint64_t nSize;
+    uint256 hash; // SHA256 of the file
+    std::vector<uint256> vChunks;
+
+    CFileManifest() : nVersion(CURRENT_VERSION), nSize(0) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        uint32_t nMagic = MAGIC;
+        READWRITE(nMagic);
+        if (nMagic != MAGIC)
+            throw std::ios_base::failure("not a file manifest");
+        READWRITE(nVersion);
+        READWRITE(LIMITED_STRING(strName, 256));
+        READWRITE(nSize);
+        READWRITE(hash);
+        READWRITE(vChunks);
+    }
+};
+
+#endif // BITCOIN_FILEMANIFEST_H
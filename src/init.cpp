@@ -18,6 +18,7 @@
 #include "checkpoints.h"
 #include "compat/sanity.h"
 #include "consensus/validation.h"
+#include "datahashindex.h"
 #include "fs.h"
 #include "httpserver.h"
 #include "httprpc.h"
@@ -30,6 +31,8 @@
 #include "policy/feerate.h"
 #include "policy/fees.h"
 #include "policy/policy.h"
+#include "pow.h"
+#include "prime/sieve_kernels.h"
 #include "rpc/server.h"
 #include "rpc/register.h"
 #include "rpc/safemode.h"
@@ -240,6 +243,11 @@ void Shutdown()
     // up with our current chain to avoid any strange pruning edge cases and make
     // next startup faster by avoiding rescan.
 
+    if (g_datahashindex) {
+        UnregisterValidationInterface(g_datahashindex.get());
+        g_datahashindex.reset();
+    }
+
     {
         LOCK(cs_main);
         if (pcoinsTip != nullptr) {
@@ -253,6 +261,8 @@ void Shutdown()
         pcoinsdbview = nullptr;
         delete pblocktree;
         pblocktree = nullptr;
+        delete pdataindex;
+        pdataindex = nullptr;
     }
 #ifdef ENABLE_WALLET
     StopWallets();
@@ -348,6 +358,8 @@ std::string HelpMessage(HelpMessageMode mode)
 #endif
     }
     strUsage += HelpMessageOpt("-datadir=<dir>", _("Specify data directory"));
+    strUsage += HelpMessageOpt("-datahashindex", strprintf(_("Maintain an index of transactions by the SHA256 of their data payload, used by the getdatabyhash rpc call (default: %u)"), DEFAULT_DATAHASHINDEX));
+    strUsage += HelpMessageOpt("-dataindex", strprintf(_("Maintain an index of transaction data payloads, used by the getdata rpc call (default: %u)"), DEFAULT_DATAINDEX));
     if (showDebug) {
         strUsage += HelpMessageOpt("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize));
     }
@@ -363,7 +375,7 @@ std::string HelpMessage(HelpMessageMode mode)
     }
     strUsage += HelpMessageOpt("-persistmempool", strprintf(_("Whether to save the mempool on shutdown and load on restart (default: %u)"), DEFAULT_PERSIST_MEMPOOL));
     strUsage += HelpMessageOpt("-blockreconstructionextratxn=<n>", strprintf(_("Extra transactions to keep in memory for compact block reconstructions (default: %u)"), DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN));
-    strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
+    strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script and header proof-of-work verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS));
 #ifndef WIN32
     strUsage += HelpMessageOpt("-pid=<file>", strprintf(_("Specify pid file (default: %s)"), BITCOIN_PID_FILENAME));
@@ -464,6 +476,7 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-logtimemicros", strprintf("Add microsecond precision to debug timestamps (default: %u)", DEFAULT_LOGTIMEMICROS));
         strUsage += HelpMessageOpt("-mocktime=<n>", "Replace actual time with <n> seconds since epoch (default: 0)");
         strUsage += HelpMessageOpt("-maxsigcachesize=<n>", strprintf("Limit sum of signature cache and script execution cache sizes to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE));
+        strUsage += HelpMessageOpt("-maxpowcachesize=<n>", strprintf("Limit proof-of-work cache size to <n> MiB (default: %u)", DEFAULT_MAX_POW_CACHE_SIZE));
         strUsage += HelpMessageOpt("-maxtipage=<n>", strprintf("Maximum tip age in seconds to consider node in initial block download (default: %u)", DEFAULT_MAX_TIP_AGE));
     }
     strUsage += HelpMessageOpt("-maxtxfee=<amt>", strprintf(_("Maximum total fees (in %s) to use in a single wallet transaction or raw transaction; setting this too low may abort large transactions (default: %s)"),
@@ -904,6 +917,10 @@ bool AppInitParameterInteraction()
     if (gArgs.GetArg("-prune", 0)) {
         if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX))
             return InitError(_("Prune mode is incompatible with -txindex."));
+        if (gArgs.GetBoolArg("-dataindex", DEFAULT_DATAINDEX))
+            return InitError(_("Prune mode is incompatible with -dataindex."));
+        if (gArgs.GetBoolArg("-datahashindex", DEFAULT_DATAHASHINDEX))
+            return InitError(_("Prune mode is incompatible with -datahashindex."));
     }
 
     // -bind and -whitebind can't be set when not listening
@@ -1193,6 +1210,8 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string sieve_kernels = SieveKernelsAutoDetect();
+    LogPrintf("Using the '%s' sieve kernels\n", sieve_kernels);
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1244,11 +1263,14 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
     InitSignatureCache();
     InitScriptExecutionCache();
+    InitPowCache();
 
-    LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
+    LogPrintf("Using %u threads for script and header proof-of-work verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
-        for (int i=0; i<nScriptCheckThreads-1; i++)
+        for (int i=0; i<nScriptCheckThreads-1; i++) {
             threadGroup.create_thread(&ThreadScriptCheck);
+            threadGroup.create_thread(&ThreadPowCheck);
+        }
     }
 
     // Start the lightweight task scheduler thread
@@ -1401,6 +1423,10 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     int64_t nBlockTreeDBCache = nTotalCache / 8;
     nBlockTreeDBCache = std::min(nBlockTreeDBCache, (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxBlockDBAndTxIndexCache : nMaxBlockDBCache) << 20);
     nTotalCache -= nBlockTreeDBCache;
+    int64_t nDataIndexCache = gArgs.GetBoolArg("-dataindex", DEFAULT_DATAINDEX) ? std::min(nTotalCache / 8, nMaxDataIndexCache << 20) : 0;
+    nTotalCache -= nDataIndexCache;
+    int64_t nDataHashIndexCache = gArgs.GetBoolArg("-datahashindex", DEFAULT_DATAHASHINDEX) ? std::min(nTotalCache / 8, nMaxDataHashIndexCache << 20) : 0;
+    nTotalCache -= nDataHashIndexCache;
     int64_t nCoinDBCache = std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23)); // use 25%-50% of the remainder for disk cache
     nCoinDBCache = std::min(nCoinDBCache, nMaxCoinsDBCache << 20); // cap total coins db cache
     nTotalCache -= nCoinDBCache;
@@ -1408,6 +1434,10 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1fMiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
+    if (nDataIndexCache)
+        LogPrintf("* Using %.1fMiB for data index database\n", nDataIndexCache * (1.0 / 1024 / 1024));
+    if (nDataHashIndexCache)
+        LogPrintf("* Using %.1fMiB for data hash index database\n", nDataHashIndexCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for in-memory UTXO set (plus up to %.1fMiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
 
@@ -1426,8 +1456,12 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                 delete pcoinsdbview;
                 delete pcoinscatcher;
                 delete pblocktree;
+                delete pdataindex;
+                pdataindex = nullptr;
 
                 pblocktree = new CBlockTreeDB(nBlockTreeDBCache, false, fReset);
+                if (nDataIndexCache)
+                    pdataindex = new CDataIndexDB(nDataIndexCache, false, fReset);
 
                 if (fReset) {
                     pblocktree->WriteReindexing(true);
@@ -1459,6 +1493,12 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     break;
                 }
 
+                // Check for changed -dataindex state
+                if (fDataIndex != gArgs.GetBoolArg("-dataindex", DEFAULT_DATAINDEX)) {
+                    strLoadError = _("You need to rebuild the database using -reindex to change -dataindex");
+                    break;
+                }
+
                 // Check for changed -prune state.  What we are concerned about is a user who has pruned blocks
                 // in the past, but is now trying to run unpruned.
                 if (fHavePruned && !fPruneMode) {
@@ -1584,6 +1624,12 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
         LogPrintf(" block index %15dms\n", GetTimeMillis() - nStart);
     }
 
+    // The data hash index is built in the background, see Step 10
+    if (nDataHashIndexCache) {
+        g_datahashindex.reset(new CDataHashIndex(nDataHashIndexCache, false, gArgs.GetBoolArg("-reindex", false)));
+        RegisterValidationInterface(g_datahashindex.get());
+    }
+
     fs::path est_path = GetDataDir() / FEE_ESTIMATES_FILENAME;
     CAutoFile est_filein(fsbridge::fopen(est_path, "rb"), SER_DISK, CLIENT_VERSION);
     // Allowed to fail as this file IS missing on first startup.
@@ -1644,6 +1690,11 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
     threadGroup.create_thread(boost::bind(&ThreadImport, vImportFiles));
 
+    if (g_datahashindex) {
+        std::function<void()> syncLoop = std::bind(&CDataHashIndex::ThreadSync, g_datahashindex.get());
+        threadGroup.create_thread(boost::bind(&TraceThread<std::function<void()> >, "datahashidx", syncLoop));
+    }
+
     // Wait for genesis block to be processed
     {
         boost::unique_lock<boost::mutex> lock(cs_GenesisWait);
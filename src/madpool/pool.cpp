@@ -7,9 +7,16 @@
 
 
 
+#include "init.h"
 #include "net.h"
 #include "validation.h"
 #include "miner.h"
+#include "consensus/merkle.h"
+#include "consensus/validation.h"
+#include "crypto/common.h"
+#include "util.h"
+
+#include <boost/bind.hpp>
 
 #include "pool.h"
 
@@ -20,10 +27,625 @@
 
 
 
-PrimeWorker::PrimeWorker(CWallet* pwallet, unsigned threadid, unsigned target)
+bool ReadShareHashes(const proto::Share& share, uint256& hashHeader, uint256& hashMerkleRoot, CBigNum& bnMultiplier) {
+	
+	if(share.has_hashbin()){
+		if(share.hashbin().size() != hashHeader.size())
+			return false;
+		memcpy(hashHeader.begin(), share.hashbin().data(), hashHeader.size());
+	}else
+		hashHeader.SetHex(share.hash());
+	
+	if(share.has_merklebin()){
+		if(share.merklebin().size() != hashMerkleRoot.size())
+			return false;
+		memcpy(hashMerkleRoot.begin(), share.merklebin().data(), hashMerkleRoot.size());
+	}else
+		hashMerkleRoot.SetHex(share.merkle());
+	
+	// Same byte order as the multiplier of a serialized block
+	if(share.has_multibin()){
+		const std::string& multi = share.multibin();
+		if(multi.size() > MAX_SHARE_MULTIPLIER_SIZE)
+			return false;
+		bnMultiplier.setvch(std::vector<unsigned char>(multi.begin(), multi.end()));
+	}else
+		bnMultiplier.SetHex(share.multi());
+	
+	return true;
+	
+}
+
+
+void SetWorkMerkleRoot(proto::Work& work, const uint256& hashMerkleRoot, unsigned version) {
+	
+	// merkle is a required field, older clients only read the hex
+	if(version >= POOL_BINARY_VERSION){
+		work.set_merkle(std::string());
+		work.set_merklebin(hashMerkleRoot.begin(), hashMerkleRoot.size());
+	}else
+		work.set_merkle(hashMerkleRoot.GetHex());
+	
+}
+
+
+proto::Reply::ErrType SetBusyReply(proto::Reply& rep, unsigned version) {
+	
+	if(version >= POOL_BUSY_VERSION)
+		return proto::Reply::BUSY;
+	
+	rep.set_errstr("Too many shares waiting to be checked.");
+	return proto::Reply::STALE;
+	
+}
+
+
+PoolWorkTables::PoolWorkTables(size_t nMaxMemory)
+	: works(nMaxMemory / 3), reqnonces(nMaxMemory / 3), shares(nMaxMemory / 3) {
+	
+}
+
+
+bool PoolWorkTables::MakeRoom() {
+	
+	if(!works.Full() && !reqnonces.Full() && !shares.Full())
+		return false;
+	
+	works.Rotate();
+	reqnonces.Rotate();
+	shares.Rotate();
+	return true;
+	
+}
+
+
+void PoolWorkTables::Clear() {
+	
+	works.Clear();
+	reqnonces.Clear();
+	shares.Clear();
+	
+}
+
+
+size_t PoolWorkTables::DynamicMemoryUsage() const {
+	
+	return works.DynamicMemoryUsage() + reqnonces.DynamicMemoryUsage() + shares.DynamicMemoryUsage();
+	
+}
+
+
+size_t GetPoolTableMemory() {
+	
+	return (size_t)std::max(gArgs.GetArg("-pooltablemem", DEFAULT_POOL_TABLE_MEM), (int64_t)1) << 20;
+	
+}
+
+
+PoolTemplates::PoolTemplates() {
+	
+	mStop = false;
+	mChanged = false;
+	mInvalid = false;
+	mempool.NotifyEntryAdded.connect(boost::bind(&PoolTemplates::TransactionAdded, this, _1));
+	mempool.NotifyEntryRemoved.connect(boost::bind(&PoolTemplates::TransactionRemoved, this, _1, _2));
+	mThread = std::thread(&PoolTemplates::ThreadRefresh, this);
+	
+}
+
+PoolTemplates::~PoolTemplates() {
+	
+	Stop();
+	
+}
+
+void PoolTemplates::Stop() {
+	
+	mempool.NotifyEntryAdded.disconnect(boost::bind(&PoolTemplates::TransactionAdded, this, _1));
+	mempool.NotifyEntryRemoved.disconnect(boost::bind(&PoolTemplates::TransactionRemoved, this, _1, _2));
+	
+	{
+		std::unique_lock<std::mutex> lock(cs_refresh);
+		mStop = true;
+	}
+	cond.notify_all();
+	if(mThread.joinable())
+		mThread.join();
+	
+}
+
+
+std::shared_ptr<const PoolTemplate> PoolTemplates::Get(const uint256& hashPrev) {
+	
+	{
+		LOCK(cs);
+		if(mTemplate && mTemplate->block.hashPrevBlock == hashPrev)
+			return mTemplate;
+	}
+	
+	// The first worker to see a new tip assembles the template, the others
+	// wait here and share it instead of each calling CreateNewBlock
+	LOCK(cs_create);
+	{
+		LOCK(cs);
+		if(mTemplate && mTemplate->block.hashPrevBlock == hashPrev)
+			return mTemplate;
+	}
+	
+	std::shared_ptr<const PoolTemplate> tmpl = Create();
+	if(tmpl)
+		SetTemplate(tmpl, false);
+	return tmpl;
+	
+}
+
+std::shared_ptr<const PoolTemplate> PoolTemplates::Refresh(const std::shared_ptr<const PoolTemplate>& current) {
+	
+	// The full template of a block announced early comes with NotifyNewBlock
+	if(current->fEmpty)
+		return current;
+	
+	// The tip may have moved on, NEWBLOCK switches the workers to it
+	LOCK(cs);
+	if(mTemplate && mTemplate != current && mTemplate->block.hashPrevBlock == current->block.hashPrevBlock &&
+			mTemplate->nTimeCreated >= current->nTimeCreated)
+		return mTemplate;
+	
+	return current;
+	
+}
+
+void PoolTemplates::TransactionAdded(CTransactionRef ptx) {
+	
+	std::unique_lock<std::mutex> lock(cs_refresh);
+	mChanged = true;
+	
+}
+
+void PoolTemplates::TransactionRemoved(CTransactionRef ptx, MemPoolRemovalReason reason) {
+	
+	// The transactions of a new block leave with their template
+	if(reason == MemPoolRemovalReason::BLOCK)
+		return;
+	
+	// Conflicted, replaced or expired, the blocks of a template with it
+	// would be invalid. The template being assembled may have it too.
+	bool fInvalid;
+	{
+		LOCK(cs);
+		fInvalid = mTemplateTxs.count(ptx->GetHash()) > 0;
+	}
+	
+	{
+		std::unique_lock<std::mutex> lock(cs_refresh);
+		mChanged = true;
+		mInvalid = mInvalid || fInvalid;
+	}
+	if(fInvalid)
+		cond.notify_all();
+	
+}
+
+void PoolTemplates::ThreadRefresh() {
+	
+	RenameThread("datacoin-pooltmpl");
+	
+	while(true){
+		
+		bool fInvalid;
+		{
+			std::unique_lock<std::mutex> lock(cs_refresh);
+			cond.wait_for(lock, std::chrono::seconds(POOL_TEMPLATE_REFRESH), [this]{ return mStop || mInvalid; });
+			if(mStop)
+				break;
+			if(!mChanged && !mInvalid)
+				continue;
+			fInvalid = mInvalid;
+		}
+		
+		// Nothing to refresh until a worker has asked for the template of a tip
+		{
+			LOCK(cs);
+			if(!mTemplate)
+				continue;
+			if(!fInvalid && GetTime() - mTemplate->nTimeCreated < POOL_TEMPLATE_REFRESH)
+				continue;
+		}
+		
+		// The events from now on are for the next refresh
+		{
+			std::unique_lock<std::mutex> lock(cs_refresh);
+			mChanged = mInvalid = false;
+		}
+		
+		std::shared_ptr<const PoolTemplate> tmpl = Create();
+		if(tmpl)
+			SetTemplate(tmpl, true);
+		
+	}
+	
+}
+
+std::shared_ptr<const PoolTemplate> PoolTemplates::Create() {
+	
+	// The payout script is replaced by the coinbase script of each worker.
+	// CreateNewBlock throws when the block fails TestBlockValidity.
+	std::unique_ptr<CBlockTemplate> pblocktemplate;
+	try {
+		pblocktemplate = BlockAssembler(Params()).CreateNewBlock(CScript() << OP_TRUE, false);
+	} catch(const std::exception& e) {
+		LogPrintf("ERROR: PoolTemplates::Create(): %s\n", e.what());
+		return std::shared_ptr<const PoolTemplate>();
+	}
+	if(!pblocktemplate)
+		return std::shared_ptr<const PoolTemplate>();
+	
+	std::shared_ptr<PoolTemplate> tmpl = std::make_shared<PoolTemplate>();
+	tmpl->block = pblocktemplate->block;
+	tmpl->vMerkleBranch = BlockMerkleBranch(tmpl->block, 0);
+	tmpl->fEmpty = false;
+	tmpl->nTimeCreated = GetTime();
+	
+	// The tip may have moved on since the worker was signalled
+	{
+		LOCK(cs_main);
+		BlockMap::const_iterator mi = mapBlockIndex.find(tmpl->block.hashPrevBlock);
+		if(mi == mapBlockIndex.end())
+			return std::shared_ptr<const PoolTemplate>();
+		tmpl->pindexPrev = mi->second;
+	}
+	
+	return tmpl;
+	
+}
+
+void PoolTemplates::SetTemplate(const std::shared_ptr<const PoolTemplate>& tmpl, bool fRefresh) {
+	
+	std::set<uint256> txs;
+	for(unsigned i = 1; i < tmpl->block.vtx.size(); ++i)
+		txs.insert(tmpl->block.vtx[i]->GetHash());
+	
+	// A worker may have set the template of a new tip during a refresh
+	LOCK(cs);
+	if(fRefresh && (!mTemplate || mTemplate->block.hashPrevBlock != tmpl->block.hashPrevBlock))
+		return;
+	mTemplate = tmpl;
+	mTemplateTxs.swap(txs);
+	
+}
+
+std::shared_ptr<const PoolTemplate> PoolTemplates::GetEmpty(const uint256& hashPrev) {
+	
+	LOCK(cs_empty);
+	if(mEmpty && mEmpty->block.hashPrevBlock == hashPrev)
+		return mEmpty;
+	
+	return std::shared_ptr<const PoolTemplate>();
+	
+}
+
+void PoolTemplates::SetEmpty(const std::shared_ptr<const PoolTemplate>& tmpl) {
+	
+	LOCK(cs_empty);
+	mEmpty = tmpl;
+	
+}
+
+bool PoolTemplates::ClearEmpty(const uint256& hashPrev) {
+	
+	LOCK(cs_empty);
+	if(!mEmpty || mEmpty->block.hashPrevBlock != hashPrev)
+		return false;
+	
+	mEmpty.reset();
+	return true;
+	
+}
+
+
+
+
+ShareValidator::ShareValidator(CWallet* pwallet, unsigned threads, unsigned maxqueue) {
+	
+	mWallet = pwallet;
+	mMaxQueue = std::max(maxqueue, 1u);
+	mStop = false;
+	
+	for(unsigned i = 0; i < threads; ++i)
+		mThreads.push_back(std::thread(&ShareValidator::ThreadValidate, this));
+	
+	LogPrintf("ShareValidator started with %u threads.\n", threads);
+	
+}
+
+ShareValidator::~ShareValidator() {
+	
+	Stop();
+	
+	// Shares still waiting are dropped without a reply
+	for(unsigned i = 0; i < mQueue.size(); ++i){
+		zmsg_destroy(&mQueue[i]->msg);
+		delete mQueue[i];
+	}
+	mQueue.clear();
+	
+	LogPrintf("ShareValidator stopped.\n");
+	
+}
+
+
+void ShareValidator::Stop() {
+	
+	{
+		std::unique_lock<std::mutex> lock(cs);
+		mStop = true;
+	}
+	cond.notify_all();
+	
+	for(unsigned i = 0; i < mThreads.size(); ++i)
+		if(mThreads[i].joinable())
+			mThreads[i].join();
+	
+}
+
+
+bool ShareValidator::Push(PoolShare* share) {
+	
+	{
+		std::unique_lock<std::mutex> lock(cs);
+		if(mStop || mQueue.size() >= mMaxQueue)
+			return false;
+		mQueue.push_back(share);
+	}
+	cond.notify_one();
+	return true;
+	
+}
+
+
+bool ShareValidator::Full() {
+	
+	std::unique_lock<std::mutex> lock(cs);
+	return mStop || mQueue.size() >= mMaxQueue;
+	
+}
+
+
+void ShareValidator::Validate(PoolShare* share, CPrimalityTestParams& testParams) {
+	
+	// Only the chain type of the share is tested, up to the length the share
+	// needs. CheckWork only runs for the shares reported as blocks.
+	const CBlock* pblock = &share->block;
+	unsigned int nChainLength = 0;
+	if(!CheckPrimeShare(pblock->GetHeaderHash(), pblock->bnPrimeChainMultiplier, share->chaintype, share->minlength, nChainLength, testParams)){
+		share->rep.set_error(proto::Reply::INVALID);
+		share->isblock = false;
+		return;
+	}
+	share->record.length = TargetGetLength(nChainLength);
+	
+	share->isblock = share->checkblock && CheckWork(&share->block, *mWallet, share->script, true);
+	
+}
+
+
+void ShareValidator::ThreadValidate() {
+	
+	RenameThread("datacoin-poolval");
+	
+	// A zmq socket is only used by the thread that created it, so each
+	// thread has its own socket to every worker
+	std::map<unsigned, zsock_t*> sockets;
+	CPrimalityTestParams testParams;
+	
+	while(true){
+		
+		PoolShare* share;
+		{
+			std::unique_lock<std::mutex> lock(cs);
+			while(!mStop && mQueue.empty())
+				cond.wait(lock);
+			if(mStop)
+				break;
+			share = mQueue.front();
+			mQueue.pop_front();
+		}
+		
+		Validate(share, testParams);
+		
+		zsock_t*& socket = sockets[share->threadid];
+		if(!socket){
+			socket = zsock_new(ZMQ_PUSH);
+			zsock_set_linger(socket, 1000);
+			zsock_connect(socket, "%s", PrimeWorker::GetShareEndpoint(share->threadid).c_str());
+		}
+		
+		zframe_t* frame = zframe_new(&share, sizeof(share));
+		zframe_send(&frame, socket, 0);
+		
+	}
+	
+	for(std::map<unsigned, zsock_t*>::iterator iter = sockets.begin(); iter != sockets.end(); ++iter)
+		zsock_destroy(&iter->second);
+	
+}
+
+
+
+
+PoolClientShares::PoolClientShares(unsigned maxshares) {
+	
+	mMaxShares = std::max(maxshares, 1u);
+	
+}
+
+
+bool PoolClientShares::Full(const std::string& client) const {
+	
+	return Count(client) >= mMaxShares;
+	
+}
+
+
+void PoolClientShares::Add(const std::string& client) {
+	
+	mShares[client]++;
+	
+}
+
+
+void PoolClientShares::Remove(const std::string& client) {
+	
+	std::map<std::string, unsigned>::iterator iter = mShares.find(client);
+	if(iter != mShares.end() && !--iter->second)
+		mShares.erase(iter);
+	
+}
+
+
+unsigned PoolClientShares::Count(const std::string& client) const {
+	
+	std::map<std::string, unsigned>::const_iterator iter = mShares.find(client);
+	return iter != mShares.end() ? iter->second : 0;
+	
+}
+
+
+
+
+static const char DB_POOL_SHARE = 's';
+static const char DB_POOL_SHARE_SEQ = 'n';
+
+namespace {
+
+// Height and sequence in big endian, so that the keys sort by height
+struct PoolShareKey {
+	
+	uint32_t height;
+	uint64_t seq;
+	
+	PoolShareKey() : height(0), seq(0) {}
+	PoolShareKey(uint32_t heightIn, uint64_t seqIn) : height(heightIn), seq(seqIn) {}
+	
+	template<typename Stream>
+	void Serialize(Stream& s) const {
+		unsigned char buf[12];
+		WriteBE32(buf, height);
+		WriteBE64(buf + 4, seq);
+		s << DB_POOL_SHARE;
+		s.write((const char*)buf, sizeof(buf));
+	}
+	
+	template<typename Stream>
+	void Unserialize(Stream& s) {
+		char prefix;
+		unsigned char buf[12];
+		s >> prefix;
+		if(prefix != DB_POOL_SHARE)
+			throw std::ios_base::failure("not a share key");
+		s.read((char*)buf, sizeof(buf));
+		height = ReadBE32(buf);
+		seq = ReadBE64(buf + 4);
+	}
+	
+};
+
+}
+
+
+PoolShareLog::PoolShareLog(size_t nCacheSize) : mDB(GetDataDir() / "pool" / "shares", nCacheSize) {
+	
+	mNextSeq = 0;
+	mDB.Read(DB_POOL_SHARE_SEQ, mNextSeq);
+	mStop = false;
+	
+	mThread = std::thread(&PoolShareLog::ThreadFlush, this);
+	
+}
+
+PoolShareLog::~PoolShareLog() {
+	
+	// The thread writes the queued shares before it exits
+	{
+		std::unique_lock<std::mutex> lock(cs);
+		mStop = true;
+	}
+	cond.notify_all();
+	mThread.join();
+	
+}
+
+void PoolShareLog::Append(const PoolShareRecord& record) {
+	
+	std::unique_lock<std::mutex> lock(cs);
+	mPending.push_back(record);
+	if(mPending.size() >= POOL_SHARE_LOG_BATCH)
+		cond.notify_one();
+	
+}
+
+void PoolShareLog::Read(uint32_t nStartHeight, uint32_t nEndHeight, size_t nMaxCount, std::vector<PoolShareRecord>& records) {
+	
+	std::unique_ptr<CDBIterator> it(mDB.NewIterator());
+	PoolShareKey key;
+	PoolShareRecord record;
+	for(it->Seek(PoolShareKey(nStartHeight, 0)); it->Valid() && records.size() < nMaxCount; it->Next()){
+		
+		if(!it->GetKey(key) || key.height > nEndHeight)
+			break;
+		if(!it->GetValue(record))
+			throw std::runtime_error("Share log is corrupted");
+		records.push_back(record);
+		
+	}
+	
+}
+
+void PoolShareLog::ThreadFlush() {
+	
+	RenameThread("datacoin-poollog");
+	
+	std::vector<PoolShareRecord> records;
+	while(true){
+		
+		{
+			std::unique_lock<std::mutex> lock(cs);
+			cond.wait_for(lock, std::chrono::milliseconds(POOL_SHARE_LOG_FLUSH_MS),
+					[this]{ return mStop || mPending.size() >= POOL_SHARE_LOG_BATCH; });
+			records.swap(mPending);
+			if(mStop && records.empty())
+				break;
+		}
+		
+		if(records.empty())
+			continue;
+		
+		CDBBatch batch(mDB);
+		for(unsigned i = 0; i < records.size(); ++i)
+			batch.Write(PoolShareKey(records[i].height, mNextSeq++), records[i]);
+		batch.Write(DB_POOL_SHARE_SEQ, mNextSeq);
+		
+		try {
+			mDB.WriteBatch(batch);
+		} catch(const dbwrapper_error& e) {
+			LogPrintf("ERROR: PoolShareLog: %u shares not written: %s\n", records.size(), e.what());
+		}
+		records.clear();
+		
+	}
+	
+}
+
+
+
+
+PrimeWorker::PrimeWorker(CWallet* pwallet, PoolTemplates* templates, ShareValidator* validator, PoolShareLog* sharelog, unsigned threadid, unsigned target)
 {
 	
 	mWallet = pwallet;
+	mTemplates = templates;
+	mValidator = validator;
+	mShareLog = sharelog;
 	mThreadID = threadid;
 	
 	mServer = 0;
@@ -31,11 +653,20 @@ PrimeWorker::PrimeWorker(CWallet* pwallet, unsigned threadid, unsigned target)
 	
 	mCurrHeight = 0;
 	mExtraNonce = 0;
-	//mBlockTemplate = 0;
+	mNonceGenFirst[0] = mNonceGenFirst[1] = 0;
+	mBlockTemplate = 0;
 	mIndexPrev = 0;
 	mWorkerCount = 0;
 	mInvCount = 0;
 	
+	mClientShares = PoolClientShares(std::max((int)gArgs.GetArg("-poolclientshares", DEFAULT_POOL_CLIENT_SHARES), 1));
+	
+	mTables = PoolWorkTables(GetPoolTableMemory());
+	mSharesQueued = 0;
+	mSharesChecked = 0;
+	mSharesBusy = 0;
+	mShareTime = 0;
+	
 	mServerPort = gArgs.GetArg("-serverport", 60000) + 2*mThreadID;
 	mSignalPort = mServerPort+1;
 	
@@ -85,6 +716,28 @@ PrimeWorker::PrimeWorker(CWallet* pwallet, unsigned threadid, unsigned target)
 }
 
 
+std::string PrimeWorker::GetIdentity(unsigned threadid) {
+	
+	return strprintf("worker%u", threadid);
+	
+}
+
+
+std::string PrimeWorker::GetShareEndpoint(unsigned threadid) {
+	
+	return strprintf("inproc://shares%u", threadid);
+	
+}
+
+
+void PrimeWorker::GetStats(proto::ServerStats& stats) {
+	
+	LOCK(cs_stats);
+	stats.CopyFrom(mFlushedStats);
+	
+}
+
+
 void PrimeWorker::InvokeWork(zsock_t *pipe, void *args){
 	
 	((PrimeWorker*)args)->Work(pipe);
@@ -111,12 +764,25 @@ int PrimeWorker::InvokeRequest(zloop_t *wloop, zmq_pollitem_t *item, void* arg){
 	
 }
 
+int PrimeWorker::InvokeShare(zloop_t *wloop, zmq_pollitem_t *item, void* arg){
+	
+	void** arr= (void**)arg;
+	return ((PrimeWorker*)arr[0])->HandleShare((zsock_t*) arr[1]);
+	
+}
+
 int PrimeWorker::InvokeTimerFunc(zloop_t *wloop, int timer_id, void *arg) {
 	
 	return ((PrimeWorker*)arg)->FlushStats();
 	
 }
 
+int PrimeWorker::InvokeRefreshTimer(zloop_t *wloop, int timer_id, void *arg) {
+	
+	return ((PrimeWorker*)arg)->RefreshTemplate();
+	
+}
+
 int PrimeWorker::InvokeExitCheck(zloop_t *wloop, zmq_pollitem_t *item, void *arg) {
 	
 	bool terminate=false;
@@ -136,6 +802,7 @@ void PrimeWorker::Work(zsock_t *pipe) {
 	
 	zsock_t* frontend = zsock_new(ZMQ_DEALER);
 	zsock_t* input = zsock_new(ZMQ_SUB);
+	zsock_t* shares = zsock_new(ZMQ_PULL);
 	mServer = zsock_new(ZMQ_ROUTER);
 	mSignals = zsock_new(ZMQ_PUB);
 	
@@ -148,12 +815,18 @@ void PrimeWorker::Work(zsock_t *pipe) {
 	if(!err)
 		LogPrintf("zsock_bind(mSignals, tcp://*:*) failed.\n");
 		
+	// The frontend routes the requests of a client to the worker with this identity
+	zsock_set_identity(frontend, GetIdentity(mThreadID).c_str());
 	err = zsock_connect(frontend, "inproc://frontend");
 	assert(!err);
 		
 	err = zsock_connect(input, "inproc://bitcoin");
     assert(!err);
 	
+	// Shares checked by the ShareValidator come back here
+	err = zsock_bind(shares, "%s", GetShareEndpoint(mThreadID).c_str());
+	assert(!err);
+	
 	const char one[2] = {1, 0};
 	zsock_set_subscribe(input, one);
 	
@@ -174,9 +847,17 @@ void PrimeWorker::Work(zsock_t *pipe) {
 	err = zloop_poller(wloop, &item_frontend, &PrimeWorker::InvokeRequest, args_frontend);
 	assert(!err);
 	
+	zmq_pollitem_t item_shares = {zsock_resolve(shares), 0, ZMQ_POLLIN, 0};
+	void* args_shares[2] = {this, shares};
+	err = zloop_poller(wloop, &item_shares, &PrimeWorker::InvokeShare, args_shares);
+	assert(!err);
+	
 	err = zloop_timer(wloop, 60000, 0, &PrimeWorker::InvokeTimerFunc, this);
 	assert(err >= 0);
 	
+	err = zloop_timer(wloop, POOL_TEMPLATE_REFRESH * 1000, 0, &PrimeWorker::InvokeRefreshTimer, this);
+	assert(err >= 0);
+	
 	zmq_pollitem_t item_terminate = {zsock_resolve(pipe), 0, ZMQ_POLLIN, 0};
 	err = zloop_poller(wloop, &item_terminate, &PrimeWorker::InvokeExitCheck, pipe);
 	assert(!err);
@@ -190,10 +871,15 @@ void PrimeWorker::Work(zsock_t *pipe) {
 		
 	zloop_destroy(&wloop);
 	
+	// Reply to the shares the validators finished before they stopped
+	while(zmq_poll(&item_shares, 1, 0) > 0)
+		HandleShare(shares);
+	
 	zsock_destroy(&mServer);
 	zsock_destroy(&mSignals);
 	zsock_destroy(&frontend);
 	zsock_destroy(&input);
+	zsock_destroy(&shares);
 	
 	LogPrintf("PrimeWorker stopped.\n");
 	zsock_signal(pipe, 0);
@@ -232,7 +918,10 @@ zmsg_t* PrimeWorker::ReceiveRequest(proto::Request& req, zsock_t* socket) {
 			memcpy(reqnonce.begin(), nonce.c_str(), sizeof(uint256));
 		}
 		
-		if(!CheckReqNonce(reqnonce) || !mReqNonces.insert(reqnonce).second)
+		if(!CheckReqNonce(reqnonce))
+			break;
+		MakeTableRoom();
+		if(!mTables.reqnonces.Insert(reqnonce))
 			break;
 		
 		if(req.has_stats()){
@@ -305,49 +994,66 @@ int PrimeWorker::HandleInput(zsock_t* item) {
 	
 	if(sig.type() == proto::Signal::NEWBLOCK){
 		
-		mCurrBlock = sig.block();
-		mCurrHeight = mCurrBlock.height();
-		//LogPrintf("HandleInput(): proto::Signal::NEWBLOCK %d\n", mCurrHeight);
-		
-		zmsg_send(&msg, mSignals);
+		uint256 hashBlock;
+		if(sig.block().hashbin().size() == hashBlock.size())
+			memcpy(hashBlock.begin(), sig.block().hashbin().data(), hashBlock.size());
+		else
+			hashBlock.SetHex(sig.block().hash());
 		
-		while(true){
-			
-			while(g_connman->GetNodeCount(CConnman::CONNECTIONS_ALL)==0)
-				MilliSleep(1000);
+		// A block announced before it was connected is signalled again once
+		// it is the tip. The new works get the full template, the works
+		// issued on the empty one stay valid.
+		if(mTemplate && mTemplate->block.hashPrevBlock == hashBlock){
 			
-			mIndexPrev = chainActive.Tip();
+			if(mTemplate->fEmpty){
+				std::shared_ptr<const PoolTemplate> tmpl = mTemplates->Get(hashBlock);
+				if(tmpl && !tmpl->fEmpty && tmpl->pindexPrev == mIndexPrev){
+					mTemplate = tmpl;
+					mWorkTemplates[mExtraNonce + 1] = tmpl;
+				}
+			}
 			
-			if(!mIndexPrev)
-				MilliSleep(1000);
-			else
-				break;
+			zmsg_destroy(&msg);
+			return 0;
 			
 		}
 		
-		mWorkerCount = mNonceMap.size();
+		mCurrBlock = sig.block();
+		mCurrHeight = mCurrBlock.height();
+		//LogPrintf("HandleInput(): proto::Signal::NEWBLOCK %d\n", mCurrHeight);
+		
+		zmsg_send(&msg, mSignals);
 		
-		mNonceMap.clear();
-		mReqNonces.clear();
-		mShares.clear();
+		while(g_connman->GetNodeCount(CConnman::CONNECTIONS_ALL)==0)
+			MilliSleep(1000);
 		
-		//if(mBlockTemplate)
-		//	delete mBlockTemplate;
+		mWorkerCount = mExtraNonce;
 		
-		if (coinbase_script)
-			mBlockTemplate=BlockAssembler(Params()).CreateNewBlock(coinbase_script->reserveScript, false);
-		else LogPrintf("ERROR: CreateNewBlock(). No coinbase script available. Non initialised miner thread.\n"); 
+		mTables.Clear();
+		mExtraNonce = 0;
+		mNonceGenFirst[0] = mNonceGenFirst[1] = 0;
 		
-		if(!mBlockTemplate){
-			LogPrintf("ERROR: CreateNewBlock() failed.\n");
+		if(!coinbase_script){
+			LogPrintf("ERROR: CreateNewBlock(). No coinbase script available. Non initialised miner thread.\n");
 			return -1;
 		}
 		
-		if (!mBlockTemplate.get()){
-			LogPrintf("ERROR2: CreateNewBlock() failed.\n");
+		mTemplate = mTemplates->GetEmpty(hashBlock);
+		if(!mTemplate)
+			mTemplate = mTemplates->Get(hashBlock);
+		if(!mTemplate){
+			LogPrintf("ERROR: CreateNewBlock() failed.\n");
 			return -1;
 		}
 		
+		// Own copy of the shared template, paying to the script of this worker
+		mIndexPrev = mTemplate->pindexPrev;
+		mWorkTemplates.clear();
+		mWorkTemplates[0] = mTemplate;
+		mBlock = mTemplate->block;
+		mBlockTemplate = 0;
+		UseTemplate(mTemplate.get());
+		
 	}else if(sig.type() == proto::Signal::SHUTDOWN){
 		
 		LogPrintf("HandleInput(): proto::Signal::SHUTDOWN\n");
@@ -385,6 +1091,11 @@ int PrimeWorker::FlushStats() {
 	mServerStats.set_workers(mWorkerCount);
 	mServerStats.set_latency(latency);
 	mServerStats.set_cpd(cpd);
+	mServerStats.set_sharequeue(mSharesQueued);
+	mServerStats.set_shares(mSharesChecked);
+	mServerStats.set_sharesbusy(mSharesBusy);
+	mServerStats.set_sharelatency(mSharesChecked ? mShareTime / mSharesChecked / 1000 : 0);
+	mServerStats.set_tablemem(mTables.TableMem());
 	
 	for(std::map<std::pair<int,int>,int>::const_iterator iter = mReqStats.begin(); iter != mReqStats.end(); ++iter){
 		
@@ -395,6 +1106,11 @@ int PrimeWorker::FlushStats() {
 		
 	}
 	
+	{
+		LOCK(cs_stats);
+		mFlushedStats.CopyFrom(mServerStats);
+	}
+	
 	//mServerStats.PrintDebugString();
 	//DATACOIN OPTIMIZE?
 	//LogPrintf("[PrimeServer] %d workers, %d ms latency, %.2f chains/day\n", mWorkerCount, (int)latency, (float)cpd);
@@ -402,6 +1118,9 @@ int PrimeWorker::FlushStats() {
 	mServerStats.mutable_reqstats()->Clear();
 	mReqStats.clear();
 	mStats.clear();
+	mSharesChecked = 0;
+	mSharesBusy = 0;
+	mShareTime = 0;
 	
 	//LogPrintf("PrimeWorker %d: mInvCount = %d/%d\n", mThreadID, (unsigned)(mInvCount >> 32), (unsigned)mInvCount);
 	
@@ -410,6 +1129,61 @@ int PrimeWorker::FlushStats() {
 }
 
 
+int PrimeWorker::RefreshTemplate() {
+	
+	if(!mTemplate)
+		return 0;
+	
+	std::shared_ptr<const PoolTemplate> tmpl = mTemplates->Refresh(mTemplate);
+	if(tmpl != mTemplate){
+		mTemplate = tmpl;
+		mWorkTemplates[mExtraNonce + 1] = tmpl;
+	}
+	return 0;
+	
+}
+
+// Drops the templates whose works have all left mTables.works. Their shares are
+// STALE, SetExtraNonce is not called for them any more.
+void PrimeWorker::PruneWorkTemplates() {
+	
+	std::map<unsigned, std::shared_ptr<const PoolTemplate> >::iterator iter = mWorkTemplates.upper_bound(mNonceGenFirst[0]);
+	if(iter == mWorkTemplates.begin())
+		return;
+	mWorkTemplates.erase(mWorkTemplates.begin(), --iter);
+	
+}
+
+
+uint256 PrimeWorker::SetExtraNonce(unsigned extraNonce) {
+	
+	// Last template from before the work was issued
+	std::map<unsigned, std::shared_ptr<const PoolTemplate> >::const_iterator iter = mWorkTemplates.upper_bound(extraNonce);
+	UseTemplate((--iter)->second.get());
+	
+	// One coinbase hash plus the merkle branch of the template
+	mCoinbase.vin[0].scriptSig = CoinbaseScriptSig(mIndexPrev->nHeight+1, extraNonce);
+	mBlock.vtx[0] = MakeTransactionRef(mCoinbase);
+	mBlock.hashMerkleRoot = ComputeMerkleRootFromBranch(mBlock.vtx[0]->GetHash(), mBlockTemplate->vMerkleBranch, 0);
+	return mBlock.hashMerkleRoot;
+	
+}
+
+void PrimeWorker::UseTemplate(const PoolTemplate* tmpl) {
+	
+	if(tmpl == mBlockTemplate)
+		return;
+	
+	// The templates of a tip only differ in the transactions, the header
+	// fields are set from the work or the share
+	mBlock.vtx = tmpl->block.vtx;
+	mCoinbase = CMutableTransaction(*mBlock.vtx[0]);
+	mCoinbase.vout[0].scriptPubKey = coinbase_script->reserveScript;
+	mBlockTemplate = tmpl;
+	
+}
+
+
 int PrimeWorker::CheckVersion(unsigned version) {
 	
 	/*unsigned client = version >> 4;
@@ -426,6 +1200,19 @@ int PrimeWorker::CheckVersion(unsigned version) {
 }
 
 
+void PrimeWorker::MakeTableRoom() {
+	
+	if(mTables.MakeRoom()){
+		// The next work goes to the new generation, the last one issued may
+		// still be in the older
+		mNonceGenFirst[0] = mNonceGenFirst[1];
+		mNonceGenFirst[1] = mExtraNonce;
+		PruneWorkTemplates();
+	}
+	
+}
+
+
 int PrimeWorker::CheckReqNonce(const uint256& nonce) {
 	
 	const uint32_t* limbs = (uint32_t*)nonce.begin();
@@ -457,6 +1244,9 @@ int PrimeWorker::HandleRequest(zsock_t* item) {
 	rep.set_type(rtype);
 	rep.set_reqid(req.reqid());
 	
+	PoolShare* pshare = 0;
+	uint256 sharehash;
+	
 	if(!proto::Request::Type_IsValid(rtype)){
 		LogPrintf("ERROR: !proto::Request::Type_IsValid.\n");
 		rtype = proto::Request::NONE;
@@ -493,15 +1283,16 @@ int PrimeWorker::HandleRequest(zsock_t* item) {
 				break;
 			}
 			
-			CBlock *pblock = &mBlockTemplate->block;
-			IncrementExtraNonce(pblock, mIndexPrev, mExtraNonce);
+			CBlock *pblock = &mBlock;
+			SetExtraNonce(++mExtraNonce);
 			pblock->nTime = std::max(pblock->nTime, (unsigned int)GetAdjustedTime());
 			
-			mNonceMap[pblock->hashMerkleRoot] = mExtraNonce;
+			MakeTableRoom();
+			mTables.works.Insert(pblock->hashMerkleRoot, mExtraNonce);
 			
 			proto::Work* work = rep.mutable_work();
 			work->set_height(mCurrHeight);
-			work->set_merkle(pblock->hashMerkleRoot.GetHex());
+			SetWorkMerkleRoot(*work, pblock->hashMerkleRoot, req.version());
 			work->set_time(pblock->nTime);
 			work->set_bits(pblock->nBits);
 			
@@ -525,16 +1316,39 @@ int PrimeWorker::HandleRequest(zsock_t* item) {
 				break;
 			}
 			
+			// Limit the shares of a client waiting for the validators. A
+			// share the validators have no room for is refused too rather
+			// than checked here, which would hold back this worker.
+			zframe_t* client = zmsg_first(msg);
+			std::string clientid((const char*)zframe_data(client), zframe_size(client));
+			if(mClientShares.Full(clientid) || mValidator->Full()){
+				etype = SetBusyReply(rep, req.version());
+				mSharesBusy++;
+				break;
+			}
+			
 			if(share.length() < mCurrBlock.minshare()){
 				LogPrintf("ERROR: share.length too short.\n");
 				etype = proto::Reply::INVALID;
 				break;
 			}
 			
+			if(share.length() > nMaxChainLength){
+				LogPrintf("ERROR: share.length too long.\n");
+				etype = proto::Reply::INVALID;
+				break;
+			}
+			
+			uint256 headerHashClient;
 			uint256 merkleRoot;
-			merkleRoot.SetHex(share.merkle());
+			if(!ReadShareHashes(share, headerHashClient, merkleRoot, mBlock.bnPrimeChainMultiplier)){
+				LogPrintf("ERROR: share hashes invalid.\n");
+				etype = proto::Reply::INVALID;
+				break;
+			}
 			
-			unsigned extraNonce = mNonceMap[merkleRoot];
+			// Also stale once the work has been dropped from the table
+			const unsigned* extraNonce = mTables.works.Find(merkleRoot);
 			if(!extraNonce){
 				etype = proto::Reply::STALE;
 				break;
@@ -547,9 +1361,8 @@ int PrimeWorker::HandleRequest(zsock_t* item) {
 				break;
 			}
 			
-			CBlock *pblock = &mBlockTemplate->block;
-			extraNonce--;
-			IncrementExtraNonce(pblock, mIndexPrev, extraNonce);
+			CBlock *pblock = &mBlock;
+			SetExtraNonce(*extraNonce);
 			//DATACOIN MINER //DATACOIN OLDCLIENT 
 			//К сожалению текущий майнер не передает версию в сеть и считает nVersion==2
 			//Нужна правка клиента xpmclient
@@ -559,23 +1372,21 @@ int PrimeWorker::HandleRequest(zsock_t* item) {
 			pblock->nNonce = share.nonce();
 			
 			uint256 headerHash = pblock->GetHeaderHash();
-			{
-				uint256 headerHashClient;
-				headerHashClient.SetHex(share.hash());
-				if(headerHashClient != headerHash){
-					LogPrintf("ERROR: headerHashClient != headerHash.\n");
-					etype = proto::Reply::INVALID;
-					break;
-				}
+			if(headerHashClient != headerHash){
+				LogPrintf("ERROR: headerHashClient != headerHash.\n");
+				etype = proto::Reply::INVALID;
+				break;
 			}
 			
-			pblock->bnPrimeChainMultiplier.SetHex(share.multi());
 			uint256 blockhash = pblock->GetHash();
 			
-			if(!mShares.insert(blockhash).second){
+			// The share is recorded once it is queued, a refused share may
+			// be sent again
+			if(mTables.shares.Find(blockhash)){
 				etype = proto::Reply::DUPLICATE;
 				break;
 			}
+			sharehash = blockhash;
 			
 			//CBigNum bnChainOrigin = CBigNum(headerHash) * pblock->bnPrimeChainMultiplier;
 			//unsigned int nChainLength = 0;
@@ -584,18 +1395,28 @@ int PrimeWorker::HandleRequest(zsock_t* item) {
 			//DATACOIN OPTIMIZE? or ferma test = false?
 			//bool isblock = ProbablePrimeChainTest(bnChainOrigin, pblock->nBits, true, nChainLengthCunningham1, nChainLengthCunningham2, nChainLengthBiTwin);
 			
-			bool isblock = CheckWork(pblock, *mWallet, coinbase_script, true);
-			
-			if (isblock) {
-				LogPrintf("[PrimeServer] target=%s len=%s type=%d\n", TargetToString(pblock->nBits).c_str(), TargetToString(pblock->nPrimeChainLength).c_str(), (int)pblock->nPrimeChainType);
-				LogPrintf("[PrimeServer] !!! --- BLOCK ACCEPTED --- !!!\n");
-				rep.set_errstr("!!! --- BLOCK ACCEPTED --- !!!");
-			}else{
-				//LogPrintf("[PrimeServer] target=%s len=%d type=%d\n", TargetToString(pblock->nBits).c_str(), (int)share.length(), (int)share.chaintype()+1);
-				//LogPrintf("[PrimeServer] !!! --- BLOCK REJECTED --- !!!\n");
-				//rep.set_errstr("BLOCK ACCEPTED");
-				//etype = proto::Reply::INVALID;
-			}
+			// CheckWork runs on the ShareValidator threads
+			pshare = new PoolShare();
+			pshare->threadid = mThreadID;
+			pshare->client = clientid;
+			pshare->block = *pblock;
+			pshare->script = coinbase_script;
+			pshare->nTimeReceived = GetTimeMicros();
+			pshare->isblock = false;
+			
+			// The share is tested up to the length it claims, which is the
+			// length recorded for the payouts. Only the shares reported as long
+			// enough for the block target are checked in full and submitted.
+			pshare->chaintype = nCandidateType + 1;
+			pshare->minlength = TargetFromInt(share.length());
+			pshare->checkblock = share.isblock() || share.length() >= TargetGetLength(pblock->nBits);
+			
+			pshare->record.addr = share.addr();
+			pshare->record.name = share.name();
+			pshare->record.height = mCurrHeight;
+			pshare->record.length = share.length();
+			pshare->record.chaintype = nCandidateType;
+			pshare->record.time = GetTime();
 			
 			//nChainLength = TargetGetLength(nChainLength);
 			//nChainLength = pblock->nPrimeChainLength;
@@ -659,6 +1480,33 @@ int PrimeWorker::HandleRequest(zsock_t* item) {
 		rep.mutable_block()->CopyFrom(mCurrBlock);
 	}
 	
+	if(pshare){
+		
+		// The reply is sent by CompleteShare once the share has been checked
+		rep.set_error(etype);
+		pshare->rep.CopyFrom(rep);
+		pshare->socket = item;
+		pshare->msg = msg;
+		
+		std::string clientid = pshare->client;
+		if(mValidator->Push(pshare)){
+			MakeTableRoom();
+			mTables.shares.Insert(sharehash);
+			mClientShares.Add(clientid);
+			mSharesQueued++;
+		}else{
+			// Other workers filled the queue since the check above
+			pshare->rep.set_error(SetBusyReply(pshare->rep, req.version()));
+			mSharesBusy++;
+			mReqStats[std::make_pair(rtype, (int)pshare->rep.error())]++;
+			SendReply(pshare->rep, &pshare->msg, item);
+			zmsg_destroy(&pshare->msg);
+			delete pshare;
+		}
+		return 0;
+		
+	}
+	
 	mReqStats[std::make_pair(rtype,etype)]++;
 	
 	rep.set_error(etype);
@@ -671,13 +1519,61 @@ int PrimeWorker::HandleRequest(zsock_t* item) {
 }
 
 
+int PrimeWorker::HandleShare(zsock_t* item) {
+	
+	zframe_t* frame = zframe_recv(item);
+	if(!frame)
+		return 0;
+	
+	PoolShare* share = 0;
+	if(zframe_size(frame) == sizeof(share))
+		memcpy(&share, zframe_data(frame), sizeof(share));
+	zframe_destroy(&frame);
+	
+	if(share)
+		CompleteShare(share);
+	return 0;
+	
+}
+
+
+void PrimeWorker::CompleteShare(PoolShare* share) {
+	
+	proto::Reply& rep = share->rep;
+	
+	if(share->isblock){
+		const CBlock* pblock = &share->block;
+		LogPrintf("[PrimeServer] target=%s len=%s type=%d\n", TargetToString(pblock->nBits).c_str(), TargetToString(pblock->nPrimeChainLength).c_str(), (int)pblock->nPrimeChainType);
+		LogPrintf("[PrimeServer] !!! --- BLOCK ACCEPTED --- !!!\n");
+		rep.set_errstr("!!! --- BLOCK ACCEPTED --- !!!");
+	}
+	
+	mClientShares.Remove(share->client);
+	mSharesQueued--;
+	
+	mSharesChecked++;
+	mShareTime += GetTimeMicros() - share->nTimeReceived;
+	
+	if(mShareLog && rep.error() == proto::Reply::NONE)
+		mShareLog->Append(share->record);
+	mReqStats[std::make_pair((int)proto::Request::SHARE, (int)rep.error())]++;
+	
+	SendReply(rep, &share->msg, share->socket);
+	
+	zmsg_destroy(&share->msg);
+	delete share;
+	
+}
+
+
 
 
-PoolFrontend::PoolFrontend(unsigned port) {
+PoolFrontend::PoolFrontend(unsigned port, unsigned workers) {
 	
 	
 	mPort = port;
-	mDealer = 0;
+	mWorkerCount = std::max(workers, 1u);
+	mBackend = 0;
 	mRouter = 0;
 	
 	mPipe = zactor_new(&PoolFrontend::InvokeProxy, this);
@@ -686,17 +1582,23 @@ PoolFrontend::PoolFrontend(unsigned port) {
 
 PoolFrontend::~PoolFrontend() {
 	
-	zsock_destroy(&mRouter);
-	zsock_destroy(&mDealer);
-	
-	//zsock_wait(mPipe);
-	//zactor_destroy(&mPipe);
+	zactor_destroy(&mPipe);
 	
 	LogPrintf("PoolFrontend stopped.\n");
 	
 }
 
 
+unsigned PoolFrontend::SelectWorker(zframe_t* client) const {
+	
+	// All requests of a connection go to the same worker, which keeps the
+	// nonces and shares of that client
+	std::string identity((const char*)zframe_data(client), zframe_size(client));
+	return std::hash<std::string>()(identity) % mWorkerCount;
+	
+}
+
+
 void PoolFrontend::InvokeProxy(zsock_t *pipe, void *arg) {
 	
 	((PoolFrontend*)arg)->ProxyLoop(pipe);
@@ -705,30 +1607,73 @@ void PoolFrontend::InvokeProxy(zsock_t *pipe, void *arg) {
 
 void PoolFrontend::ProxyLoop(zsock_t *pipe) {
 
-	mDealer = zsock_new(ZMQ_DEALER);
+	mBackend = zsock_new(ZMQ_ROUTER);
 	mRouter = zsock_new(ZMQ_ROUTER);
 	
-	zsock_bind(mDealer, "inproc://frontend");
+	zsock_bind(mBackend, "inproc://frontend");
 	unsigned ret = zsock_bind(mRouter, "tcp://*:%d", mPort);
 	if(ret != mPort){
 		LogPrintf("Frontend: ERROR: zsock_bind failed.\n");
 		exit(-1);
 	}
 	
-	void* zmq_socket_r = zsock_resolve(mRouter);
-	void* zmq_socket_d = zsock_resolve(mDealer);
-	
-	LogPrintf("PoolFrontend started at %s on port %d.\n", gArgs.GetArg("-host", "127.0.0.1").c_str(), mPort);
+	LogPrintf("PoolFrontend started at %s on port %d with %u workers.\n", gArgs.GetArg("-host", "127.0.0.1").c_str(), mPort, mWorkerCount);
 	zsock_signal(pipe, 0);
 	
-	zmq_proxy(zmq_socket_r, zmq_socket_d, 0);
+	zmq_pollitem_t items[3] = {
+		{zsock_resolve(mRouter), 0, ZMQ_POLLIN, 0},
+		{zsock_resolve(mBackend), 0, ZMQ_POLLIN, 0},
+		{zsock_resolve(pipe), 0, ZMQ_POLLIN, 0}
+	};
 	
+	while(true){
+		
+		if(zmq_poll(items, 3, -1) < 0){
+			if(zmq_errno() == EINTR)
+				continue;
+			break;
+		}
+		
+		if(items[0].revents & ZMQ_POLLIN){
+			
+			// [client, ..., request] -> [worker, client, ..., request]
+			zmsg_t* msg = zmsg_recv(mRouter);
+			if(!msg)
+				break;
+			std::string worker = PrimeWorker::GetIdentity(SelectWorker(zmsg_first(msg)));
+			zmsg_pushmem(msg, worker.data(), worker.size());
+			zmsg_send(&msg, mBackend);
+			
+		}
+		
+		if(items[1].revents & ZMQ_POLLIN){
+			
+			// [worker, client, ..., reply] -> [client, ..., reply]
+			zmsg_t* msg = zmsg_recv(mBackend);
+			if(!msg)
+				break;
+			zframe_t* worker = zmsg_pop(msg);
+			zframe_destroy(&worker);
+			zmsg_send(&msg, mRouter);
+			
+		}
 		
-	//zsock_destroy(&mRouter);
-	//zsock_destroy(&mDealer);
+		if(items[2].revents & ZMQ_POLLIN){
+			
+			// $TERM from zactor_destroy
+			zmsg_t* msg = zmsg_recv(pipe);
+			zmsg_destroy(&msg);
+			break;
+			
+		}
+		
+	}
+	
+	zsock_destroy(&mRouter);
+	zsock_destroy(&mBackend);
 	
 	LogPrintf("PoolFrontend proxy loop stopped.\n");
-	//zsock_signal(pipe, 0);
+	zsock_signal(pipe, 0);
 	
 }
 
@@ -740,8 +1685,15 @@ PoolServer::PoolServer(CWallet* pwallet) {
 	LogPrintf("[PrimeServer] PoolServer starting...\n");
 	
 	mWallet = pwallet;
+	
+	// Each worker thread serves its own share of the clients on its own
+	// -serverport + 2*threadid router and signal ports. <= 0 uses all cores.
+	int nThreads = gArgs.GetArg("-poolworkers", DEFAULT_POOL_WORKERS);
+	if(nThreads <= 0)
+		nThreads = GetNumCores();
+	nThreads = std::max(std::min(nThreads, MAX_POOL_WORKERS), 1);
 
-	mFrontend = new PoolFrontend(gArgs.GetArg("-frontport", 6666));
+	mFrontend = new PoolFrontend(gArgs.GetArg("-frontport", 6666), nThreads);
 	
 	mWorkerSignals = zsock_new(ZMQ_PUB);
 	zsock_bind(mWorkerSignals, "inproc://bitcoin");
@@ -749,26 +1701,49 @@ PoolServer::PoolServer(CWallet* pwallet) {
 	mMinShare = gArgs.GetArg("-minshare", 9); //DATACOIN MINER //DATACOIN OPTIMIZE? was 8
 	mTarget = gArgs.GetArg("-target", 9); //DATACOIN MINER //DATACOIN OPTIMIZE? was 10
 	
-	//int nThreads = gArgs.GetArg("-genproclimit", 1);
-	//int nThreads = 1;
-	//for(int i = 0; i < nThreads; ++i){
+	// Threads checking the shares of all workers. <= 0 uses all cores.
+	int nValidators = gArgs.GetArg("-poolvalidators", DEFAULT_POOL_VALIDATORS);
+	if(nValidators <= 0)
+		nValidators = GetNumCores();
+	nValidators = std::max(std::min(nValidators, MAX_POOL_VALIDATORS), 1);
+	mValidator = new ShareValidator(mWallet, nValidators, gArgs.GetArg("-poolsharequeue", DEFAULT_POOL_SHARE_QUEUE));
+	
+	// Accepted shares for the payouts
+	mShareLog = 0;
+	if(gArgs.GetBoolArg("-poolsharelog", DEFAULT_POOL_SHARE_LOG))
+		mShareLog = new PoolShareLog(8 << 20);
+	
+	for(int i = 0; i < nThreads; ++i){
 		
-		PrimeWorker* worker = new PrimeWorker(mWallet, 0, mTarget);
+		PrimeWorker* worker = new PrimeWorker(mWallet, &mTemplates, mValidator, mShareLog, i, mTarget);
 		zactor_t* pipe = zactor_new(&PrimeWorker::InvokeWork, worker);
 		mWorkers.push_back(std::make_pair(worker, pipe));
 		
-	//}
-	LogPrintf("[PrimeServer] PoolServer started.\n");
+	}
+	
+	RegisterValidationInterface(this);
+	
+	LogPrintf("[PrimeServer] PoolServer started with %d workers.\n", nThreads);
 }
 
 PoolServer::~PoolServer(){
 	
 	LogPrintf("[PrimeServer] PoolServer stopping...\n");
 	
+	UnregisterValidationInterface(this);
+	
+	// Stop the validator threads first, they send the shares they checked to
+	// the workers. The workers refuse the shares they get from now on.
+	mValidator->Stop();
+	mTemplates.Stop();
+	
 	proto::Signal sig;
 	sig.set_type(proto::Signal_Type_SHUTDOWN);
 	
-	SendSignal(sig, mWorkerSignals);
+	{
+		LOCK(cs_signals);
+		SendSignal(sig, mWorkerSignals);
+	}
 
 	zsys_interrupted=0;
 	for(unsigned i = 0; i < mWorkers.size(); ++i){
@@ -778,8 +1753,12 @@ PoolServer::~PoolServer(){
 		delete mWorkers[i].first;
 	}
 	
+	// No worker uses the validator any more
+	delete mValidator;
+	
 	zsock_destroy(&mWorkerSignals);
 	
+	delete mShareLog;
 	delete mFrontend;
 	
 	zsys_shutdown();
@@ -794,6 +1773,52 @@ void PoolServer::NotifyNewBlock(CBlockIndex* pindex) {
 	//DATACOIN OPTIMIZE?
 	//LogPrintf("[PrimeServer] NotifyNewBlock, height=%d\n", pindex->nHeight);
 	
+	SendNewBlock(pindex);
+	
+}
+
+
+void PoolServer::NewPoWValidBlock(const CBlockIndex* pindex, const std::shared_ptr<const CBlock>& block) {
+	
+	if(ShutdownRequested())
+		return;
+	
+	// Connecting the block can take a while, the miners switch to it at once
+	// with a coinbase-only template and the full one follows on NotifyNewBlock
+	std::unique_ptr<CBlockTemplate> pblocktemplate = BlockAssembler(Params()).CreateEmptyBlock(CScript() << OP_TRUE, pindex);
+	
+	std::shared_ptr<PoolTemplate> tmpl = std::make_shared<PoolTemplate>();
+	tmpl->block = pblocktemplate->block;
+	tmpl->pindexPrev = pindex;
+	tmpl->vMerkleBranch = BlockMerkleBranch(tmpl->block, 0);
+	tmpl->fEmpty = true;
+	tmpl->nTimeCreated = GetTime();
+	mTemplates.SetEmpty(tmpl);
+	
+	SendNewBlock(pindex);
+	
+}
+
+
+void PoolServer::BlockChecked(const CBlock& block, const CValidationState& state) {
+	
+	if(state.IsValid() || ShutdownRequested())
+		return;
+	
+	// A block announced by NewPoWValidBlock failed to connect. The tip is
+	// still its parent, the miners are moved back to it.
+	if(!mTemplates.ClearEmpty(block.GetHash()))
+		return;
+	
+	const CBlockIndex* pindex = chainActive.Tip();
+	if(pindex && pindex->pprev)
+		SendNewBlock(pindex);
+	
+}
+
+
+void PoolServer::SendNewBlock(const CBlockIndex* pindex) {
+	
 	proto::Signal sig;
 	sig.set_type(proto::Signal::NEWBLOCK);
 	
@@ -801,14 +1826,138 @@ void PoolServer::NotifyNewBlock(CBlockIndex* pindex) {
 	block->set_height(pindex->nHeight);
 	block->set_hash(pindex->phashBlock->GetHex());
 	block->set_prevhash(pindex->pprev->phashBlock->GetHex());
+	block->set_hashbin(pindex->phashBlock->begin(), pindex->phashBlock->size());
+	block->set_prevhashbin(pindex->pprev->phashBlock->begin(), pindex->pprev->phashBlock->size());
 	block->set_reqdiff(0);
 	block->set_minshare(mMinShare);
 	
+	// Signalled from the threads connecting blocks as well
+	LOCK(cs_signals);
 	SendSignal(sig, mWorkerSignals);
 	
 }
 
 
+void PoolServer::AggregateStats(proto::ServerStats& stats) {
+	
+	stats.Clear();
+	stats.set_name(gArgs.GetArg("-servername", "DatacoinMineServer"));
+	stats.set_thread(mWorkers.size());
+	
+	unsigned workers = 0;
+	uint64_t latency = 0;
+	double cpd = 0;
+	unsigned sharequeue = 0;
+	unsigned shares = 0;
+	unsigned sharesbusy = 0;
+	uint64_t sharelatency = 0;
+	unsigned tablemem = 0;
+	std::map<std::pair<int,int>, unsigned> reqstats;
+	
+	for(unsigned i = 0; i < mWorkers.size(); ++i){
+		
+		proto::ServerStats wstats;
+		mWorkers[i].first->GetStats(wstats);
+		
+		workers += wstats.workers();
+		latency += (uint64_t)wstats.latency() * wstats.workers();
+		cpd += wstats.cpd();
+		sharequeue += wstats.sharequeue();
+		shares += wstats.shares();
+		sharesbusy += wstats.sharesbusy();
+		sharelatency += (uint64_t)wstats.sharelatency() * wstats.shares();
+		tablemem += wstats.tablemem();
+		for(int j = 0; j < wstats.reqstats_size(); ++j){
+			const proto::ReqStats& req = wstats.reqstats(j);
+			reqstats[std::make_pair((int)req.reqtype(), (int)req.errtype())] += req.count();
+		}
+		
+	}
+	
+	// Latency is the average over the miners of all workers
+	stats.set_workers(workers);
+	stats.set_latency(workers ? latency / workers : 0);
+	stats.set_cpd(cpd);
+	stats.set_sharequeue(sharequeue);
+	stats.set_shares(shares);
+	stats.set_sharesbusy(sharesbusy);
+	stats.set_sharelatency(shares ? sharelatency / shares : 0);
+	stats.set_tablemem(tablemem);
+	
+	for(std::map<std::pair<int,int>, unsigned>::const_iterator iter = reqstats.begin(); iter != reqstats.end(); ++iter){
+		
+		proto::ReqStats* req = stats.add_reqstats();
+		req->set_reqtype((proto::Request::Type)iter->first.first);
+		req->set_errtype((proto::Reply::ErrType)iter->first.second);
+		req->set_count(iter->second);
+		
+	}
+	
+}
+
+
+UniValue PoolServer::GetStats() {
+	
+	proto::ServerStats stats;
+	AggregateStats(stats);
+	
+	UniValue requests(UniValue::VARR);
+	for(int i = 0; i < stats.reqstats_size(); ++i){
+		
+		const proto::ReqStats& req = stats.reqstats(i);
+		UniValue entry(UniValue::VOBJ);
+		entry.push_back(Pair("type", proto::Request::Type_Name(req.reqtype())));
+		entry.push_back(Pair("error", proto::Reply::ErrType_Name(req.errtype())));
+		entry.push_back(Pair("count", (uint64_t)req.count()));
+		requests.push_back(entry);
+		
+	}
+	
+	UniValue obj(UniValue::VOBJ);
+	obj.push_back(Pair("name", stats.name()));
+	obj.push_back(Pair("threads", (uint64_t)stats.thread()));
+	obj.push_back(Pair("workers", (uint64_t)stats.workers()));
+	obj.push_back(Pair("latency", (uint64_t)stats.latency()));
+	obj.push_back(Pair("cpd", (double)stats.cpd()));
+	obj.push_back(Pair("sharequeue", (uint64_t)stats.sharequeue()));
+	obj.push_back(Pair("shares", (uint64_t)stats.shares()));
+	obj.push_back(Pair("sharesbusy", (uint64_t)stats.sharesbusy()));
+	obj.push_back(Pair("sharelatency", (uint64_t)stats.sharelatency()));
+	obj.push_back(Pair("tablemem", (uint64_t)stats.tablemem()));
+	obj.push_back(Pair("requests", requests));
+	return obj;
+	
+}
+
+
+UniValue PoolServer::GetShares(unsigned nStartHeight, unsigned nEndHeight, unsigned nMaxCount) {
+	
+	if(!mShareLog)
+		throw std::runtime_error("Share log is disabled (-poolsharelog=0)");
+	
+	std::vector<PoolShareRecord> records;
+	mShareLog->Read(nStartHeight, nEndHeight, std::min(nMaxCount, MAX_POOL_SHARE_LOG_QUERY), records);
+	
+	UniValue result(UniValue::VARR);
+	for(unsigned i = 0; i < records.size(); ++i){
+		
+		const PoolShareRecord& record = records[i];
+		UniValue entry(UniValue::VOBJ);
+		entry.push_back(Pair("addr", repInvUTF8(record.addr)));
+		entry.push_back(Pair("name", repInvUTF8(record.name)));
+		entry.push_back(Pair("height", (uint64_t)record.height));
+		entry.push_back(Pair("length", (uint64_t)record.length));
+		entry.push_back(Pair("chaintype", (uint64_t)record.chaintype));
+		entry.push_back(Pair("time", record.time));
+		result.push_back(entry);
+		
+	}
+	
+	return result;
+	
+}
+
+
 void PoolServer::SendSignal(proto::Signal& sig, zsock_t* socket) {
 	
 	size_t fsize = sig.ByteSize()+1;
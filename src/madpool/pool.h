@@ -24,15 +24,31 @@
 #include "madpool/primeserver.h"
 #include "wallet/wallet.h"
 
+#include "dbwrapper.h"
+#include "hash.h"
+#include "memusage.h"
 #include "miner.h"
 #include "prime/prime.h"
+#include "random.h"
+#include "serialize.h"
+#include "sync.h"
+#include "txmempool.h"
+#include "validationinterface.h"
 
 #undef loop
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <limits>
 #include <map>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <vector>
 
 
 
@@ -43,6 +59,31 @@
 using namespace pool;
 
 
+static const int DEFAULT_POOL_WORKERS = 1;
+static const int MAX_POOL_WORKERS = 64;
+static const int DEFAULT_POOL_VALIDATORS = 2;
+static const int MAX_POOL_VALIDATORS = 64;
+static const unsigned DEFAULT_POOL_SHARE_QUEUE = 1024;
+static const unsigned DEFAULT_POOL_CLIENT_SHARES = 16;
+static const unsigned DEFAULT_POOL_TABLE_MEM = 16;
+// Seconds before the template of a tip is assembled again with the new
+// transactions of the mempool, as the internal miner does
+static const int64_t POOL_TEMPLATE_REFRESH = 10;
+static const bool DEFAULT_POOL_SHARE_LOG = true;
+// Accepted shares are written to the share log in batches of this size, or
+// after this many milliseconds
+static const size_t POOL_SHARE_LOG_BATCH = 1024;
+static const int64_t POOL_SHARE_LOG_FLUSH_MS = 1000;
+static const unsigned MAX_POOL_SHARE_LOG_QUERY = 100000;
+// Miner protocol version from which the work carries its merkle root in
+// binary. Any client may send the hashes of its shares in binary.
+static const unsigned POOL_BINARY_VERSION = 11;
+// Miner protocol version from which the client knows the BUSY reply. Older
+// clients are sent STALE instead.
+static const unsigned POOL_BUSY_VERSION = 12;
+static const size_t MAX_SHARE_MULTIPLIER_SIZE = 256;
+
+
 
 inline bool isValidUTF8(const std::string& str) {
 	
@@ -59,18 +100,458 @@ inline std::string repInvUTF8(const std::string& str) {
 }
 
 
+// Header hash, merkle root and multiplier of a share, copied from the binary
+// fields when the client sent them and parsed from hex otherwise.
+bool ReadShareHashes(const proto::Share& share, uint256& hashHeader, uint256& hashMerkleRoot, CBigNum& bnMultiplier);
+
+// Merkle root of a work, in binary for the clients that read it.
+void SetWorkMerkleRoot(proto::Work& work, const uint256& hashMerkleRoot, unsigned version);
+
+// Error of a share the pool has no room to check now. Clients from
+// POOL_BUSY_VERSION get BUSY and send the share again, older ones get STALE.
+proto::Reply::ErrType SetBusyReply(proto::Reply& rep, unsigned version);
+
+
+
+
+// Hash table of uint256 keys for the duplicate checks of a worker, with open
+// addressing and a memory limit. Keys go to the newer of two generations.
+// When it is half full at the largest size that fits the limit, the older
+// generation is dropped and reused, so the table forgets the oldest keys
+// instead of growing. Tables whose keys depend on each other rotate
+// together, see PoolWorkTables. The slots are picked with a
+// salted SipHash because the request nonces are chosen by the clients.
+template<typename T>
+class PoolHashTable {
+public:
+	
+	explicit PoolHashTable(size_t nMaxMemory = 0);
+	
+	// False if the key is already present
+	bool Insert(const uint256& key, const T& value = T());
+	const T* Find(const uint256& key) const;
+	void Clear();
+	
+	// Whether the next Insert drops the older generation
+	bool Full() const;
+	// Drops the older generation and starts a new one
+	void Rotate();
+	
+	size_t Size() const { return mCount[0] + mCount[1]; }
+	size_t DynamicMemoryUsage() const;
+	
+private:
+	
+	static const size_t MIN_SLOTS = 1024;
+	
+	struct Slot {
+		uint256 key;
+		T value;
+		bool used;
+	};
+	
+	const Slot* Lookup(const std::vector<Slot>& table, const uint256& key) const;
+	void Place(std::vector<Slot>& table, const uint256& key, const T& value);
+	
+	std::vector<Slot> mTables[2];
+	size_t mCount[2];
+	unsigned mCurrent;
+	size_t mMaxSlots;
+	uint64_t mK0;
+	uint64_t mK1;
+	
+};
+
+
+template<typename T>
+PoolHashTable<T>::PoolHashTable(size_t nMaxMemory) {
+	
+	// Both generations at their largest size fit the limit
+	mMaxSlots = MIN_SLOTS;
+	while(4 * mMaxSlots * sizeof(Slot) <= nMaxMemory)
+		mMaxSlots *= 2;
+	
+	mCount[0] = mCount[1] = 0;
+	mCurrent = 0;
+	mK0 = GetRand(std::numeric_limits<uint64_t>::max());
+	mK1 = GetRand(std::numeric_limits<uint64_t>::max());
+	
+}
+
+
+template<typename T>
+bool PoolHashTable<T>::Insert(const uint256& key, const T& value) {
+	
+	if(Find(key))
+		return false;
+	
+	std::vector<Slot>& table = mTables[mCurrent];
+	if(2 * (mCount[mCurrent] + 1) > table.size()){
+		if(table.size() < mMaxSlots){
+			std::vector<Slot> old(table.size() ? 2 * table.size() : MIN_SLOTS);
+			old.swap(table);
+			for(size_t i = 0; i < old.size(); ++i)
+				if(old[i].used)
+					Place(table, old[i].key, old[i].value);
+		}else
+			Rotate();
+	}
+	
+	Place(mTables[mCurrent], key, value);
+	mCount[mCurrent]++;
+	return true;
+	
+}
+
+
+template<typename T>
+const T* PoolHashTable<T>::Find(const uint256& key) const {
+	
+	const Slot* slot = Lookup(mTables[mCurrent], key);
+	if(!slot)
+		slot = Lookup(mTables[mCurrent ^ 1], key);
+	return slot ? &slot->value : 0;
+	
+}
+
+
+template<typename T>
+bool PoolHashTable<T>::Full() const {
+	
+	const std::vector<Slot>& table = mTables[mCurrent];
+	return table.size() >= mMaxSlots && 2 * (mCount[mCurrent] + 1) > table.size();
+	
+}
+
+
+template<typename T>
+void PoolHashTable<T>::Rotate() {
+	
+	// The new generation starts at the size the current one reached
+	const size_t nSlots = mTables[mCurrent].size();
+	mCurrent ^= 1;
+	mTables[mCurrent].assign(nSlots, Slot());
+	mCount[mCurrent] = 0;
+	
+}
+
+
+template<typename T>
+void PoolHashTable<T>::Clear() {
+	
+	for(unsigned i = 0; i < 2; ++i){
+		std::vector<Slot>().swap(mTables[i]);
+		mCount[i] = 0;
+	}
+	
+}
+
+
+template<typename T>
+size_t PoolHashTable<T>::DynamicMemoryUsage() const {
+	
+	return memusage::DynamicUsage(mTables[0]) + memusage::DynamicUsage(mTables[1]);
+	
+}
+
+
+template<typename T>
+const typename PoolHashTable<T>::Slot* PoolHashTable<T>::Lookup(const std::vector<Slot>& table, const uint256& key) const {
+	
+	if(table.empty())
+		return 0;
+	
+	// Linear probing, a table is at most half full
+	size_t mask = table.size() - 1;
+	for(size_t i = SipHashUint256(mK0, mK1, key) & mask; table[i].used; i = (i + 1) & mask)
+		if(table[i].key == key)
+			return &table[i];
+	return 0;
+	
+}
+
+
+template<typename T>
+void PoolHashTable<T>::Place(std::vector<Slot>& table, const uint256& key, const T& value) {
+	
+	size_t mask = table.size() - 1;
+	size_t i = SipHashUint256(mK0, mK1, key) & mask;
+	while(table[i].used)
+		i = (i + 1) & mask;
+	table[i].key = key;
+	table[i].value = value;
+	table[i].used = true;
+	
+}
+
+
+// Duplicate tables of a worker: the extranonces of the works by merkle root,
+// the request nonces and the shares. They split the memory limit and drop
+// their older generation together, so a share or request nonce is forgotten
+// no earlier than the work it was made for, after which the share is STALE
+// instead of being credited again.
+struct PoolWorkTables {
+	
+	explicit PoolWorkTables(size_t nMaxMemory = 0);
+	
+	// Rotates all tables when one of them is full, true if they rotated
+	bool MakeRoom();
+	void Clear();
+	
+	size_t DynamicMemoryUsage() const;
+	// In kB, as reported in ServerStats.tablemem
+	unsigned TableMem() const { return DynamicMemoryUsage() >> 10; }
+	
+	PoolHashTable<unsigned> works;
+	PoolHashTable<bool> reqnonces;
+	PoolHashTable<bool> shares;
+	
+};
+
+// Memory limit of the tables of a worker from -pooltablemem, in bytes.
+size_t GetPoolTableMemory();
+
+
+
+
+// Block template of a tip, shared by all the workers. The coinbase is the
+// first transaction, so its merkle branch does not depend on the coinbase and
+// the merkle root of a new extranonce costs log2(transactions) hashes.
+// An empty template only has the coinbase, it is built on a block which was
+// announced before it is connected.
+struct PoolTemplate {
+	
+	CBlock block;
+	const CBlockIndex* pindexPrev;
+	std::vector<uint256> vMerkleBranch;
+	bool fEmpty;
+	int64_t nTimeCreated;
+	
+};
+
+
+
+class PoolTemplates {
+public:
+	
+	PoolTemplates();
+	~PoolTemplates();
+	
+	// Stops following the mempool and joins the refresh thread
+	void Stop();
+	
+	std::shared_ptr<const PoolTemplate> Get(const uint256& hashPrev);
+	
+	// Template the refresh thread made with the new transactions of the
+	// mempool, or current. Never assembles a template itself.
+	std::shared_ptr<const PoolTemplate> Refresh(const std::shared_ptr<const PoolTemplate>& current);
+	
+	// Called under mempool.cs. A new transaction is picked up on the next
+	// refresh, losing one of the template refreshes it at once.
+	void TransactionAdded(CTransactionRef ptx);
+	void TransactionRemoved(CTransactionRef ptx, MemPoolRemovalReason reason);
+	
+	// The empty template is set under cs_main and read without it, so that
+	// the workers do not wait for the block to be connected
+	std::shared_ptr<const PoolTemplate> GetEmpty(const uint256& hashPrev);
+	void SetEmpty(const std::shared_ptr<const PoolTemplate>& tmpl);
+	// Drops the empty template if it is made on hashPrev
+	bool ClearEmpty(const uint256& hashPrev);
+	
+private:
+	
+	// Assembles a template of the tip without holding cs, null on failure
+	std::shared_ptr<const PoolTemplate> Create();
+	// A refreshed template only replaces one of the same tip
+	void SetTemplate(const std::shared_ptr<const PoolTemplate>& tmpl, bool fRefresh);
+	
+	// Assembles a new template of the tip every POOL_TEMPLATE_REFRESH
+	// seconds when the mempool has new transactions, so that the workers do
+	// not call CreateNewBlock between their requests. Only the swap of
+	// mTemplate holds cs.
+	void ThreadRefresh();
+	
+	// Held by a worker assembling the template of a new tip, the other
+	// workers wait for it instead of assembling the same template
+	CCriticalSection cs_create;
+	
+	CCriticalSection cs;
+	std::shared_ptr<const PoolTemplate> mTemplate;
+	std::set<uint256> mTemplateTxs;
+	
+	std::mutex cs_refresh;
+	std::condition_variable cond;
+	bool mStop;
+	// Set by the mempool events since the last refresh
+	bool mChanged;
+	bool mInvalid;
+	std::thread mThread;
+	
+	CCriticalSection cs_empty;
+	std::shared_ptr<const PoolTemplate> mEmpty;
+	
+};
+
+
+
+// Accepted share, as kept in the share log for the payouts
+struct PoolShareRecord {
+	
+	std::string addr;
+	std::string name;
+	uint32_t height;
+	uint32_t length;
+	uint32_t chaintype;
+	int64_t time;
+	
+	ADD_SERIALIZE_METHODS;
+	
+	template <typename Stream, typename Operation>
+	inline void SerializationOp(Stream& s, Operation ser_action) {
+		READWRITE(addr);
+		READWRITE(name);
+		READWRITE(height);
+		READWRITE(length);
+		READWRITE(chaintype);
+		READWRITE(time);
+	}
+	
+};
+
+
+
+// Share waiting for its proof-of-work check. The routing frames of the
+// request stay with the share and carry the reply back to the client.
+struct PoolShare {
+	
+	unsigned threadid;
+	zsock_t* socket;
+	zmsg_t* msg;
+	std::string client;
+	
+	proto::Reply rep;
+	CBlock block;
+	std::shared_ptr<CReserveScript> script;
+	int64_t nTimeReceived;
+	
+	unsigned chaintype;
+	unsigned minlength;
+	bool checkblock;
+	bool isblock;
+	
+	PoolShareRecord record;
+	
+};
+
+
+
+// Pool of threads running CheckWork for the shares of all workers. A checked
+// share is handed back to the socket of its worker, which sends the reply.
+class ShareValidator {
+public:
+	
+	ShareValidator(CWallet* pwallet, unsigned threads, unsigned maxqueue);
+	~ShareValidator();
+	
+	// Joins the threads. Push refuses the shares from then on.
+	void Stop();
+	
+	// False when the queue is full or the validator stopped
+	bool Push(PoolShare* share);
+	bool Full();
+	void Validate(PoolShare* share, CPrimalityTestParams& testParams);
+	
+private:
+	
+	void ThreadValidate();
+	
+	CWallet* mWallet;
+	unsigned mMaxQueue;
+	
+	std::mutex cs;
+	std::condition_variable cond;
+	std::deque<PoolShare*> mQueue;
+	bool mStop;
+	
+	std::vector<std::thread> mThreads;
+	
+};
+
+
+
+// Shares of each client of a worker waiting for the validators, up to
+// -poolclientshares per client
+class PoolClientShares {
+public:
+	
+	explicit PoolClientShares(unsigned maxshares = DEFAULT_POOL_CLIENT_SHARES);
+	
+	bool Full(const std::string& client) const;
+	void Add(const std::string& client);
+	void Remove(const std::string& client);
+	
+	unsigned Count(const std::string& client) const;
+	size_t Clients() const { return mShares.size(); }
+	
+private:
+	
+	unsigned mMaxShares;
+	std::map<std::string, unsigned> mShares;
+	
+};
+
+
+
+// Append-only log of the accepted shares in a LevelDB under the data
+// directory. The workers only queue the shares, a thread of the log writes
+// them in batches. The keys are ordered by height, then by arrival.
+class PoolShareLog {
+public:
+	
+	PoolShareLog(size_t nCacheSize);
+	~PoolShareLog();
+	
+	void Append(const PoolShareRecord& record);
+	
+	// Shares from nStartHeight to nEndHeight, at most nMaxCount. Shares still
+	// queued are not returned.
+	void Read(uint32_t nStartHeight, uint32_t nEndHeight, size_t nMaxCount, std::vector<PoolShareRecord>& records);
+	
+private:
+	
+	void ThreadFlush();
+	
+	CDBWrapper mDB;
+	uint64_t mNextSeq;
+	
+	std::mutex cs;
+	std::condition_variable cond;
+	std::vector<PoolShareRecord> mPending;
+	bool mStop;
+	
+	std::thread mThread;
+	
+};
+
 
 
 class PrimeWorker {
 public:
 	
-	PrimeWorker(CWallet* pwallet, unsigned threadid, unsigned target);
+	PrimeWorker(CWallet* pwallet, PoolTemplates* templates, ShareValidator* validator, PoolShareLog* sharelog, unsigned threadid, unsigned target);
+	
+	static std::string GetIdentity(unsigned threadid);
+	static std::string GetShareEndpoint(unsigned threadid);
+	
+	void GetStats(proto::ServerStats& stats);
 	
 	static void InvokeWork(zsock_t *pipe, void *args);
 	
 	static int InvokeInput(zloop_t *wloop, zmq_pollitem_t *item, void* arg);
 	static int InvokeRequest(zloop_t *wloop, zmq_pollitem_t *item, void* arg);
+	static int InvokeShare(zloop_t *wloop, zmq_pollitem_t *item, void* arg);
 	static int InvokeTimerFunc(zloop_t *loop, int timer_id, void *arg);
+	static int InvokeRefreshTimer(zloop_t *loop, int timer_id, void *arg);
 	static int InvokeExitCheck(zloop_t *wloop, zmq_pollitem_t *item, void *arg);
 	
 	zmsg_t* ReceiveRequest(proto::Request& req, zsock_t* socket);
@@ -83,8 +564,17 @@ protected:
 	int HandleInput(zsock_t *item);
 	int HandleBackend(zmq_pollitem_t *item);
 	int HandleRequest(zsock_t *item);
+	int HandleShare(zsock_t *item);
+	
+	void CompleteShare(PoolShare* share);
 	
 	int FlushStats();
+	int RefreshTemplate();
+	
+	uint256 SetExtraNonce(unsigned extraNonce);
+	void UseTemplate(const PoolTemplate* tmpl);
+	void MakeTableRoom();
+	void PruneWorkTemplates();
 	
 	static int CheckVersion(unsigned version);
 	static int CheckReqNonce(const uint256& nonce);
@@ -93,6 +583,9 @@ protected:
 private:
 	
 	CWallet* mWallet;
+	PoolTemplates* mTemplates;
+	ShareValidator* mValidator;
+	PoolShareLog* mShareLog;
 	
 	std::string mHost;
 	std::string mName;
@@ -106,20 +599,33 @@ private:
 	
 	unsigned mCurrHeight;
 	unsigned mExtraNonce;
-	std::map<uint256, unsigned int> mNonceMap;
+	PoolWorkTables mTables;
 	std::shared_ptr<CReserveScript> coinbase_script;
-	std::unique_ptr<CBlockTemplate> mBlockTemplate;
-	CBlockIndex* mIndexPrev;
+	std::shared_ptr<const PoolTemplate> mTemplate;
+	// Templates of the tip by the first extranonce of their works, the works
+	// issued before a refresh stay on the template they were made from
+	std::map<unsigned, std::shared_ptr<const PoolTemplate> > mWorkTemplates;
+	// First extranonces of the older and of the current generation of
+	// mTables, at most those of the works they hold
+	unsigned mNonceGenFirst[2];
+	const PoolTemplate* mBlockTemplate;
+	CBlock mBlock;
+	CMutableTransaction mCoinbase;
+	const CBlockIndex* mIndexPrev;
 	unsigned mWorkerCount;
 	
 	unsigned mReqDiff;
 	unsigned mTarget;
-	std::set<uint256> mReqNonces;
-	std::set<uint256> mShares;
 	std::map<std::pair<std::string,uint64_t>, proto::Data> mStats;
 	std::map<std::pair<int,int>, int> mReqStats;
 	uint64_t mInvCount;
 	
+	PoolClientShares mClientShares;
+	unsigned mSharesQueued;
+	unsigned mSharesChecked;
+	unsigned mSharesBusy;
+	int64_t mShareTime;
+	
 	proto::Signal mSignal;
 	proto::Request mRequest;
 	proto::Reply mReply;
@@ -128,6 +634,9 @@ private:
 	proto::Block mCurrBlock;
 	proto::ServerStats mServerStats;
 	
+	CCriticalSection cs_stats;
+	proto::ServerStats mFlushedStats;
+	
 
 };
 
@@ -136,46 +645,69 @@ private:
 class PoolFrontend {
 public:
 	
-	PoolFrontend(unsigned port);
+	PoolFrontend(unsigned port, unsigned workers);
 	~PoolFrontend();
 	
 	static void InvokeProxy(zsock_t *pipe, void *arg);
 	void ProxyLoop(zsock_t *pipe);
 	
+	unsigned SelectWorker(zframe_t* client) const;
+	
 private:
 	
 	unsigned mPort;
+	unsigned mWorkerCount;
 	
 	zsock_t* mRouter;
-	zsock_t* mDealer;
+	zsock_t* mBackend;
 	zactor_t* mPipe;
 	
 };
 
 
 
-class PoolServer : public PrimeServer {
+class PoolServer : public PrimeServer, public CValidationInterface {
 public:
 	
 	PoolServer(CWallet* pwallet);
 	virtual ~PoolServer();
 	
 	virtual void NotifyNewBlock(CBlockIndex* pindex);
+	virtual UniValue GetStats();
+	virtual UniValue GetShares(unsigned nStartHeight, unsigned nEndHeight, unsigned nMaxCount);
+	
+	void AggregateStats(proto::ServerStats& stats);
 	
 	static void SendSignal(proto::Signal& signal, zsock_t* socket);
 	
 	
+protected:
+	
+	// Called under cs_main once the header and the merkle root of a block on
+	// the tip are checked, before the block is connected
+	void NewPoWValidBlock(const CBlockIndex* pindex, const std::shared_ptr<const CBlock>& block) override;
+	
+	// Called under cs_main with the result of connecting a block
+	void BlockChecked(const CBlock& block, const CValidationState& state) override;
+	
+	void SendNewBlock(const CBlockIndex* pindex);
+	
+	
 private:
 	
 	PoolFrontend* mFrontend;
 	
 	CWallet* mWallet;
+	PoolTemplates mTemplates;
+	ShareValidator* mValidator;
+	PoolShareLog* mShareLog;
 	
 	std::vector<std::pair<PrimeWorker*, zactor_t*> > mWorkers;
 	
 	
 	
 	zsock_t* mWorkerSignals;
+	CCriticalSection cs_signals;
 	
 	int mMinShare;
 	int mTarget;
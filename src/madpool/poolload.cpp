@@ -0,0 +1,483 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Load test of the pool server. Simulated miners connect to the -frontport
+// of a running node, usually on regtest, and send CONNECT, GETWORK, SHARE and
+// STATS requests at the given rates. The shares have a valid header hash but
+// no prime chain, so they take the whole share path and come back INVALID
+// from the validators, or STALE or DUPLICATE before that.
+
+#if defined(HAVE_CONFIG_H)
+#include "config/bitcoin-config.h"
+#endif
+
+#include <zmq.h>
+
+#ifndef WIN32
+#define SOCKET LIBCZMQ_SOCKET
+#endif
+#include <czmq.h>
+#ifndef WIN32
+#undef SOCKET
+#undef INVALID_SOCKET
+#endif
+
+#include "prime/prime.h"
+#include "primitives/block.h"
+#include "random.h"
+#include "uint256.h"
+#include "util.h"
+#include "utiltime.h"
+
+#undef loop
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "protocol.pb.h"
+
+using namespace pool;
+
+
+// Miner protocol version with the merkle root of the work in binary and the
+// BUSY reply
+static const unsigned LOAD_PROTOCOL_VERSION = 12;
+static const int NUM_REQUEST_TYPES = proto::Request::Type_MAX + 1;
+
+static const int DEFAULT_LOAD_PORT = 6666;
+static const int DEFAULT_LOAD_MINERS = 1000;
+static const int DEFAULT_LOAD_THREADS = 4;
+static const int DEFAULT_LOAD_DURATION = 60;
+static const double DEFAULT_LOAD_GETWORK = 0.2;
+static const double DEFAULT_LOAD_SHARES = 1.0;
+static const int DEFAULT_LOAD_STATS = 10;
+static const int DEFAULT_LOAD_DUPLICATES = 1;
+// Replies still missing this long after the end of the test are lost
+static const int64_t LOAD_DRAIN_TIME = 5 * 1000000;
+
+
+// Reply latencies and counts of the miners of a thread
+struct LoadStats {
+
+	uint64_t sent[NUM_REQUEST_TYPES];
+	std::vector<int64_t> latency[NUM_REQUEST_TYPES];
+	std::map<std::pair<int,int>, uint64_t> replies;
+	uint64_t lost;
+
+	LoadStats() : lost(0) {
+		std::fill(sent, sent + NUM_REQUEST_TYPES, 0);
+	}
+
+	void Merge(const LoadStats& other) {
+		for(int i = 0; i < NUM_REQUEST_TYPES; ++i){
+			sent[i] += other.sent[i];
+			latency[i].insert(latency[i].end(), other.latency[i].begin(), other.latency[i].end());
+		}
+		for(std::map<std::pair<int,int>, uint64_t>::const_iterator iter = other.replies.begin(); iter != other.replies.end(); ++iter)
+			replies[iter->first] += iter->second;
+		lost += other.lost;
+	}
+
+};
+
+
+struct LoadMiner {
+
+	zsock_t* socket;
+	uint64_t clientid;
+	std::string name;
+	uint32_t reqid;
+	std::map<uint32_t, std::pair<int,int64_t> > pending;
+
+	// Learned from the block of the replies, like a real miner
+	uint32_t height;
+	uint32_t minshare;
+	uint256 hashPrevBlock;
+
+	bool haswork;
+	uint256 hashMerkleRoot;
+	uint32_t time;
+	uint32_t bits;
+	proto::Share lastshare;
+
+	int64_t nextwork;
+	int64_t nextshare;
+	int64_t nextstats;
+
+};
+
+
+struct LoadParams {
+
+	std::string endpoint;
+	std::string addr;
+	int64_t nEnd;
+	int64_t nWorkInterval;
+	int64_t nShareInterval;
+	int64_t nStatsInterval;
+	int nDuplicates;
+
+};
+
+
+// Request nonce accepted by CheckReqNonce: the product of the first seven
+// limbs plus the last one is zero
+static std::string MakeReqNonce(FastRandomContext& rng) {
+
+	uint32_t limbs[8];
+	uint32_t tmp = 1;
+	for(int i = 0; i < 7; ++i){
+		limbs[i] = rng.rand32() | 1;
+		tmp *= limbs[i];
+	}
+	limbs[7] = -tmp;
+	return std::string((const char*)limbs, sizeof(limbs));
+
+}
+
+static void SendRequest(LoadMiner& miner, proto::Request& req, LoadStats& stats, FastRandomContext& rng) {
+
+	req.set_reqid(++miner.reqid);
+	req.set_version(LOAD_PROTOCOL_VERSION);
+	req.set_height(miner.height);
+	req.set_reqnonce(MakeReqNonce(rng));
+
+	std::string data = req.SerializeAsString();
+	zframe_t* frame = zframe_new(data.data(), data.size());
+	zframe_send(&frame, miner.socket, 0);
+
+	miner.pending[req.reqid()] = std::make_pair((int)req.type(), GetTimeMicros());
+	stats.sent[req.type()]++;
+
+}
+
+static void SendShare(LoadMiner& miner, const LoadParams& params, LoadStats& stats, FastRandomContext& rng) {
+
+	proto::Request req;
+	req.set_type(proto::Request::SHARE);
+	proto::Share* share = req.mutable_share();
+
+	// Resent shares are caught by the duplicate table of the worker
+	if(miner.lastshare.IsInitialized() && miner.lastshare.height() == miner.height && (int)rng.randrange(100) < params.nDuplicates){
+		share->CopyFrom(miner.lastshare);
+		SendRequest(miner, req, stats, rng);
+		return;
+	}
+
+	CBlockHeader header;
+	header.nVersion = 2;
+	header.hashPrevBlock = miner.hashPrevBlock;
+	header.hashMerkleRoot = miner.hashMerkleRoot;
+	header.nTime = miner.time;
+	header.nBits = miner.bits;
+	header.nNonce = rng.rand32();
+	uint256 hashHeader = header.GetHeaderHash();
+
+	unsigned char multi[8];
+	for(unsigned i = 0; i < sizeof(multi); ++i)
+		multi[i] = rng.randbits(8);
+	multi[0] |= 1;
+
+	share->set_addr(params.addr);
+	share->set_name(miner.name);
+	share->set_clientid(miner.clientid);
+	share->set_hash(std::string());
+	share->set_merkle(std::string());
+	share->set_multi(std::string());
+	share->set_hashbin(hashHeader.begin(), hashHeader.size());
+	share->set_merklebin(miner.hashMerkleRoot.begin(), miner.hashMerkleRoot.size());
+	share->set_multibin(multi, sizeof(multi));
+	share->set_time(header.nTime);
+	share->set_bits(header.nBits);
+	share->set_nonce(header.nNonce);
+	share->set_height(miner.height);
+	share->set_length(miner.minshare);
+	share->set_chaintype(rng.randrange(3));
+	share->set_isblock(false);
+
+	miner.lastshare.CopyFrom(*share);
+	SendRequest(miner, req, stats, rng);
+
+}
+
+static void SendStats(LoadMiner& miner, const LoadParams& params, LoadStats& stats, FastRandomContext& rng) {
+
+	proto::Request req;
+	req.set_type(proto::Request::STATS);
+	proto::ClientStats* cstats = req.mutable_stats();
+	cstats->set_addr(params.addr);
+	cstats->set_name(miner.name);
+	cstats->set_clientid(miner.clientid);
+	cstats->set_instanceid(1);
+	cstats->set_version(LOAD_PROTOCOL_VERSION);
+	cstats->set_cpd(1);
+	cstats->set_latency(0);
+	cstats->set_temp(50);
+	cstats->set_errors(0);
+	cstats->set_ngpus(1);
+	cstats->set_height(miner.height);
+
+	SendRequest(miner, req, stats, rng);
+
+}
+
+static void HandleReply(LoadMiner& miner, LoadStats& stats) {
+
+	zmsg_t* msg = zmsg_recv(miner.socket);
+	if(!msg)
+		return;
+
+	zframe_t* frame = zmsg_last(msg);
+	proto::Reply rep;
+	bool ok = frame && rep.ParseFromArray(zframe_data(frame), zframe_size(frame));
+	zmsg_destroy(&msg);
+	if(!ok)
+		return;
+
+	std::map<uint32_t, std::pair<int,int64_t> >::iterator iter = miner.pending.find(rep.reqid());
+	if(iter == miner.pending.end())
+		return;
+	stats.latency[iter->second.first].push_back(GetTimeMicros() - iter->second.second);
+	stats.replies[std::make_pair(iter->second.first, (int)rep.error())]++;
+	miner.pending.erase(iter);
+
+	// The worker sends its block with the replies to an old height
+	if(rep.has_block() && rep.block().height() != miner.height){
+		const proto::Block& block = rep.block();
+		miner.height = block.height();
+		miner.minshare = block.minshare();
+		if(block.hashbin().size() == miner.hashPrevBlock.size())
+			memcpy(miner.hashPrevBlock.begin(), block.hashbin().data(), miner.hashPrevBlock.size());
+		else
+			miner.hashPrevBlock.SetHex(block.hash());
+		miner.haswork = false;
+	}
+
+	if(rep.type() == proto::Request::GETWORK && rep.error() == proto::Reply::NONE && rep.has_work()){
+		const proto::Work& work = rep.work();
+		if(work.merklebin().size() == miner.hashMerkleRoot.size())
+			memcpy(miner.hashMerkleRoot.begin(), work.merklebin().data(), miner.hashMerkleRoot.size());
+		else
+			miner.hashMerkleRoot.SetHex(work.merkle());
+		miner.time = work.time();
+		miner.bits = work.bits();
+		miner.haswork = work.height() == miner.height;
+	}
+
+}
+
+static void ThreadLoad(unsigned nThread, unsigned nMiners, const LoadParams& params, LoadStats& stats) {
+
+	FastRandomContext rng;
+
+	std::vector<LoadMiner> miners(nMiners);
+	std::vector<zmq_pollitem_t> items(nMiners);
+	int64_t nNow = GetTimeMicros();
+	for(unsigned i = 0; i < nMiners; ++i){
+
+		LoadMiner& miner = miners[i];
+		miner.socket = zsock_new(ZMQ_DEALER);
+		zsock_set_linger(miner.socket, 0);
+		zsock_connect(miner.socket, "%s", params.endpoint.c_str());
+		miner.clientid = rng.rand64();
+		miner.name = strprintf("load%u.%u", nThread, i);
+		miner.reqid = 0;
+		miner.height = 0;
+		miner.minshare = 0;
+		miner.haswork = false;
+		miner.time = 0;
+		miner.bits = 0;
+
+		// Random phases, so that the miners do not send in lockstep
+		miner.nextwork = nNow + rng.randrange(params.nWorkInterval);
+		miner.nextshare = nNow + rng.randrange(params.nShareInterval);
+		miner.nextstats = nNow + rng.randrange(params.nStatsInterval);
+
+		items[i].socket = zsock_resolve(miner.socket);
+		items[i].fd = 0;
+		items[i].events = ZMQ_POLLIN;
+		items[i].revents = 0;
+
+		proto::Request req;
+		req.set_type(proto::Request::CONNECT);
+		SendRequest(miner, req, stats, rng);
+
+	}
+
+	int64_t nDrainEnd = params.nEnd + LOAD_DRAIN_TIME;
+	while(true){
+
+		nNow = GetTimeMicros();
+		bool fSending = nNow < params.nEnd;
+		bool fPending = false;
+		for(unsigned i = 0; i < nMiners && !fPending; ++i)
+			fPending = !miners[i].pending.empty();
+		if(!fSending && (!fPending || nNow >= nDrainEnd))
+			break;
+
+		if(zmq_poll(items.data(), items.size(), 1) < 0){
+			if(zmq_errno() == EINTR)
+				continue;
+			break;
+		}
+
+		for(unsigned i = 0; i < nMiners; ++i)
+			if(items[i].revents & ZMQ_POLLIN)
+				HandleReply(miners[i], stats);
+
+		if(!fSending)
+			continue;
+
+		nNow = GetTimeMicros();
+		for(unsigned i = 0; i < nMiners; ++i){
+
+			LoadMiner& miner = miners[i];
+			if(nNow >= miner.nextwork){
+				proto::Request req;
+				req.set_type(proto::Request::GETWORK);
+				SendRequest(miner, req, stats, rng);
+				miner.nextwork += params.nWorkInterval;
+			}
+			if(nNow >= miner.nextshare){
+				if(miner.haswork)
+					SendShare(miner, params, stats, rng);
+				miner.nextshare += params.nShareInterval;
+			}
+			if(nNow >= miner.nextstats){
+				SendStats(miner, params, stats, rng);
+				miner.nextstats += params.nStatsInterval;
+			}
+
+		}
+
+	}
+
+	for(unsigned i = 0; i < nMiners; ++i){
+		stats.lost += miners[i].pending.size();
+		zsock_destroy(&miners[i].socket);
+	}
+
+}
+
+
+static int64_t Percentile(const std::vector<int64_t>& sorted, unsigned p) {
+
+	if(sorted.empty())
+		return 0;
+	return sorted[std::min(sorted.size() - 1, sorted.size() * p / 100)];
+
+}
+
+static void PrintReport(LoadStats& stats, int64_t nDuration) {
+
+	printf("%-10s %10s %10s %10s %10s %10s\n", "request", "sent", "replies", "per sec", "p50 ms", "p99 ms");
+	for(int type = 0; type < NUM_REQUEST_TYPES; ++type){
+
+		if(!stats.sent[type])
+			continue;
+		std::vector<int64_t>& latency = stats.latency[type];
+		std::sort(latency.begin(), latency.end());
+		printf("%-10s %10lu %10lu %10.1f %10.2f %10.2f\n",
+				proto::Request::Type_Name((proto::Request::Type)type).c_str(),
+				(unsigned long)stats.sent[type], (unsigned long)latency.size(),
+				latency.size() * 1e6 / nDuration,
+				Percentile(latency, 50) / 1000.0, Percentile(latency, 99) / 1000.0);
+
+	}
+
+	printf("\n%-10s %-10s %10s %10s\n", "request", "error", "replies", "rate %");
+	for(std::map<std::pair<int,int>, uint64_t>::const_iterator iter = stats.replies.begin(); iter != stats.replies.end(); ++iter){
+
+		size_t nReplies = stats.latency[iter->first.first].size();
+		printf("%-10s %-10s %10lu %10.2f\n",
+				proto::Request::Type_Name((proto::Request::Type)iter->first.first).c_str(),
+				proto::Reply::ErrType_Name((proto::Reply::ErrType)iter->first.second).c_str(),
+				(unsigned long)iter->second, nReplies ? 100.0 * iter->second / nReplies : 0.0);
+
+	}
+
+	printf("\nlost requests: %lu\n", (unsigned long)stats.lost);
+
+}
+
+
+static std::string HelpMessageLoad() {
+
+	std::string strUsage;
+	strUsage += HelpMessageGroup("Options:");
+	strUsage += HelpMessageOpt("-?", "This help message");
+	strUsage += HelpMessageOpt("-host=<ip>", "Host of the pool server (default: 127.0.0.1)");
+	strUsage += HelpMessageOpt("-port=<port>", strprintf("-frontport of the pool server (default: %d)", DEFAULT_LOAD_PORT));
+	strUsage += HelpMessageOpt("-miners=<n>", strprintf("Number of simulated miners (default: %d)", DEFAULT_LOAD_MINERS));
+	strUsage += HelpMessageOpt("-threads=<n>", strprintf("Threads running the miners (default: %d)", DEFAULT_LOAD_THREADS));
+	strUsage += HelpMessageOpt("-duration=<n>", strprintf("Seconds of load (default: %d)", DEFAULT_LOAD_DURATION));
+	strUsage += HelpMessageOpt("-getwork=<x>", strprintf("GETWORK requests per second of a miner (default: %.1f)", DEFAULT_LOAD_GETWORK));
+	strUsage += HelpMessageOpt("-shares=<x>", strprintf("SHARE requests per second of a miner (default: %.1f)", DEFAULT_LOAD_SHARES));
+	strUsage += HelpMessageOpt("-stats=<n>", strprintf("Seconds between the STATS requests of a miner (default: %d)", DEFAULT_LOAD_STATS));
+	strUsage += HelpMessageOpt("-duplicates=<n>", strprintf("Percentage of the shares sent again (default: %d)", DEFAULT_LOAD_DUPLICATES));
+	strUsage += HelpMessageOpt("-addr=<address>", "Payout address sent with the shares");
+	return strUsage;
+
+}
+
+static int64_t RateToInterval(double rate) {
+
+	return rate > 0 ? std::max((int64_t)(1e6 / rate), (int64_t)1) : std::numeric_limits<int64_t>::max() / 2;
+
+}
+
+
+int main(int argc, char* argv[]) {
+
+	SetupEnvironment();
+	gArgs.ParseParameters(argc, argv);
+	if(gArgs.IsArgSet("-?") || gArgs.IsArgSet("-h") || gArgs.IsArgSet("-help")){
+		printf("Usage: datacoin-poolload [options]\n\n"
+				"Start datacoind -regtest with the pool server, then run this to\n"
+				"load its -frontport. Mine regtest blocks meanwhile to see stale shares.\n\n%s",
+				HelpMessageLoad().c_str());
+		return 0;
+	}
+
+	int nMiners = std::max((int)gArgs.GetArg("-miners", DEFAULT_LOAD_MINERS), 1);
+	int nThreads = std::max(std::min((int)gArgs.GetArg("-threads", DEFAULT_LOAD_THREADS), nMiners), 1);
+	int64_t nDuration = std::max((int)gArgs.GetArg("-duration", DEFAULT_LOAD_DURATION), 1) * (int64_t)1000000;
+
+	LoadParams params;
+	params.endpoint = strprintf("tcp://%s:%d", gArgs.GetArg("-host", "127.0.0.1"), (int)gArgs.GetArg("-port", DEFAULT_LOAD_PORT));
+	params.addr = gArgs.GetArg("-addr", "");
+	params.nWorkInterval = RateToInterval(atof(gArgs.GetArg("-getwork", strprintf("%f", DEFAULT_LOAD_GETWORK)).c_str()));
+	params.nShareInterval = RateToInterval(atof(gArgs.GetArg("-shares", strprintf("%f", DEFAULT_LOAD_SHARES)).c_str()));
+	params.nStatsInterval = std::max((int)gArgs.GetArg("-stats", DEFAULT_LOAD_STATS), 1) * (int64_t)1000000;
+	params.nDuplicates = std::max(std::min((int)gArgs.GetArg("-duplicates", DEFAULT_LOAD_DUPLICATES), 100), 0);
+
+	// Each miner has its own socket
+	zsys_init();
+	zsys_set_max_sockets(nMiners + 16);
+
+	printf("%d miners on %d threads against %s for %d s\n\n", nMiners, nThreads, params.endpoint.c_str(), (int)(nDuration / 1000000));
+
+	params.nEnd = GetTimeMicros() + nDuration;
+	std::vector<LoadStats> stats(nThreads);
+	std::vector<std::thread> threads;
+	for(int i = 0; i < nThreads; ++i)
+		threads.push_back(std::thread(&ThreadLoad, i, nMiners / nThreads + (i < nMiners % nThreads), std::cref(params), std::ref(stats[i])));
+
+	LoadStats total;
+	for(int i = 0; i < nThreads; ++i){
+		threads[i].join();
+		total.Merge(stats[i]);
+	}
+
+	PrintReport(total, nDuration);
+
+	zsys_shutdown();
+	return 0;
+
+}
@@ -13,6 +13,8 @@
 
 PrimeServer* gPrimeServer = 0;
 
+CCriticalSection cs_primeserver;
+
 
 
 
@@ -11,6 +11,9 @@
 
 #include "wallet/wallet.h"
 #include "chain.h"
+#include "sync.h"
+
+#include <univalue.h>
 //#include "main.hpp"
 
 
@@ -27,6 +30,10 @@ public:
 	
 	virtual void NotifyNewBlock(CBlockIndex* pindex) = 0;
 	
+	virtual UniValue GetStats() = 0;
+	
+	virtual UniValue GetShares(unsigned nStartHeight, unsigned nEndHeight, unsigned nMaxCount) = 0;
+	
 	
 	
 	
@@ -37,6 +44,9 @@ public:
 
 extern PrimeServer* gPrimeServer;
 
+// Held while gPrimeServer is created or deleted and by the RPC calls using it
+extern CCriticalSection cs_primeserver;
+
 
 
 
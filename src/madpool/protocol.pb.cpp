@@ -68,12 +68,14 @@ void protobuf_AssignDesc_protocol_2eproto() {
       "protocol.proto");
   GOOGLE_CHECK(file != NULL);
   Block_descriptor_ = file->message_type(0);
-  static const int Block_offsets_[5] = {
+  static const int Block_offsets_[7] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Block, height_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Block, hash_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Block, prevhash_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Block, reqdiff_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Block, minshare_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Block, hashbin_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Block, prevhashbin_),
   };
   Block_reflection_ =
     new ::google::protobuf::internal::GeneratedMessageReflection(
@@ -129,7 +131,7 @@ void protobuf_AssignDesc_protocol_2eproto() {
       ::google::protobuf::MessageFactory::generated_factory(),
       sizeof(ClientStats));
   Share_descriptor_ = file->message_type(3);
-  static const int Share_offsets_[16] = {
+  static const int Share_offsets_[20] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Share, addr_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Share, name_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Share, clientid_),
@@ -146,6 +148,10 @@ void protobuf_AssignDesc_protocol_2eproto() {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Share, chaintype_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Share, isblock_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Share, genvalue_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Share, hashbin_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Share, merklebin_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Share, multibin_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Share, blockhashbin_),
   };
   Share_reflection_ =
     new ::google::protobuf::internal::GeneratedMessageReflection(
@@ -199,11 +205,12 @@ void protobuf_AssignDesc_protocol_2eproto() {
       ::google::protobuf::MessageFactory::generated_factory(),
       sizeof(ServerInfo));
   Work_descriptor_ = file->message_type(6);
-  static const int Work_offsets_[4] = {
+  static const int Work_offsets_[5] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Work, height_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Work, merkle_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Work, time_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Work, bits_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Work, merklebin_),
   };
   Work_reflection_ =
     new ::google::protobuf::internal::GeneratedMessageReflection(
@@ -256,12 +263,17 @@ void protobuf_AssignDesc_protocol_2eproto() {
       ::google::protobuf::MessageFactory::generated_factory(),
       sizeof(ReqStats));
   ServerStats_descriptor_ = file->message_type(9);
-  static const int ServerStats_offsets_[6] = {
+  static const int ServerStats_offsets_[11] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(ServerStats, name_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(ServerStats, thread_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(ServerStats, workers_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(ServerStats, latency_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(ServerStats, cpd_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(ServerStats, sharequeue_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(ServerStats, sharelatency_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(ServerStats, shares_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(ServerStats, tablemem_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(ServerStats, sharesbusy_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(ServerStats, reqstats_),
   };
   ServerStats_reflection_ =
@@ -362,52 +374,58 @@ void protobuf_AddDesc_protocol_2eproto() {
   GOOGLE_PROTOBUF_VERIFY_VERSION;
 
   ::google::protobuf::DescriptorPool::InternalAddGeneratedFile(
-    "\n\016protocol.proto\022\npool.proto\"Z\n\005Block\022\016\n"
-    "\006height\030\001 \002(\r\022\014\n\004hash\030\002 \002(\t\022\020\n\010prevhash\030"
-    "\003 \002(\t\022\017\n\007reqdiff\030\004 \002(\r\022\020\n\010minshare\030\005 \002(\r"
-    "\"u\n\006Signal\022%\n\004type\030\001 \002(\0162\027.pool.proto.Si"
-    "gnal.Type\022 \n\005block\030\002 \001(\0132\021.pool.proto.Bl"
-    "ock\"\"\n\004Type\022\014\n\010NEWBLOCK\020\001\022\014\n\010SHUTDOWN\020\002\""
-    "\273\001\n\013ClientStats\022\014\n\004addr\030\001 \002(\t\022\014\n\004name\030\002 "
-    "\002(\t\022\020\n\010clientid\030\003 \002(\006\022\022\n\ninstanceid\030\004 \002("
-    "\006\022\017\n\007version\030\n \002(\r\022\013\n\003cpd\030\013 \002(\002\022\017\n\007laten"
-    "cy\030\014 \002(\r\022\014\n\004temp\030\r \002(\r\022\016\n\006errors\030\016 \002(\r\022\r"
-    "\n\005ngpus\030\017 \002(\r\022\016\n\006height\030\020 \002(\r\"\205\002\n\005Share\022"
-    "\014\n\004addr\030\001 \002(\t\022\014\n\004name\030\002 \002(\t\022\020\n\010clientid\030"
-    "\003 \002(\006\022\r\n\005gpuid\030\004 \001(\r\022\014\n\004hash\030\n \002(\t\022\016\n\006me"
-    "rkle\030\013 \002(\t\022\014\n\004time\030\014 \002(\r\022\014\n\004bits\030\r \002(\r\022\r"
-    "\n\005nonce\030\016 \002(\r\022\r\n\005multi\030\017 \002(\t\022\021\n\tblockhas"
-    "h\030\020 \001(\t\022\016\n\006height\030\024 \002(\r\022\016\n\006length\030\025 \002(\r\022"
-    "\021\n\tchaintype\030\026 \002(\r\022\017\n\007isblock\030\027 \002(\010\022\020\n\010g"
-    "envalue\030\030 \001(\004\"\211\002\n\007Request\022&\n\004type\030\001 \002(\0162"
-    "\030.pool.proto.Request.Type\022\r\n\005reqid\030\002 \002(\r"
-    "\022\017\n\007version\030\n \001(\r\022\016\n\006height\030\013 \001(\r\022\020\n\010req"
-    "nonce\030\014 \001(\014\022 \n\005share\030\024 \001(\0132\021.pool.proto."
-    "Share\022&\n\005stats\030\025 \001(\0132\027.pool.proto.Client"
-    "Stats\"J\n\004Type\022\010\n\004NONE\020\000\022\013\n\007CONNECT\020\001\022\013\n\007"
-    "GETWORK\020\002\022\t\n\005SHARE\020\003\022\t\n\005STATS\020\004\022\010\n\004PING\020"
-    "\005\"G\n\nServerInfo\022\014\n\004host\030\001 \002(\t\022\016\n\006router\030"
-    "\002 \002(\r\022\013\n\003pub\030\003 \002(\r\022\016\n\006target\030\004 \002(\r\"B\n\004Wo"
-    "rk\022\016\n\006height\030\001 \002(\r\022\016\n\006merkle\030\002 \002(\t\022\014\n\004ti"
-    "me\030\003 \002(\r\022\014\n\004bits\030\004 \002(\r\"\304\002\n\005Reply\022&\n\004type"
-    "\030\001 \002(\0162\030.pool.proto.Request.Type\022\r\n\005reqi"
-    "d\030\002 \002(\r\022(\n\005error\030\n \002(\0162\031.pool.proto.Repl"
-    "y.ErrType\022\016\n\006errstr\030\013 \001(\t\022%\n\005sinfo\030\024 \001(\013"
-    "2\026.pool.proto.ServerInfo\022\036\n\004work\030\025 \001(\0132\020"
-    ".pool.proto.Work\022 \n\005block\030\026 \001(\0132\021.pool.p"
-    "roto.Block\"a\n\007ErrType\022\010\n\004NONE\020\000\022\013\n\007VERSI"
-    "ON\020\001\022\n\n\006HEIGHT\020\002\022\014\n\010REQNONCE\020\003\022\t\n\005STALE\020"
-    "\004\022\013\n\007INVALID\020\005\022\r\n\tDUPLICATE\020\006\"p\n\010ReqStat"
-    "s\022)\n\007reqtype\030\001 \002(\0162\030.pool.proto.Request."
-    "Type\022*\n\007errtype\030\002 \002(\0162\031.pool.proto.Reply"
-    ".ErrType\022\r\n\005count\030\003 \002(\r\"\202\001\n\013ServerStats\022"
-    "\014\n\004name\030\001 \002(\t\022\016\n\006thread\030\002 \002(\r\022\017\n\007workers"
-    "\030\n \002(\r\022\017\n\007latency\030\013 \002(\r\022\013\n\003cpd\030\014 \002(\002\022&\n\010"
+    "\n\016protocol.proto\022\npool.proto\"\200\001\n\005Block\022\016"
+    "\n\006height\030\001 \002(\r\022\014\n\004hash\030\002 \002(\t\022\020\n\010prevhash"
+    "\030\003 \002(\t\022\017\n\007reqdiff\030\004 \002(\r\022\020\n\010minshare\030\005 \002("
+    "\r\022\017\n\007hashbin\030\006 \001(\014\022\023\n\013prevhashbin\030\007 \001(\014\""
+    "u\n\006Signal\022%\n\004type\030\001 \002(\0162\027.pool.proto.Sig"
+    "nal.Type\022 \n\005block\030\002 \001(\0132\021.pool.proto.Blo"
+    "ck\"\"\n\004Type\022\014\n\010NEWBLOCK\020\001\022\014\n\010SHUTDOWN\020\002\"\273"
+    "\001\n\013ClientStats\022\014\n\004addr\030\001 \002(\t\022\014\n\004name\030\002 \002"
+    "(\t\022\020\n\010clientid\030\003 \002(\006\022\022\n\ninstanceid\030\004 \002(\006"
+    "\022\017\n\007version\030\n \002(\r\022\013\n\003cpd\030\013 \002(\002\022\017\n\007latenc"
+    "y\030\014 \002(\r\022\014\n\004temp\030\r \002(\r\022\016\n\006errors\030\016 \002(\r\022\r\n"
+    "\005ngpus\030\017 \002(\r\022\016\n\006height\030\020 \002(\r\"\321\002\n\005Share\022\014"
+    "\n\004addr\030\001 \002(\t\022\014\n\004name\030\002 \002(\t\022\020\n\010clientid\030\003"
+    " \002(\006\022\r\n\005gpuid\030\004 \001(\r\022\014\n\004hash\030\n \002(\t\022\016\n\006mer"
+    "kle\030\013 \002(\t\022\014\n\004time\030\014 \002(\r\022\014\n\004bits\030\r \002(\r\022\r\n"
+    "\005nonce\030\016 \002(\r\022\r\n\005multi\030\017 \002(\t\022\021\n\tblockhash"
+    "\030\020 \001(\t\022\016\n\006height\030\024 \002(\r\022\016\n\006length\030\025 \002(\r\022\021"
+    "\n\tchaintype\030\026 \002(\r\022\017\n\007isblock\030\027 \002(\010\022\020\n\010ge"
+    "nvalue\030\030 \001(\004\022\017\n\007hashbin\030\036 \001(\014\022\021\n\tmerkleb"
+    "in\030\037 \001(\014\022\020\n\010multibin\030  \001(\014\022\024\n\014blockhashb"
+    "in\030! \001(\014\"\211\002\n\007Request\022&\n\004type\030\001 \002(\0162\030.poo"
+    "l.proto.Request.Type\022\r\n\005reqid\030\002 \002(\r\022\017\n\007v"
+    "ersion\030\n \001(\r\022\016\n\006height\030\013 \001(\r\022\020\n\010reqnonce"
+    "\030\014 \001(\014\022 \n\005share\030\024 \001(\0132\021.pool.proto.Share"
+    "\022&\n\005stats\030\025 \001(\0132\027.pool.proto.ClientStats"
+    "\"J\n\004Type\022\010\n\004NONE\020\000\022\013\n\007CONNECT\020\001\022\013\n\007GETWO"
+    "RK\020\002\022\t\n\005SHARE\020\003\022\t\n\005STATS\020\004\022\010\n\004PING\020\005\"G\n\n"
+    "ServerInfo\022\014\n\004host\030\001 \002(\t\022\016\n\006router\030\002 \002(\r"
+    "\022\013\n\003pub\030\003 \002(\r\022\016\n\006target\030\004 \002(\r\"U\n\004Work\022\016\n"
+    "\006height\030\001 \002(\r\022\016\n\006merkle\030\002 \002(\t\022\014\n\004time\030\003 "
+    "\002(\r\022\014\n\004bits\030\004 \002(\r\022\021\n\tmerklebin\030\005 \001(\014\"\316\002\n"
+    "\005Reply\022&\n\004type\030\001 \002(\0162\030.pool.proto.Reques"
+    "t.Type\022\r\n\005reqid\030\002 \002(\r\022(\n\005error\030\n \002(\0162\031.p"
+    "ool.proto.Reply.ErrType\022\016\n\006errstr\030\013 \001(\t\022"
+    "%\n\005sinfo\030\024 \001(\0132\026.pool.proto.ServerInfo\022\036"
+    "\n\004work\030\025 \001(\0132\020.pool.proto.Work\022 \n\005block\030"
+    "\026 \001(\0132\021.pool.proto.Block\"k\n\007ErrType\022\010\n\004N"
+    "ONE\020\000\022\013\n\007VERSION\020\001\022\n\n\006HEIGHT\020\002\022\014\n\010REQNON"
+    "CE\020\003\022\t\n\005STALE\020\004\022\013\n\007INVALID\020\005\022\r\n\tDUPLICAT"
+    "E\020\006\022\010\n\004BUSY\020\007\"p\n\010ReqStats\022)\n\007reqtype\030\001 \002"
+    "(\0162\030.pool.proto.Request.Type\022*\n\007errtype\030"
+    "\002 \002(\0162\031.pool.proto.Reply.ErrType\022\r\n\005coun"
+    "t\030\003 \002(\r\"\342\001\n\013ServerStats\022\014\n\004name\030\001 \002(\t\022\016\n"
+    "\006thread\030\002 \002(\r\022\017\n\007workers\030\n \002(\r\022\017\n\007latenc"
+    "y\030\013 \002(\r\022\013\n\003cpd\030\014 \002(\002\022\022\n\nsharequeue\030\r \001(\r"
+    "\022\024\n\014sharelatency\030\016 \001(\r\022\016\n\006shares\030\017 \001(\r\022\020"
+    "\n\010tablemem\030\020 \001(\r\022\022\n\nsharesbusy\030\021 \001(\r\022&\n\010"
     "reqstats\030\024 \003(\0132\024.pool.proto.ReqStats\"\204\001\n"
     "\004Data\022 \n\005share\030\001 \001(\0132\021.pool.proto.Share\022"
     ",\n\013clientstats\030\002 \001(\0132\027.pool.proto.Client"
     "Stats\022,\n\013serverstats\030\003 \001(\0132\027.pool.proto."
-    "ServerStats", 1811);
+    "ServerStats", 2051);
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
     "protocol.proto", &protobuf_RegisterTypes);
   Block::default_instance_ = new Block();
@@ -450,6 +468,8 @@ const int Block::kHashFieldNumber;
 const int Block::kPrevhashFieldNumber;
 const int Block::kReqdiffFieldNumber;
 const int Block::kMinshareFieldNumber;
+const int Block::kHashbinFieldNumber;
+const int Block::kPrevhashbinFieldNumber;
 #endif  // !_MSC_VER
 
 Block::Block()
@@ -476,6 +496,8 @@ void Block::SharedCtor() {
   prevhash_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   reqdiff_ = 0u;
   minshare_ = 0u;
+  hashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  prevhashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -491,6 +513,12 @@ void Block::SharedDtor() {
   if (prevhash_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
     delete prevhash_;
   }
+  if (hashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete hashbin_;
+  }
+  if (prevhashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete prevhashbin_;
+  }
   if (this != default_instance_) {
   }
 }
@@ -527,7 +555,7 @@ void Block::Clear() {
     ::memset(&first, 0, n);                                \
   } while (0)
 
-  if (_has_bits_[0 / 32] & 31) {
+  if (_has_bits_[0 / 32] & 127) {
     ZR_(height_, reqdiff_);
     if (has_hash()) {
       if (hash_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
@@ -540,6 +568,16 @@ void Block::Clear() {
       }
     }
     minshare_ = 0u;
+    if (has_hashbin()) {
+      if (hashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+        hashbin_->clear();
+      }
+    }
+    if (has_prevhashbin()) {
+      if (prevhashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+        prevhashbin_->clear();
+      }
+    }
   }
 
 #undef OFFSET_OF_FIELD_
@@ -633,6 +671,32 @@ bool Block::MergePartialFromCodedStream(
         } else {
           goto handle_unusual;
         }
+        if (input->ExpectTag(50)) goto parse_hashbin;
+        break;
+      }
+
+      // optional bytes hashbin = 6;
+      case 6: {
+        if (tag == 50) {
+         parse_hashbin:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_hashbin()));
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectTag(58)) goto parse_prevhashbin;
+        break;
+      }
+
+      // optional bytes prevhashbin = 7;
+      case 7: {
+        if (tag == 58) {
+         parse_prevhashbin:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_prevhashbin()));
+        } else {
+          goto handle_unusual;
+        }
         if (input->ExpectAtEnd()) goto success;
         break;
       }
@@ -697,6 +761,18 @@ void Block::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteUInt32(5, this->minshare(), output);
   }
 
+  // optional bytes hashbin = 6;
+  if (has_hashbin()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytesMaybeAliased(
+      6, this->hashbin(), output);
+  }
+
+  // optional bytes prevhashbin = 7;
+  if (has_prevhashbin()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytesMaybeAliased(
+      7, this->prevhashbin(), output);
+  }
+
   if (!unknown_fields().empty()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         unknown_fields(), output);
@@ -744,6 +820,20 @@ void Block::SerializeWithCachedSizes(
     target = ::google::protobuf::internal::WireFormatLite::WriteUInt32ToArray(5, this->minshare(), target);
   }
 
+  // optional bytes hashbin = 6;
+  if (has_hashbin()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        6, this->hashbin(), target);
+  }
+
+  // optional bytes prevhashbin = 7;
+  if (has_prevhashbin()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        7, this->prevhashbin(), target);
+  }
+
   if (!unknown_fields().empty()) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         unknown_fields(), target);
@@ -791,6 +881,20 @@ int Block::ByteSize() const {
           this->minshare());
     }
 
+    // optional bytes hashbin = 6;
+    if (has_hashbin()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->hashbin());
+    }
+
+    // optional bytes prevhashbin = 7;
+    if (has_prevhashbin()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->prevhashbin());
+    }
+
   }
   if (!unknown_fields().empty()) {
     total_size +=
@@ -833,6 +937,12 @@ void Block::MergeFrom(const Block& from) {
     if (from.has_minshare()) {
       set_minshare(from.minshare());
     }
+    if (from.has_hashbin()) {
+      set_hashbin(from.hashbin());
+    }
+    if (from.has_prevhashbin()) {
+      set_prevhashbin(from.prevhashbin());
+    }
   }
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
 }
@@ -862,6 +972,8 @@ void Block::Swap(Block* other) {
     std::swap(prevhash_, other->prevhash_);
     std::swap(reqdiff_, other->reqdiff_);
     std::swap(minshare_, other->minshare_);
+    std::swap(hashbin_, other->hashbin_);
+    std::swap(prevhashbin_, other->prevhashbin_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
     std::swap(_cached_size_, other->_cached_size_);
@@ -1856,6 +1968,10 @@ const int Share::kLengthFieldNumber;
 const int Share::kChaintypeFieldNumber;
 const int Share::kIsblockFieldNumber;
 const int Share::kGenvalueFieldNumber;
+const int Share::kHashbinFieldNumber;
+const int Share::kMerklebinFieldNumber;
+const int Share::kMultibinFieldNumber;
+const int Share::kBlockhashbinFieldNumber;
 #endif  // !_MSC_VER
 
 Share::Share()
@@ -1893,6 +2009,10 @@ void Share::SharedCtor() {
   chaintype_ = 0u;
   isblock_ = false;
   genvalue_ = GOOGLE_ULONGLONG(0);
+  hashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  merklebin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  multibin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  blockhashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -1920,6 +2040,18 @@ void Share::SharedDtor() {
   if (blockhash_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
     delete blockhash_;
   }
+  if (hashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete hashbin_;
+  }
+  if (merklebin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete merklebin_;
+  }
+  if (multibin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete multibin_;
+  }
+  if (blockhashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete blockhashbin_;
+  }
   if (this != default_instance_) {
   }
 }
@@ -1995,6 +2127,28 @@ void Share::Clear() {
       }
     }
   }
+  if (_has_bits_[16 / 32] & 983040) {
+    if (has_hashbin()) {
+      if (hashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+        hashbin_->clear();
+      }
+    }
+    if (has_merklebin()) {
+      if (merklebin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+        merklebin_->clear();
+      }
+    }
+    if (has_multibin()) {
+      if (multibin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+        multibin_->clear();
+      }
+    }
+    if (has_blockhashbin()) {
+      if (blockhashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+        blockhashbin_->clear();
+      }
+    }
+  }
 
 #undef OFFSET_OF_FIELD_
 #undef ZR_
@@ -2260,6 +2414,58 @@ bool Share::MergePartialFromCodedStream(
         } else {
           goto handle_unusual;
         }
+        if (input->ExpectTag(242)) goto parse_hashbin;
+        break;
+      }
+
+      // optional bytes hashbin = 30;
+      case 30: {
+        if (tag == 242) {
+         parse_hashbin:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_hashbin()));
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectTag(250)) goto parse_merklebin;
+        break;
+      }
+
+      // optional bytes merklebin = 31;
+      case 31: {
+        if (tag == 250) {
+         parse_merklebin:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_merklebin()));
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectTag(258)) goto parse_multibin;
+        break;
+      }
+
+      // optional bytes multibin = 32;
+      case 32: {
+        if (tag == 258) {
+         parse_multibin:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_multibin()));
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectTag(266)) goto parse_blockhashbin;
+        break;
+      }
+
+      // optional bytes blockhashbin = 33;
+      case 33: {
+        if (tag == 266) {
+         parse_blockhashbin:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_blockhashbin()));
+        } else {
+          goto handle_unusual;
+        }
         if (input->ExpectAtEnd()) goto success;
         break;
       }
@@ -2399,6 +2605,30 @@ void Share::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteUInt64(24, this->genvalue(), output);
   }
 
+  // optional bytes hashbin = 30;
+  if (has_hashbin()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytesMaybeAliased(
+      30, this->hashbin(), output);
+  }
+
+  // optional bytes merklebin = 31;
+  if (has_merklebin()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytesMaybeAliased(
+      31, this->merklebin(), output);
+  }
+
+  // optional bytes multibin = 32;
+  if (has_multibin()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytesMaybeAliased(
+      32, this->multibin(), output);
+  }
+
+  // optional bytes blockhashbin = 33;
+  if (has_blockhashbin()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytesMaybeAliased(
+      33, this->blockhashbin(), output);
+  }
+
   if (!unknown_fields().empty()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         unknown_fields(), output);
@@ -2525,6 +2755,34 @@ void Share::SerializeWithCachedSizes(
     target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(24, this->genvalue(), target);
   }
 
+  // optional bytes hashbin = 30;
+  if (has_hashbin()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        30, this->hashbin(), target);
+  }
+
+  // optional bytes merklebin = 31;
+  if (has_merklebin()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        31, this->merklebin(), target);
+  }
+
+  // optional bytes multibin = 32;
+  if (has_multibin()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        32, this->multibin(), target);
+  }
+
+  // optional bytes blockhashbin = 33;
+  if (has_blockhashbin()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        33, this->blockhashbin(), target);
+  }
+
   if (!unknown_fields().empty()) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         unknown_fields(), target);
@@ -2647,6 +2905,36 @@ int Share::ByteSize() const {
           this->genvalue());
     }
 
+  }
+  if (_has_bits_[16 / 32] & (0xffu << (16 % 32))) {
+    // optional bytes hashbin = 30;
+    if (has_hashbin()) {
+      total_size += 2 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->hashbin());
+    }
+
+    // optional bytes merklebin = 31;
+    if (has_merklebin()) {
+      total_size += 2 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->merklebin());
+    }
+
+    // optional bytes multibin = 32;
+    if (has_multibin()) {
+      total_size += 2 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->multibin());
+    }
+
+    // optional bytes blockhashbin = 33;
+    if (has_blockhashbin()) {
+      total_size += 2 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->blockhashbin());
+    }
+
   }
   if (!unknown_fields().empty()) {
     total_size +=
@@ -2725,6 +3013,20 @@ void Share::MergeFrom(const Share& from) {
       set_genvalue(from.genvalue());
     }
   }
+  if (from._has_bits_[16 / 32] & (0xffu << (16 % 32))) {
+    if (from.has_hashbin()) {
+      set_hashbin(from.hashbin());
+    }
+    if (from.has_merklebin()) {
+      set_merklebin(from.merklebin());
+    }
+    if (from.has_multibin()) {
+      set_multibin(from.multibin());
+    }
+    if (from.has_blockhashbin()) {
+      set_blockhashbin(from.blockhashbin());
+    }
+  }
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
 }
 
@@ -2764,6 +3066,10 @@ void Share::Swap(Share* other) {
     std::swap(chaintype_, other->chaintype_);
     std::swap(isblock_, other->isblock_);
     std::swap(genvalue_, other->genvalue_);
+    std::swap(hashbin_, other->hashbin_);
+    std::swap(merklebin_, other->merklebin_);
+    std::swap(multibin_, other->multibin_);
+    std::swap(blockhashbin_, other->blockhashbin_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
     std::swap(_cached_size_, other->_cached_size_);
@@ -3691,6 +3997,7 @@ const int Work::kHeightFieldNumber;
 const int Work::kMerkleFieldNumber;
 const int Work::kTimeFieldNumber;
 const int Work::kBitsFieldNumber;
+const int Work::kMerklebinFieldNumber;
 #endif  // !_MSC_VER
 
 Work::Work()
@@ -3716,6 +4023,7 @@ void Work::SharedCtor() {
   merkle_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   time_ = 0u;
   bits_ = 0u;
+  merklebin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -3728,6 +4036,9 @@ void Work::SharedDtor() {
   if (merkle_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
     delete merkle_;
   }
+  if (merklebin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete merklebin_;
+  }
   if (this != default_instance_) {
   }
 }
@@ -3764,13 +4075,18 @@ void Work::Clear() {
     ::memset(&first, 0, n);                                \
   } while (0)
 
-  if (_has_bits_[0 / 32] & 15) {
+  if (_has_bits_[0 / 32] & 31) {
     ZR_(height_, bits_);
     if (has_merkle()) {
       if (merkle_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
         merkle_->clear();
       }
     }
+    if (has_merklebin()) {
+      if (merklebin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+        merklebin_->clear();
+      }
+    }
   }
 
 #undef OFFSET_OF_FIELD_
@@ -3847,6 +4163,19 @@ bool Work::MergePartialFromCodedStream(
         } else {
           goto handle_unusual;
         }
+        if (input->ExpectTag(42)) goto parse_merklebin;
+        break;
+      }
+
+      // optional bytes merklebin = 5;
+      case 5: {
+        if (tag == 42) {
+         parse_merklebin:
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_merklebin()));
+        } else {
+          goto handle_unusual;
+        }
         if (input->ExpectAtEnd()) goto success;
         break;
       }
@@ -3901,6 +4230,12 @@ void Work::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteUInt32(4, this->bits(), output);
   }
 
+  // optional bytes merklebin = 5;
+  if (has_merklebin()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytesMaybeAliased(
+      5, this->merklebin(), output);
+  }
+
   if (!unknown_fields().empty()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         unknown_fields(), output);
@@ -3937,6 +4272,13 @@ void Work::SerializeWithCachedSizes(
     target = ::google::protobuf::internal::WireFormatLite::WriteUInt32ToArray(4, this->bits(), target);
   }
 
+  // optional bytes merklebin = 5;
+  if (has_merklebin()) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        5, this->merklebin(), target);
+  }
+
   if (!unknown_fields().empty()) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         unknown_fields(), target);
@@ -3977,6 +4319,13 @@ int Work::ByteSize() const {
           this->bits());
     }
 
+    // optional bytes merklebin = 5;
+    if (has_merklebin()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::BytesSize(
+          this->merklebin());
+    }
+
   }
   if (!unknown_fields().empty()) {
     total_size +=
@@ -4016,6 +4365,9 @@ void Work::MergeFrom(const Work& from) {
     if (from.has_bits()) {
       set_bits(from.bits());
     }
+    if (from.has_merklebin()) {
+      set_merklebin(from.merklebin());
+    }
   }
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
 }
@@ -4044,6 +4396,7 @@ void Work::Swap(Work* other) {
     std::swap(merkle_, other->merkle_);
     std::swap(time_, other->time_);
     std::swap(bits_, other->bits_);
+    std::swap(merklebin_, other->merklebin_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
     std::swap(_cached_size_, other->_cached_size_);
@@ -4074,6 +4427,7 @@ bool Reply_ErrType_IsValid(int value) {
     case 4:
     case 5:
     case 6:
+    case 7:
       return true;
     default:
       return false;
@@ -4088,6 +4442,7 @@ const Reply_ErrType Reply::REQNONCE;
 const Reply_ErrType Reply::STALE;
 const Reply_ErrType Reply::INVALID;
 const Reply_ErrType Reply::DUPLICATE;
+const Reply_ErrType Reply::BUSY;
 const Reply_ErrType Reply::ErrType_MIN;
 const Reply_ErrType Reply::ErrType_MAX;
 const int Reply::ErrType_ARRAYSIZE;
@@ -4952,6 +5307,11 @@ const int ServerStats::kThreadFieldNumber;
 const int ServerStats::kWorkersFieldNumber;
 const int ServerStats::kLatencyFieldNumber;
 const int ServerStats::kCpdFieldNumber;
+const int ServerStats::kSharequeueFieldNumber;
+const int ServerStats::kSharelatencyFieldNumber;
+const int ServerStats::kSharesFieldNumber;
+const int ServerStats::kTablememFieldNumber;
+const int ServerStats::kSharesbusyFieldNumber;
 const int ServerStats::kReqstatsFieldNumber;
 #endif  // !_MSC_VER
 
@@ -4979,6 +5339,11 @@ void ServerStats::SharedCtor() {
   workers_ = 0u;
   latency_ = 0u;
   cpd_ = 0;
+  sharequeue_ = 0u;
+  sharelatency_ = 0u;
+  shares_ = 0u;
+  tablemem_ = 0u;
+  sharesbusy_ = 0u;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -5027,14 +5392,16 @@ void ServerStats::Clear() {
     ::memset(&first, 0, n);                                \
   } while (0)
 
-  if (_has_bits_[0 / 32] & 31) {
-    ZR_(thread_, cpd_);
+  if (_has_bits_[0 / 32] & 255) {
+    ZR_(thread_, shares_);
     if (has_name()) {
       if (name_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
         name_->clear();
       }
     }
   }
+  tablemem_ = 0u;
+  sharesbusy_ = 0u;
 
 #undef OFFSET_OF_FIELD_
 #undef ZR_
@@ -5126,6 +5493,81 @@ bool ServerStats::MergePartialFromCodedStream(
         } else {
           goto handle_unusual;
         }
+        if (input->ExpectTag(104)) goto parse_sharequeue;
+        break;
+      }
+
+      // optional uint32 sharequeue = 13;
+      case 13: {
+        if (tag == 104) {
+         parse_sharequeue:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint32, ::google::protobuf::internal::WireFormatLite::TYPE_UINT32>(
+                 input, &sharequeue_)));
+          set_has_sharequeue();
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectTag(112)) goto parse_sharelatency;
+        break;
+      }
+
+      // optional uint32 sharelatency = 14;
+      case 14: {
+        if (tag == 112) {
+         parse_sharelatency:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint32, ::google::protobuf::internal::WireFormatLite::TYPE_UINT32>(
+                 input, &sharelatency_)));
+          set_has_sharelatency();
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectTag(120)) goto parse_shares;
+        break;
+      }
+
+      // optional uint32 shares = 15;
+      case 15: {
+        if (tag == 120) {
+         parse_shares:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint32, ::google::protobuf::internal::WireFormatLite::TYPE_UINT32>(
+                 input, &shares_)));
+          set_has_shares();
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectTag(128)) goto parse_tablemem;
+        break;
+      }
+
+      // optional uint32 tablemem = 16;
+      case 16: {
+        if (tag == 128) {
+         parse_tablemem:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint32, ::google::protobuf::internal::WireFormatLite::TYPE_UINT32>(
+                 input, &tablemem_)));
+          set_has_tablemem();
+        } else {
+          goto handle_unusual;
+        }
+        if (input->ExpectTag(136)) goto parse_sharesbusy;
+        break;
+      }
+
+      // optional uint32 sharesbusy = 17;
+      case 17: {
+        if (tag == 136) {
+         parse_sharesbusy:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint32, ::google::protobuf::internal::WireFormatLite::TYPE_UINT32>(
+                 input, &sharesbusy_)));
+          set_has_sharesbusy();
+        } else {
+          goto handle_unusual;
+        }
         if (input->ExpectTag(162)) goto parse_reqstats;
         break;
       }
@@ -5199,6 +5641,31 @@ void ServerStats::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteFloat(12, this->cpd(), output);
   }
 
+  // optional uint32 sharequeue = 13;
+  if (has_sharequeue()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt32(13, this->sharequeue(), output);
+  }
+
+  // optional uint32 sharelatency = 14;
+  if (has_sharelatency()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt32(14, this->sharelatency(), output);
+  }
+
+  // optional uint32 shares = 15;
+  if (has_shares()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt32(15, this->shares(), output);
+  }
+
+  // optional uint32 tablemem = 16;
+  if (has_tablemem()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt32(16, this->tablemem(), output);
+  }
+
+  // optional uint32 sharesbusy = 17;
+  if (has_sharesbusy()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt32(17, this->sharesbusy(), output);
+  }
+
   // repeated .pool.proto.ReqStats reqstats = 20;
   for (int i = 0; i < this->reqstats_size(); i++) {
     ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
@@ -5246,6 +5713,31 @@ void ServerStats::SerializeWithCachedSizes(
     target = ::google::protobuf::internal::WireFormatLite::WriteFloatToArray(12, this->cpd(), target);
   }
 
+  // optional uint32 sharequeue = 13;
+  if (has_sharequeue()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt32ToArray(13, this->sharequeue(), target);
+  }
+
+  // optional uint32 sharelatency = 14;
+  if (has_sharelatency()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt32ToArray(14, this->sharelatency(), target);
+  }
+
+  // optional uint32 shares = 15;
+  if (has_shares()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt32ToArray(15, this->shares(), target);
+  }
+
+  // optional uint32 tablemem = 16;
+  if (has_tablemem()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt32ToArray(16, this->tablemem(), target);
+  }
+
+  // optional uint32 sharesbusy = 17;
+  if (has_sharesbusy()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt32ToArray(17, this->sharesbusy(), target);
+  }
+
   // repeated .pool.proto.ReqStats reqstats = 20;
   for (int i = 0; i < this->reqstats_size(); i++) {
     target = ::google::protobuf::internal::WireFormatLite::
@@ -5298,6 +5790,43 @@ int ServerStats::ByteSize() const {
       total_size += 1 + 4;
     }
 
+    // optional uint32 sharequeue = 13;
+    if (has_sharequeue()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt32Size(
+          this->sharequeue());
+    }
+
+    // optional uint32 sharelatency = 14;
+    if (has_sharelatency()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt32Size(
+          this->sharelatency());
+    }
+
+    // optional uint32 shares = 15;
+    if (has_shares()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt32Size(
+          this->shares());
+    }
+
+  }
+  if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    // optional uint32 tablemem = 16;
+    if (has_tablemem()) {
+      total_size += 2 +
+        ::google::protobuf::internal::WireFormatLite::UInt32Size(
+          this->tablemem());
+    }
+
+    // optional uint32 sharesbusy = 17;
+    if (has_sharesbusy()) {
+      total_size += 2 +
+        ::google::protobuf::internal::WireFormatLite::UInt32Size(
+          this->sharesbusy());
+    }
+
   }
   // repeated .pool.proto.ReqStats reqstats = 20;
   total_size += 2 * this->reqstats_size();
@@ -5349,6 +5878,23 @@ void ServerStats::MergeFrom(const ServerStats& from) {
     if (from.has_cpd()) {
       set_cpd(from.cpd());
     }
+    if (from.has_sharequeue()) {
+      set_sharequeue(from.sharequeue());
+    }
+    if (from.has_sharelatency()) {
+      set_sharelatency(from.sharelatency());
+    }
+    if (from.has_shares()) {
+      set_shares(from.shares());
+    }
+  }
+  if (from._has_bits_[8 / 32] & (0xffu << (8 % 32))) {
+    if (from.has_tablemem()) {
+      set_tablemem(from.tablemem());
+    }
+    if (from.has_sharesbusy()) {
+      set_sharesbusy(from.sharesbusy());
+    }
   }
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
 }
@@ -5379,6 +5925,11 @@ void ServerStats::Swap(ServerStats* other) {
     std::swap(workers_, other->workers_);
     std::swap(latency_, other->latency_);
     std::swap(cpd_, other->cpd_);
+    std::swap(sharequeue_, other->sharequeue_);
+    std::swap(sharelatency_, other->sharelatency_);
+    std::swap(shares_, other->shares_);
+    std::swap(tablemem_, other->tablemem_);
+    std::swap(sharesbusy_, other->sharesbusy_);
     reqstats_.Swap(&other->reqstats_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
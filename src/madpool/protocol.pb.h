@@ -96,11 +96,12 @@ enum Reply_ErrType {
   Reply_ErrType_REQNONCE = 3,
   Reply_ErrType_STALE = 4,
   Reply_ErrType_INVALID = 5,
-  Reply_ErrType_DUPLICATE = 6
+  Reply_ErrType_DUPLICATE = 6,
+  Reply_ErrType_BUSY = 7
 };
 bool Reply_ErrType_IsValid(int value);
 const Reply_ErrType Reply_ErrType_ErrType_MIN = Reply_ErrType_NONE;
-const Reply_ErrType Reply_ErrType_ErrType_MAX = Reply_ErrType_DUPLICATE;
+const Reply_ErrType Reply_ErrType_ErrType_MAX = Reply_ErrType_BUSY;
 const int Reply_ErrType_ErrType_ARRAYSIZE = Reply_ErrType_ErrType_MAX + 1;
 
 const ::google::protobuf::EnumDescriptor* Reply_ErrType_descriptor();
@@ -213,6 +214,30 @@ class Block : public ::google::protobuf::Message {
   inline ::google::protobuf::uint32 minshare() const;
   inline void set_minshare(::google::protobuf::uint32 value);
 
+  // optional bytes hashbin = 6;
+  inline bool has_hashbin() const;
+  inline void clear_hashbin();
+  static const int kHashbinFieldNumber = 6;
+  inline const ::std::string& hashbin() const;
+  inline void set_hashbin(const ::std::string& value);
+  inline void set_hashbin(const char* value);
+  inline void set_hashbin(const void* value, size_t size);
+  inline ::std::string* mutable_hashbin();
+  inline ::std::string* release_hashbin();
+  inline void set_allocated_hashbin(::std::string* hashbin);
+
+  // optional bytes prevhashbin = 7;
+  inline bool has_prevhashbin() const;
+  inline void clear_prevhashbin();
+  static const int kPrevhashbinFieldNumber = 7;
+  inline const ::std::string& prevhashbin() const;
+  inline void set_prevhashbin(const ::std::string& value);
+  inline void set_prevhashbin(const char* value);
+  inline void set_prevhashbin(const void* value, size_t size);
+  inline ::std::string* mutable_prevhashbin();
+  inline ::std::string* release_prevhashbin();
+  inline void set_allocated_prevhashbin(::std::string* prevhashbin);
+
   // @@protoc_insertion_point(class_scope:pool.proto.Block)
  private:
   inline void set_has_height();
@@ -225,6 +250,10 @@ class Block : public ::google::protobuf::Message {
   inline void clear_has_reqdiff();
   inline void set_has_minshare();
   inline void clear_has_minshare();
+  inline void set_has_hashbin();
+  inline void clear_has_hashbin();
+  inline void set_has_prevhashbin();
+  inline void clear_has_prevhashbin();
 
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
 
@@ -235,6 +264,8 @@ class Block : public ::google::protobuf::Message {
   ::google::protobuf::uint32 reqdiff_;
   ::std::string* prevhash_;
   ::google::protobuf::uint32 minshare_;
+  ::std::string* hashbin_;
+  ::std::string* prevhashbin_;
   friend void  protobuf_AddDesc_protocol_2eproto();
   friend void protobuf_AssignDesc_protocol_2eproto();
   friend void protobuf_ShutdownFile_protocol_2eproto();
@@ -743,6 +774,54 @@ class Share : public ::google::protobuf::Message {
   inline ::google::protobuf::uint64 genvalue() const;
   inline void set_genvalue(::google::protobuf::uint64 value);
 
+  // optional bytes hashbin = 30;
+  inline bool has_hashbin() const;
+  inline void clear_hashbin();
+  static const int kHashbinFieldNumber = 30;
+  inline const ::std::string& hashbin() const;
+  inline void set_hashbin(const ::std::string& value);
+  inline void set_hashbin(const char* value);
+  inline void set_hashbin(const void* value, size_t size);
+  inline ::std::string* mutable_hashbin();
+  inline ::std::string* release_hashbin();
+  inline void set_allocated_hashbin(::std::string* hashbin);
+
+  // optional bytes merklebin = 31;
+  inline bool has_merklebin() const;
+  inline void clear_merklebin();
+  static const int kMerklebinFieldNumber = 31;
+  inline const ::std::string& merklebin() const;
+  inline void set_merklebin(const ::std::string& value);
+  inline void set_merklebin(const char* value);
+  inline void set_merklebin(const void* value, size_t size);
+  inline ::std::string* mutable_merklebin();
+  inline ::std::string* release_merklebin();
+  inline void set_allocated_merklebin(::std::string* merklebin);
+
+  // optional bytes multibin = 32;
+  inline bool has_multibin() const;
+  inline void clear_multibin();
+  static const int kMultibinFieldNumber = 32;
+  inline const ::std::string& multibin() const;
+  inline void set_multibin(const ::std::string& value);
+  inline void set_multibin(const char* value);
+  inline void set_multibin(const void* value, size_t size);
+  inline ::std::string* mutable_multibin();
+  inline ::std::string* release_multibin();
+  inline void set_allocated_multibin(::std::string* multibin);
+
+  // optional bytes blockhashbin = 33;
+  inline bool has_blockhashbin() const;
+  inline void clear_blockhashbin();
+  static const int kBlockhashbinFieldNumber = 33;
+  inline const ::std::string& blockhashbin() const;
+  inline void set_blockhashbin(const ::std::string& value);
+  inline void set_blockhashbin(const char* value);
+  inline void set_blockhashbin(const void* value, size_t size);
+  inline ::std::string* mutable_blockhashbin();
+  inline ::std::string* release_blockhashbin();
+  inline void set_allocated_blockhashbin(::std::string* blockhashbin);
+
   // @@protoc_insertion_point(class_scope:pool.proto.Share)
  private:
   inline void set_has_addr();
@@ -777,6 +856,14 @@ class Share : public ::google::protobuf::Message {
   inline void clear_has_isblock();
   inline void set_has_genvalue();
   inline void clear_has_genvalue();
+  inline void set_has_hashbin();
+  inline void clear_has_hashbin();
+  inline void set_has_merklebin();
+  inline void clear_has_merklebin();
+  inline void set_has_multibin();
+  inline void clear_has_multibin();
+  inline void set_has_blockhashbin();
+  inline void clear_has_blockhashbin();
 
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
 
@@ -798,6 +885,10 @@ class Share : public ::google::protobuf::Message {
   ::google::protobuf::uint32 chaintype_;
   bool isblock_;
   ::google::protobuf::uint64 genvalue_;
+  ::std::string* hashbin_;
+  ::std::string* merklebin_;
+  ::std::string* multibin_;
+  ::std::string* blockhashbin_;
   friend void  protobuf_AddDesc_protocol_2eproto();
   friend void protobuf_AssignDesc_protocol_2eproto();
   friend void protobuf_ShutdownFile_protocol_2eproto();
@@ -1183,6 +1274,18 @@ class Work : public ::google::protobuf::Message {
   inline ::google::protobuf::uint32 bits() const;
   inline void set_bits(::google::protobuf::uint32 value);
 
+  // optional bytes merklebin = 5;
+  inline bool has_merklebin() const;
+  inline void clear_merklebin();
+  static const int kMerklebinFieldNumber = 5;
+  inline const ::std::string& merklebin() const;
+  inline void set_merklebin(const ::std::string& value);
+  inline void set_merklebin(const char* value);
+  inline void set_merklebin(const void* value, size_t size);
+  inline ::std::string* mutable_merklebin();
+  inline ::std::string* release_merklebin();
+  inline void set_allocated_merklebin(::std::string* merklebin);
+
   // @@protoc_insertion_point(class_scope:pool.proto.Work)
  private:
   inline void set_has_height();
@@ -1193,6 +1296,8 @@ class Work : public ::google::protobuf::Message {
   inline void clear_has_time();
   inline void set_has_bits();
   inline void clear_has_bits();
+  inline void set_has_merklebin();
+  inline void clear_has_merklebin();
 
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
 
@@ -1202,6 +1307,7 @@ class Work : public ::google::protobuf::Message {
   ::google::protobuf::uint32 height_;
   ::google::protobuf::uint32 time_;
   ::google::protobuf::uint32 bits_;
+  ::std::string* merklebin_;
   friend void  protobuf_AddDesc_protocol_2eproto();
   friend void protobuf_AssignDesc_protocol_2eproto();
   friend void protobuf_ShutdownFile_protocol_2eproto();
@@ -1270,6 +1376,7 @@ class Reply : public ::google::protobuf::Message {
   static const ErrType STALE = Reply_ErrType_STALE;
   static const ErrType INVALID = Reply_ErrType_INVALID;
   static const ErrType DUPLICATE = Reply_ErrType_DUPLICATE;
+  static const ErrType BUSY = Reply_ErrType_BUSY;
   static inline bool ErrType_IsValid(int value) {
     return Reply_ErrType_IsValid(value);
   }
@@ -1582,6 +1689,41 @@ class ServerStats : public ::google::protobuf::Message {
   inline float cpd() const;
   inline void set_cpd(float value);
 
+  // optional uint32 sharequeue = 13;
+  inline bool has_sharequeue() const;
+  inline void clear_sharequeue();
+  static const int kSharequeueFieldNumber = 13;
+  inline ::google::protobuf::uint32 sharequeue() const;
+  inline void set_sharequeue(::google::protobuf::uint32 value);
+
+  // optional uint32 sharelatency = 14;
+  inline bool has_sharelatency() const;
+  inline void clear_sharelatency();
+  static const int kSharelatencyFieldNumber = 14;
+  inline ::google::protobuf::uint32 sharelatency() const;
+  inline void set_sharelatency(::google::protobuf::uint32 value);
+
+  // optional uint32 shares = 15;
+  inline bool has_shares() const;
+  inline void clear_shares();
+  static const int kSharesFieldNumber = 15;
+  inline ::google::protobuf::uint32 shares() const;
+  inline void set_shares(::google::protobuf::uint32 value);
+
+  // optional uint32 tablemem = 16;
+  inline bool has_tablemem() const;
+  inline void clear_tablemem();
+  static const int kTablememFieldNumber = 16;
+  inline ::google::protobuf::uint32 tablemem() const;
+  inline void set_tablemem(::google::protobuf::uint32 value);
+
+  // optional uint32 sharesbusy = 17;
+  inline bool has_sharesbusy() const;
+  inline void clear_sharesbusy();
+  static const int kSharesbusyFieldNumber = 17;
+  inline ::google::protobuf::uint32 sharesbusy() const;
+  inline void set_sharesbusy(::google::protobuf::uint32 value);
+
   // repeated .pool.proto.ReqStats reqstats = 20;
   inline int reqstats_size() const;
   inline void clear_reqstats();
@@ -1606,6 +1748,16 @@ class ServerStats : public ::google::protobuf::Message {
   inline void clear_has_latency();
   inline void set_has_cpd();
   inline void clear_has_cpd();
+  inline void set_has_sharequeue();
+  inline void clear_has_sharequeue();
+  inline void set_has_sharelatency();
+  inline void clear_has_sharelatency();
+  inline void set_has_shares();
+  inline void clear_has_shares();
+  inline void set_has_tablemem();
+  inline void clear_has_tablemem();
+  inline void set_has_sharesbusy();
+  inline void clear_has_sharesbusy();
 
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
 
@@ -1616,6 +1768,11 @@ class ServerStats : public ::google::protobuf::Message {
   ::google::protobuf::uint32 workers_;
   ::google::protobuf::uint32 latency_;
   float cpd_;
+  ::google::protobuf::uint32 sharequeue_;
+  ::google::protobuf::uint32 sharelatency_;
+  ::google::protobuf::uint32 shares_;
+  ::google::protobuf::uint32 tablemem_;
+  ::google::protobuf::uint32 sharesbusy_;
   ::google::protobuf::RepeatedPtrField< ::pool::proto::ReqStats > reqstats_;
   friend void  protobuf_AddDesc_protocol_2eproto();
   friend void protobuf_AssignDesc_protocol_2eproto();
@@ -1960,6 +2117,158 @@ inline void Block::set_minshare(::google::protobuf::uint32 value) {
   // @@protoc_insertion_point(field_set:pool.proto.Block.minshare)
 }
 
+// optional bytes hashbin = 6;
+inline bool Block::has_hashbin() const {
+  return (_has_bits_[0] & 0x00000020u) != 0;
+}
+inline void Block::set_has_hashbin() {
+  _has_bits_[0] |= 0x00000020u;
+}
+inline void Block::clear_has_hashbin() {
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline void Block::clear_hashbin() {
+  if (hashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    hashbin_->clear();
+  }
+  clear_has_hashbin();
+}
+inline const ::std::string& Block::hashbin() const {
+  // @@protoc_insertion_point(field_get:pool.proto.Block.hashbin)
+  return *hashbin_;
+}
+inline void Block::set_hashbin(const ::std::string& value) {
+  set_has_hashbin();
+  if (hashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    hashbin_ = new ::std::string;
+  }
+  hashbin_->assign(value);
+  // @@protoc_insertion_point(field_set:pool.proto.Block.hashbin)
+}
+inline void Block::set_hashbin(const char* value) {
+  set_has_hashbin();
+  if (hashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    hashbin_ = new ::std::string;
+  }
+  hashbin_->assign(value);
+  // @@protoc_insertion_point(field_set_char:pool.proto.Block.hashbin)
+}
+inline void Block::set_hashbin(const void* value, size_t size) {
+  set_has_hashbin();
+  if (hashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    hashbin_ = new ::std::string;
+  }
+  hashbin_->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:pool.proto.Block.hashbin)
+}
+inline ::std::string* Block::mutable_hashbin() {
+  set_has_hashbin();
+  if (hashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    hashbin_ = new ::std::string;
+  }
+  // @@protoc_insertion_point(field_mutable:pool.proto.Block.hashbin)
+  return hashbin_;
+}
+inline ::std::string* Block::release_hashbin() {
+  clear_has_hashbin();
+  if (hashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    return NULL;
+  } else {
+    ::std::string* temp = hashbin_;
+    hashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+    return temp;
+  }
+}
+inline void Block::set_allocated_hashbin(::std::string* hashbin) {
+  if (hashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete hashbin_;
+  }
+  if (hashbin) {
+    set_has_hashbin();
+    hashbin_ = hashbin;
+  } else {
+    clear_has_hashbin();
+    hashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  }
+  // @@protoc_insertion_point(field_set_allocated:pool.proto.Block.hashbin)
+}
+
+// optional bytes prevhashbin = 7;
+inline bool Block::has_prevhashbin() const {
+  return (_has_bits_[0] & 0x00000040u) != 0;
+}
+inline void Block::set_has_prevhashbin() {
+  _has_bits_[0] |= 0x00000040u;
+}
+inline void Block::clear_has_prevhashbin() {
+  _has_bits_[0] &= ~0x00000040u;
+}
+inline void Block::clear_prevhashbin() {
+  if (prevhashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    prevhashbin_->clear();
+  }
+  clear_has_prevhashbin();
+}
+inline const ::std::string& Block::prevhashbin() const {
+  // @@protoc_insertion_point(field_get:pool.proto.Block.prevhashbin)
+  return *prevhashbin_;
+}
+inline void Block::set_prevhashbin(const ::std::string& value) {
+  set_has_prevhashbin();
+  if (prevhashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    prevhashbin_ = new ::std::string;
+  }
+  prevhashbin_->assign(value);
+  // @@protoc_insertion_point(field_set:pool.proto.Block.prevhashbin)
+}
+inline void Block::set_prevhashbin(const char* value) {
+  set_has_prevhashbin();
+  if (prevhashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    prevhashbin_ = new ::std::string;
+  }
+  prevhashbin_->assign(value);
+  // @@protoc_insertion_point(field_set_char:pool.proto.Block.prevhashbin)
+}
+inline void Block::set_prevhashbin(const void* value, size_t size) {
+  set_has_prevhashbin();
+  if (prevhashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    prevhashbin_ = new ::std::string;
+  }
+  prevhashbin_->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:pool.proto.Block.prevhashbin)
+}
+inline ::std::string* Block::mutable_prevhashbin() {
+  set_has_prevhashbin();
+  if (prevhashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    prevhashbin_ = new ::std::string;
+  }
+  // @@protoc_insertion_point(field_mutable:pool.proto.Block.prevhashbin)
+  return prevhashbin_;
+}
+inline ::std::string* Block::release_prevhashbin() {
+  clear_has_prevhashbin();
+  if (prevhashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    return NULL;
+  } else {
+    ::std::string* temp = prevhashbin_;
+    prevhashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+    return temp;
+  }
+}
+inline void Block::set_allocated_prevhashbin(::std::string* prevhashbin) {
+  if (prevhashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete prevhashbin_;
+  }
+  if (prevhashbin) {
+    set_has_prevhashbin();
+    prevhashbin_ = prevhashbin;
+  } else {
+    clear_has_prevhashbin();
+    prevhashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  }
+  // @@protoc_insertion_point(field_set_allocated:pool.proto.Block.prevhashbin)
+}
+
 // -------------------------------------------------------------------
 
 // Signal
@@ -3102,6 +3411,310 @@ inline void Share::set_genvalue(::google::protobuf::uint64 value) {
   // @@protoc_insertion_point(field_set:pool.proto.Share.genvalue)
 }
 
+// optional bytes hashbin = 30;
+inline bool Share::has_hashbin() const {
+  return (_has_bits_[0] & 0x00010000u) != 0;
+}
+inline void Share::set_has_hashbin() {
+  _has_bits_[0] |= 0x00010000u;
+}
+inline void Share::clear_has_hashbin() {
+  _has_bits_[0] &= ~0x00010000u;
+}
+inline void Share::clear_hashbin() {
+  if (hashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    hashbin_->clear();
+  }
+  clear_has_hashbin();
+}
+inline const ::std::string& Share::hashbin() const {
+  // @@protoc_insertion_point(field_get:pool.proto.Share.hashbin)
+  return *hashbin_;
+}
+inline void Share::set_hashbin(const ::std::string& value) {
+  set_has_hashbin();
+  if (hashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    hashbin_ = new ::std::string;
+  }
+  hashbin_->assign(value);
+  // @@protoc_insertion_point(field_set:pool.proto.Share.hashbin)
+}
+inline void Share::set_hashbin(const char* value) {
+  set_has_hashbin();
+  if (hashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    hashbin_ = new ::std::string;
+  }
+  hashbin_->assign(value);
+  // @@protoc_insertion_point(field_set_char:pool.proto.Share.hashbin)
+}
+inline void Share::set_hashbin(const void* value, size_t size) {
+  set_has_hashbin();
+  if (hashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    hashbin_ = new ::std::string;
+  }
+  hashbin_->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:pool.proto.Share.hashbin)
+}
+inline ::std::string* Share::mutable_hashbin() {
+  set_has_hashbin();
+  if (hashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    hashbin_ = new ::std::string;
+  }
+  // @@protoc_insertion_point(field_mutable:pool.proto.Share.hashbin)
+  return hashbin_;
+}
+inline ::std::string* Share::release_hashbin() {
+  clear_has_hashbin();
+  if (hashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    return NULL;
+  } else {
+    ::std::string* temp = hashbin_;
+    hashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+    return temp;
+  }
+}
+inline void Share::set_allocated_hashbin(::std::string* hashbin) {
+  if (hashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete hashbin_;
+  }
+  if (hashbin) {
+    set_has_hashbin();
+    hashbin_ = hashbin;
+  } else {
+    clear_has_hashbin();
+    hashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  }
+  // @@protoc_insertion_point(field_set_allocated:pool.proto.Share.hashbin)
+}
+
+// optional bytes merklebin = 31;
+inline bool Share::has_merklebin() const {
+  return (_has_bits_[0] & 0x00020000u) != 0;
+}
+inline void Share::set_has_merklebin() {
+  _has_bits_[0] |= 0x00020000u;
+}
+inline void Share::clear_has_merklebin() {
+  _has_bits_[0] &= ~0x00020000u;
+}
+inline void Share::clear_merklebin() {
+  if (merklebin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    merklebin_->clear();
+  }
+  clear_has_merklebin();
+}
+inline const ::std::string& Share::merklebin() const {
+  // @@protoc_insertion_point(field_get:pool.proto.Share.merklebin)
+  return *merklebin_;
+}
+inline void Share::set_merklebin(const ::std::string& value) {
+  set_has_merklebin();
+  if (merklebin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    merklebin_ = new ::std::string;
+  }
+  merklebin_->assign(value);
+  // @@protoc_insertion_point(field_set:pool.proto.Share.merklebin)
+}
+inline void Share::set_merklebin(const char* value) {
+  set_has_merklebin();
+  if (merklebin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    merklebin_ = new ::std::string;
+  }
+  merklebin_->assign(value);
+  // @@protoc_insertion_point(field_set_char:pool.proto.Share.merklebin)
+}
+inline void Share::set_merklebin(const void* value, size_t size) {
+  set_has_merklebin();
+  if (merklebin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    merklebin_ = new ::std::string;
+  }
+  merklebin_->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:pool.proto.Share.merklebin)
+}
+inline ::std::string* Share::mutable_merklebin() {
+  set_has_merklebin();
+  if (merklebin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    merklebin_ = new ::std::string;
+  }
+  // @@protoc_insertion_point(field_mutable:pool.proto.Share.merklebin)
+  return merklebin_;
+}
+inline ::std::string* Share::release_merklebin() {
+  clear_has_merklebin();
+  if (merklebin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    return NULL;
+  } else {
+    ::std::string* temp = merklebin_;
+    merklebin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+    return temp;
+  }
+}
+inline void Share::set_allocated_merklebin(::std::string* merklebin) {
+  if (merklebin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete merklebin_;
+  }
+  if (merklebin) {
+    set_has_merklebin();
+    merklebin_ = merklebin;
+  } else {
+    clear_has_merklebin();
+    merklebin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  }
+  // @@protoc_insertion_point(field_set_allocated:pool.proto.Share.merklebin)
+}
+
+// optional bytes multibin = 32;
+inline bool Share::has_multibin() const {
+  return (_has_bits_[0] & 0x00040000u) != 0;
+}
+inline void Share::set_has_multibin() {
+  _has_bits_[0] |= 0x00040000u;
+}
+inline void Share::clear_has_multibin() {
+  _has_bits_[0] &= ~0x00040000u;
+}
+inline void Share::clear_multibin() {
+  if (multibin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    multibin_->clear();
+  }
+  clear_has_multibin();
+}
+inline const ::std::string& Share::multibin() const {
+  // @@protoc_insertion_point(field_get:pool.proto.Share.multibin)
+  return *multibin_;
+}
+inline void Share::set_multibin(const ::std::string& value) {
+  set_has_multibin();
+  if (multibin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    multibin_ = new ::std::string;
+  }
+  multibin_->assign(value);
+  // @@protoc_insertion_point(field_set:pool.proto.Share.multibin)
+}
+inline void Share::set_multibin(const char* value) {
+  set_has_multibin();
+  if (multibin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    multibin_ = new ::std::string;
+  }
+  multibin_->assign(value);
+  // @@protoc_insertion_point(field_set_char:pool.proto.Share.multibin)
+}
+inline void Share::set_multibin(const void* value, size_t size) {
+  set_has_multibin();
+  if (multibin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    multibin_ = new ::std::string;
+  }
+  multibin_->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:pool.proto.Share.multibin)
+}
+inline ::std::string* Share::mutable_multibin() {
+  set_has_multibin();
+  if (multibin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    multibin_ = new ::std::string;
+  }
+  // @@protoc_insertion_point(field_mutable:pool.proto.Share.multibin)
+  return multibin_;
+}
+inline ::std::string* Share::release_multibin() {
+  clear_has_multibin();
+  if (multibin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    return NULL;
+  } else {
+    ::std::string* temp = multibin_;
+    multibin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+    return temp;
+  }
+}
+inline void Share::set_allocated_multibin(::std::string* multibin) {
+  if (multibin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete multibin_;
+  }
+  if (multibin) {
+    set_has_multibin();
+    multibin_ = multibin;
+  } else {
+    clear_has_multibin();
+    multibin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  }
+  // @@protoc_insertion_point(field_set_allocated:pool.proto.Share.multibin)
+}
+
+// optional bytes blockhashbin = 33;
+inline bool Share::has_blockhashbin() const {
+  return (_has_bits_[0] & 0x00080000u) != 0;
+}
+inline void Share::set_has_blockhashbin() {
+  _has_bits_[0] |= 0x00080000u;
+}
+inline void Share::clear_has_blockhashbin() {
+  _has_bits_[0] &= ~0x00080000u;
+}
+inline void Share::clear_blockhashbin() {
+  if (blockhashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    blockhashbin_->clear();
+  }
+  clear_has_blockhashbin();
+}
+inline const ::std::string& Share::blockhashbin() const {
+  // @@protoc_insertion_point(field_get:pool.proto.Share.blockhashbin)
+  return *blockhashbin_;
+}
+inline void Share::set_blockhashbin(const ::std::string& value) {
+  set_has_blockhashbin();
+  if (blockhashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    blockhashbin_ = new ::std::string;
+  }
+  blockhashbin_->assign(value);
+  // @@protoc_insertion_point(field_set:pool.proto.Share.blockhashbin)
+}
+inline void Share::set_blockhashbin(const char* value) {
+  set_has_blockhashbin();
+  if (blockhashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    blockhashbin_ = new ::std::string;
+  }
+  blockhashbin_->assign(value);
+  // @@protoc_insertion_point(field_set_char:pool.proto.Share.blockhashbin)
+}
+inline void Share::set_blockhashbin(const void* value, size_t size) {
+  set_has_blockhashbin();
+  if (blockhashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    blockhashbin_ = new ::std::string;
+  }
+  blockhashbin_->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:pool.proto.Share.blockhashbin)
+}
+inline ::std::string* Share::mutable_blockhashbin() {
+  set_has_blockhashbin();
+  if (blockhashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    blockhashbin_ = new ::std::string;
+  }
+  // @@protoc_insertion_point(field_mutable:pool.proto.Share.blockhashbin)
+  return blockhashbin_;
+}
+inline ::std::string* Share::release_blockhashbin() {
+  clear_has_blockhashbin();
+  if (blockhashbin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    return NULL;
+  } else {
+    ::std::string* temp = blockhashbin_;
+    blockhashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+    return temp;
+  }
+}
+inline void Share::set_allocated_blockhashbin(::std::string* blockhashbin) {
+  if (blockhashbin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete blockhashbin_;
+  }
+  if (blockhashbin) {
+    set_has_blockhashbin();
+    blockhashbin_ = blockhashbin;
+  } else {
+    clear_has_blockhashbin();
+    blockhashbin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  }
+  // @@protoc_insertion_point(field_set_allocated:pool.proto.Share.blockhashbin)
+}
+
 // -------------------------------------------------------------------
 
 // Request
@@ -3665,6 +4278,82 @@ inline void Work::set_bits(::google::protobuf::uint32 value) {
   // @@protoc_insertion_point(field_set:pool.proto.Work.bits)
 }
 
+// optional bytes merklebin = 5;
+inline bool Work::has_merklebin() const {
+  return (_has_bits_[0] & 0x00000010u) != 0;
+}
+inline void Work::set_has_merklebin() {
+  _has_bits_[0] |= 0x00000010u;
+}
+inline void Work::clear_has_merklebin() {
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline void Work::clear_merklebin() {
+  if (merklebin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    merklebin_->clear();
+  }
+  clear_has_merklebin();
+}
+inline const ::std::string& Work::merklebin() const {
+  // @@protoc_insertion_point(field_get:pool.proto.Work.merklebin)
+  return *merklebin_;
+}
+inline void Work::set_merklebin(const ::std::string& value) {
+  set_has_merklebin();
+  if (merklebin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    merklebin_ = new ::std::string;
+  }
+  merklebin_->assign(value);
+  // @@protoc_insertion_point(field_set:pool.proto.Work.merklebin)
+}
+inline void Work::set_merklebin(const char* value) {
+  set_has_merklebin();
+  if (merklebin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    merklebin_ = new ::std::string;
+  }
+  merklebin_->assign(value);
+  // @@protoc_insertion_point(field_set_char:pool.proto.Work.merklebin)
+}
+inline void Work::set_merklebin(const void* value, size_t size) {
+  set_has_merklebin();
+  if (merklebin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    merklebin_ = new ::std::string;
+  }
+  merklebin_->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:pool.proto.Work.merklebin)
+}
+inline ::std::string* Work::mutable_merklebin() {
+  set_has_merklebin();
+  if (merklebin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    merklebin_ = new ::std::string;
+  }
+  // @@protoc_insertion_point(field_mutable:pool.proto.Work.merklebin)
+  return merklebin_;
+}
+inline ::std::string* Work::release_merklebin() {
+  clear_has_merklebin();
+  if (merklebin_ == &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    return NULL;
+  } else {
+    ::std::string* temp = merklebin_;
+    merklebin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+    return temp;
+  }
+}
+inline void Work::set_allocated_merklebin(::std::string* merklebin) {
+  if (merklebin_ != &::google::protobuf::internal::GetEmptyStringAlreadyInited()) {
+    delete merklebin_;
+  }
+  if (merklebin) {
+    set_has_merklebin();
+    merklebin_ = merklebin;
+  } else {
+    clear_has_merklebin();
+    merklebin_ = const_cast< ::std::string*>(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  }
+  // @@protoc_insertion_point(field_set_allocated:pool.proto.Work.merklebin)
+}
+
 // -------------------------------------------------------------------
 
 // Reply
@@ -4196,6 +4885,126 @@ inline void ServerStats::set_cpd(float value) {
   // @@protoc_insertion_point(field_set:pool.proto.ServerStats.cpd)
 }
 
+// optional uint32 sharequeue = 13;
+inline bool ServerStats::has_sharequeue() const {
+  return (_has_bits_[0] & 0x00000020u) != 0;
+}
+inline void ServerStats::set_has_sharequeue() {
+  _has_bits_[0] |= 0x00000020u;
+}
+inline void ServerStats::clear_has_sharequeue() {
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline void ServerStats::clear_sharequeue() {
+  sharequeue_ = 0u;
+  clear_has_sharequeue();
+}
+inline ::google::protobuf::uint32 ServerStats::sharequeue() const {
+  // @@protoc_insertion_point(field_get:pool.proto.ServerStats.sharequeue)
+  return sharequeue_;
+}
+inline void ServerStats::set_sharequeue(::google::protobuf::uint32 value) {
+  set_has_sharequeue();
+  sharequeue_ = value;
+  // @@protoc_insertion_point(field_set:pool.proto.ServerStats.sharequeue)
+}
+
+// optional uint32 sharelatency = 14;
+inline bool ServerStats::has_sharelatency() const {
+  return (_has_bits_[0] & 0x00000040u) != 0;
+}
+inline void ServerStats::set_has_sharelatency() {
+  _has_bits_[0] |= 0x00000040u;
+}
+inline void ServerStats::clear_has_sharelatency() {
+  _has_bits_[0] &= ~0x00000040u;
+}
+inline void ServerStats::clear_sharelatency() {
+  sharelatency_ = 0u;
+  clear_has_sharelatency();
+}
+inline ::google::protobuf::uint32 ServerStats::sharelatency() const {
+  // @@protoc_insertion_point(field_get:pool.proto.ServerStats.sharelatency)
+  return sharelatency_;
+}
+inline void ServerStats::set_sharelatency(::google::protobuf::uint32 value) {
+  set_has_sharelatency();
+  sharelatency_ = value;
+  // @@protoc_insertion_point(field_set:pool.proto.ServerStats.sharelatency)
+}
+
+// optional uint32 shares = 15;
+inline bool ServerStats::has_shares() const {
+  return (_has_bits_[0] & 0x00000080u) != 0;
+}
+inline void ServerStats::set_has_shares() {
+  _has_bits_[0] |= 0x00000080u;
+}
+inline void ServerStats::clear_has_shares() {
+  _has_bits_[0] &= ~0x00000080u;
+}
+inline void ServerStats::clear_shares() {
+  shares_ = 0u;
+  clear_has_shares();
+}
+inline ::google::protobuf::uint32 ServerStats::shares() const {
+  // @@protoc_insertion_point(field_get:pool.proto.ServerStats.shares)
+  return shares_;
+}
+inline void ServerStats::set_shares(::google::protobuf::uint32 value) {
+  set_has_shares();
+  shares_ = value;
+  // @@protoc_insertion_point(field_set:pool.proto.ServerStats.shares)
+}
+
+// optional uint32 tablemem = 16;
+inline bool ServerStats::has_tablemem() const {
+  return (_has_bits_[0] & 0x00000100u) != 0;
+}
+inline void ServerStats::set_has_tablemem() {
+  _has_bits_[0] |= 0x00000100u;
+}
+inline void ServerStats::clear_has_tablemem() {
+  _has_bits_[0] &= ~0x00000100u;
+}
+inline void ServerStats::clear_tablemem() {
+  tablemem_ = 0u;
+  clear_has_tablemem();
+}
+inline ::google::protobuf::uint32 ServerStats::tablemem() const {
+  // @@protoc_insertion_point(field_get:pool.proto.ServerStats.tablemem)
+  return tablemem_;
+}
+inline void ServerStats::set_tablemem(::google::protobuf::uint32 value) {
+  set_has_tablemem();
+  tablemem_ = value;
+  // @@protoc_insertion_point(field_set:pool.proto.ServerStats.tablemem)
+}
+
+// optional uint32 sharesbusy = 17;
+inline bool ServerStats::has_sharesbusy() const {
+  return (_has_bits_[0] & 0x00000200u) != 0;
+}
+inline void ServerStats::set_has_sharesbusy() {
+  _has_bits_[0] |= 0x00000200u;
+}
+inline void ServerStats::clear_has_sharesbusy() {
+  _has_bits_[0] &= ~0x00000200u;
+}
+inline void ServerStats::clear_sharesbusy() {
+  sharesbusy_ = 0u;
+  clear_has_sharesbusy();
+}
+inline ::google::protobuf::uint32 ServerStats::sharesbusy() const {
+  // @@protoc_insertion_point(field_get:pool.proto.ServerStats.sharesbusy)
+  return sharesbusy_;
+}
+inline void ServerStats::set_sharesbusy(::google::protobuf::uint32 value) {
+  set_has_sharesbusy();
+  sharesbusy_ = value;
+  // @@protoc_insertion_point(field_set:pool.proto.ServerStats.sharesbusy)
+}
+
 // repeated .pool.proto.ReqStats reqstats = 20;
 inline int ServerStats::reqstats_size() const {
   return reqstats_.size();
@@ -50,6 +50,7 @@ uint64_t nLastBlockTx = 0;
 uint64_t nLastBlockWeight = 0;
 
 double dPrimesPerSec = 0.0;
+double dTestsPerSec = 0.0;
 double dChainsPerDay = 0.0;
 double dBlocksPerDay = 0.0;
 int64_t nHPSTimerStart = 0;
@@ -214,6 +215,41 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     return std::move(pblocktemplate);
 }
 
+std::unique_ptr<CBlockTemplate> BlockAssembler::CreateEmptyBlock(const CScript& scriptPubKeyIn, const CBlockIndex* pindexPrev)
+{
+    resetBlock();
+
+    pblocktemplate.reset(new CBlockTemplate());
+    pblock = &pblocktemplate->block;
+
+    LOCK(cs_main);
+    nHeight = pindexPrev->nHeight + 1;
+
+    pblock->nVersion = ComputeBlockVersion(pindexPrev, chainparams.GetConsensus());
+    if (chainparams.MineBlocksOnDemand())
+        pblock->nVersion = gArgs.GetArg("-blockversion", pblock->nVersion);
+    pblock->hashPrevBlock = pindexPrev->GetBlockHash();
+    pblock->nTime = GetAdjustedTime();
+    UpdateTime(pblock, chainparams.GetConsensus(), pindexPrev);
+    pblock->nBits = GetNextWorkRequired(pindexPrev, pblock, chainparams.GetConsensus());
+    pblock->nNonce = 0;
+    pblock->bnPrimeChainMultiplier = chainparams.GenesisBlock().bnPrimeChainMultiplier;
+
+    CMutableTransaction coinbaseTx;
+    coinbaseTx.vin.resize(1);
+    coinbaseTx.vin[0].prevout.SetNull();
+    coinbaseTx.vin[0].scriptSig = CScript() << nHeight << OP_0;
+    coinbaseTx.vout.resize(1);
+    coinbaseTx.vout[0].scriptPubKey = scriptPubKeyIn;
+    coinbaseTx.vout[0].nValue = GetBlockSubsidy(pblock->nBits, chainparams.GetConsensus());
+    pblock->vtx.push_back(MakeTransactionRef(std::move(coinbaseTx)));
+
+    pblocktemplate->vTxFees.push_back(0);
+    pblocktemplate->vTxSigOpsCost.push_back(WITNESS_SCALE_FACTOR * GetLegacySigOpCount(*pblock->vtx[0]));
+
+    return std::move(pblocktemplate);
+}
+
 void BlockAssembler::onlyUnconfirmed(CTxMemPool::setEntries& testSet)
 {
     for (CTxMemPool::setEntries::iterator iit = testSet.begin(); iit != testSet.end(); ) {
@@ -476,14 +512,20 @@ void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned
     ++nExtraNonce;
     unsigned int nHeight = pindexPrev->nHeight+1; // Height first in coinbase required for block.version=2
     CMutableTransaction txCoinbase(*pblock->vtx[0]);
-    const char* pszDedication = gArgs.GetArg("-dedication", "").c_str();
-    txCoinbase.vin[0].scriptSig = (CScript() << nHeight << CBigNum(nExtraNonce) << std::vector<unsigned char>((const unsigned char*)pszDedication, (const unsigned char*)pszDedication + strlen(pszDedication))) + COINBASE_FLAGS;
-    assert(txCoinbase.vin[0].scriptSig.size() <= 100);
+    txCoinbase.vin[0].scriptSig = CoinbaseScriptSig(nHeight, nExtraNonce);
 
     pblock->vtx[0] = MakeTransactionRef(std::move(txCoinbase));
     pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
 }
 
+CScript CoinbaseScriptSig(unsigned int nHeight, unsigned int nExtraNonce)
+{
+    const std::string strDedication = gArgs.GetArg("-dedication", "");
+    CScript scriptSig = (CScript() << nHeight << CBigNum(nExtraNonce) << std::vector<unsigned char>(strDedication.begin(), strDedication.end())) + COINBASE_FLAGS;
+    assert(scriptSig.size() <= 100);
+    return scriptSig;
+}
+
 bool CheckWork(CBlock* pblock, CWallet& wallet, std::shared_ptr<CReserveScript> reserve_script, bool fSilent) //CReserveKey& reservekey)
 {
     //DATACOIN WASTED Primecoin wasting instruction?
@@ -696,6 +738,7 @@ bool MiniMiner(CBlock *pblock, CBlockIndex* pindexPrev, bool allowIncrementExtra
                     double dPrimesPerMinute = 60000.0 * nPrimeCounter / nTimeDiffMillis;
                     dPrimesPerSec = dPrimesPerMinute / 60.0;
                     double dTestsPerMinute = 60000.0 * nTestCounter / nTimeDiffMillis;
+                    dTestsPerSec = dTestsPerMinute / 60.0;
                     dChainsPerDay = 86400000.0 * dChainExpected / nTimeDiffMillis;
                     dBlocksPerDay = 86400000.0 * dBlockExpected / nTimeDiffMillis;
                     nPrimeCounter = 0;
@@ -1095,6 +1138,7 @@ void static BitcoinCPUMiner(CWallet *pwallet)
                     double dPrimesPerMinute = 60000.0 * nPrimeCounter / nTimeDiffMillis;
                     dPrimesPerSec = dPrimesPerMinute / 60.0;
                     double dTestsPerMinute = 60000.0 * nTestCounter / nTimeDiffMillis;
+                    dTestsPerSec = dTestsPerMinute / 60.0;
                     dChainsPerDay = 86400000.0 * dChainExpected / nTimeDiffMillis;
                     dBlocksPerDay = 86400000.0 * dBlockExpected / nTimeDiffMillis;
                     nPrimeCounter = 0;
@@ -1292,6 +1336,7 @@ void GenerateBitcoins(bool fGenerate, CWallet* pwallet)
 	//DATACOIN POOL
     LogPrintf("[PrimeServer] GenerateBitcoins: %s\n", fGenerate ? "true" : "false");
 	
+    LOCK(cs_primeserver);
     if(gPrimeServer && !fGenerate){
     	
     	delete gPrimeServer;
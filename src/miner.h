@@ -19,6 +19,7 @@
 void GenerateBitcoins(bool fGenerate, CWallet* pwallet);
 
 extern double dPrimesPerSec;
+extern double dTestsPerSec;
 extern double dChainsPerDay;
 extern double dBlocksPerDay;
 extern int64_t nHPSTimerStart;
@@ -175,6 +176,12 @@ public:
 
     /** Construct a new block template with coinbase to scriptPubKeyIn */
     std::unique_ptr<CBlockTemplate> CreateNewBlock(const CScript& scriptPubKeyIn, bool fMineWitnessTx=true);
+    /**
+     * Construct a template with only the coinbase on top of pindexPrev, which
+     * need not be connected yet. It skips the mempool and TestBlockValidity,
+     * so work can start on a block as soon as its proof-of-work is checked.
+     */
+    std::unique_ptr<CBlockTemplate> CreateEmptyBlock(const CScript& scriptPubKeyIn, const CBlockIndex* pindexPrev);
 
 private:
     // utility functions
@@ -212,6 +219,8 @@ private:
 
 /** Modify the extranonce in a block */
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce, bool fNoReset = false);
+/** Coinbase scriptSig of a block at nHeight with the given extranonce */
+CScript CoinbaseScriptSig(unsigned int nHeight, unsigned int nExtraNonce);
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
 
 bool CheckWork(CBlock* pblock, CWallet& wallet, std::shared_ptr<CReserveScript> reserve_script, bool fSilent=false);
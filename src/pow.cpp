@@ -9,9 +9,136 @@
 
 #include "arith_uint256.h"
 #include "chain.h"
+#include "crypto/common.h"
+#include "crypto/sha256.h"
+#include "cuckoocache.h"
 #include "primitives/block.h"
+#include "random.h"
 #include "uint256.h"
 
+#include <atomic>
+
+#include <boost/thread.hpp>
+
+namespace {
+/**
+ * A verified prime proof-of-work with the chain type and length it was found
+ * to have. Only the salted key takes part in lookups.
+ */
+struct CPowCacheEntry
+{
+    uint256 key;
+    uint32_t nChainType;
+    uint32_t nChainLength;
+
+    CPowCacheEntry() : nChainType(0), nChainLength(0) {}
+
+    bool operator==(const CPowCacheEntry& other) const { return key == other.key; }
+};
+
+/** Same as SignatureCacheHasher: the key is a nonced hash, so its bytes are used directly */
+class PowCacheHasher
+{
+public:
+    template <uint8_t hash_select>
+    uint32_t operator()(const CPowCacheEntry& entry) const
+    {
+        static_assert(hash_select <8, "PowCacheHasher only has 8 hashes available.");
+        uint32_t u;
+        std::memcpy(&u, entry.key.begin()+4*hash_select, 4);
+        return u;
+    }
+};
+
+/**
+ * Valid proof-of-work cache, to avoid running the prime chain test again for
+ * a block already checked as a header, by ProcessNewBlock, by CheckBlock and
+ * TestBlockValidity, or by the pool
+ */
+class CPowCache
+{
+private:
+    //! Keys are SHA256(nonce || header hash || nBits || min length || multiplier):
+    uint256 nonce;
+    typedef CuckooCache::cache<CPowCacheEntry, PowCacheHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_powcache;
+
+public:
+    //! Lookups answered from the cache
+    std::atomic<uint64_t> nHits;
+
+    CPowCache() : nHits(0)
+    {
+        GetRandBytes(nonce.begin(), 32);
+    }
+
+    void
+    ComputeEntry(CPowCacheEntry& entry, const uint256& hashBlockHeader, unsigned int nBits, unsigned int nTargetMinLength, const CBigNum& bnPrimeChainMultiplier)
+    {
+        unsigned char buf[8];
+        WriteLE32(buf, nBits);
+        WriteLE32(buf + 4, nTargetMinLength);
+        CSHA256 hasher;
+        hasher.Write(nonce.begin(), 32).Write(hashBlockHeader.begin(), 32).Write(buf, sizeof(buf));
+
+        // The multiplier goes in as its length prefixed MPI form, built on
+        // the stack: every proof-of-work checked comes through here
+        unsigned char bufMultiplier[4 + CBigNum::SERIALIZE_STACK_BYTES];
+        unsigned int nSize = BN_bn2mpi(&bnPrimeChainMultiplier, nullptr);
+        if (nSize <= sizeof(bufMultiplier)) {
+            BN_bn2mpi(&bnPrimeChainMultiplier, bufMultiplier);
+            hasher.Write(bufMultiplier, nSize);
+        } else {
+            // Too large to be a valid proof-of-work
+            std::vector<unsigned char> vchMultiplier(nSize);
+            BN_bn2mpi(&bnPrimeChainMultiplier, &vchMultiplier[0]);
+            hasher.Write(&vchMultiplier[0], nSize);
+        }
+        hasher.Finalize(entry.key.begin());
+    }
+
+    bool
+    Get(CPowCacheEntry& entry)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_powcache);
+        if (!setValid.get(entry, false))
+            return false;
+        nHits++;
+        return true;
+    }
+
+    void Set(const CPowCacheEntry& entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_powcache);
+        setValid.insert(entry);
+    }
+    uint32_t setup_bytes(size_t n)
+    {
+        return setValid.setup_bytes(n);
+    }
+};
+
+static CPowCache powCache;
+} // namespace
+
+// To be called once in AppInitMain/BasicTestingSetup to initialize the
+// powCache.
+void InitPowCache()
+{
+    // nMaxCacheSize is unsigned. If -maxpowcachesize is set to zero,
+    // setup_bytes creates the minimum possible cache (2 elements).
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, gArgs.GetArg("-maxpowcachesize", DEFAULT_MAX_POW_CACHE_SIZE)), MAX_MAX_POW_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nElems = powCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for proof-of-work cache, able to store %zu elements\n",
+            (nElems*sizeof(CPowCacheEntry)) >>20, nMaxCacheSize>>20, nElems);
+}
+
+uint64_t GetPowCacheHits()
+{
+    return powCache.nHits;
+}
+
 unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params& params)
 {
 	//DATACOIN OPTIMIZE? В тестах при нереалистичных входных (pindexPrev->nBits==0) и nActualSpacing==0 
@@ -69,8 +196,20 @@ unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nF
 
 bool CheckProofOfWork(uint256 hashBlockHeader, unsigned int nBits, const Consensus::Params& params, const CBigNum& bnProbablePrime, unsigned int& nChainType, unsigned int& nChainLength, bool fSilent)
 {
+    CPowCacheEntry entry;
+    powCache.ComputeEntry(entry, hashBlockHeader, nBits, params.nTargetMinLength, bnProbablePrime);
+    if (powCache.Get(entry))
+    {
+        nChainType = entry.nChainType;
+        nChainLength = entry.nChainLength;
+        return true;
+    }
+
     if (!CheckPrimeProofOfWork(hashBlockHeader, nBits, bnProbablePrime, nChainType, nChainLength, fSilent))
         return fSilent ? false : error("CheckProofOfWork() : check failed for prime proof-of-work");
 
+    entry.nChainType = nChainType;
+    entry.nChainLength = nChainLength;
+    powCache.Set(entry);
     return true;
 }
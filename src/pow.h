@@ -11,6 +11,11 @@
 
 #include <stdint.h>
 
+// Proof-of-work cache entries are 40 bytes, 4MB keeps around 100000 blocks
+static const unsigned int DEFAULT_MAX_POW_CACHE_SIZE = 4;
+// Maximum proof-of-work cache size allowed
+static const int64_t MAX_MAX_POW_CACHE_SIZE = 1024;
+
 class CBlockHeader;
 class CBlockIndex;
 class uint256;
@@ -18,6 +23,12 @@ class uint256;
 unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params&);
 unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nFirstBlockTime, const Consensus::Params&);
 
+/** Initializes the cache of verified proofs-of-work used by CheckProofOfWork */
+void InitPowCache();
+
+/** Number of CheckProofOfWork calls answered from the proof-of-work cache */
+uint64_t GetPowCacheHits();
+
 /** Check whether a block hash satisfies the proof-of-work requirement specified by nBits */
 bool CheckProofOfWork(uint256 hashBlockHeader, unsigned int nBits, const Consensus::Params&, const CBigNum& bnPrimeChainMultiplier, unsigned int& nChainType, unsigned int& nChainLength, bool fSilent = false);
 
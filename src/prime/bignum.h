@@ -56,6 +56,11 @@ public:
 class CBigNum : public BIGNUM
 {
 public:
+    //! Numbers up to this many bytes serialize without a heap allocation.
+    //! Prime chain multipliers are well below it: the origin is under 2^2000
+    //! and the header hash at least 2^255.
+    static const unsigned int SERIALIZE_STACK_BYTES = 256;
+
     CBigNum()
     {
         BN_init(this);
@@ -397,13 +402,36 @@ public:
 
     unsigned int GetSerializeSize(int nType=0, int nVersion=PROTOCOL_VERSION) const
     {
-        return ::GetSerializeSize(getvch(), nType, nVersion);
+        unsigned int nSize = BN_bn2mpi(this, NULL);
+        nSize = (nSize <= 4 ? 0 : nSize - 4);
+        return ::GetSizeOfCompactSize(nSize) + nSize;
     }
 
+    // Writes the same bytes as ::Serialize(s, getvch()). Block hashing goes
+    // through here, so the MPI form is built in a stack buffer and written
+    // out directly instead of through temporary vectors.
     template<typename Stream>
     void Serialize(Stream& s, int nType=0, int nVersion=PROTOCOL_VERSION) const
     {
-        ::Serialize(s, getvch()); //TODO: PROTOCOL_VERSION? , nType, nVersion);
+        unsigned int nSize = BN_bn2mpi(this, NULL);
+        if (nSize <= 4)
+        {
+            WriteCompactSize(s, 0);
+            return;
+        }
+        unsigned char buf[4 + SERIALIZE_STACK_BYTES];
+        std::vector<unsigned char> vchLarge;
+        unsigned char* pch = buf;
+        if (nSize > sizeof(buf))
+        {
+            vchLarge.resize(nSize);
+            pch = &vchLarge[0];
+        }
+        BN_bn2mpi(this, pch);
+        // skip the 4 byte big endian size and swap data to little endian
+        std::reverse(pch + 4, pch + nSize);
+        WriteCompactSize(s, nSize - 4);
+        s.write((const char*)(pch + 4), nSize - 4);
     }
 
     template<typename Stream>
@@ -7,6 +7,10 @@
 #include "validation.h"
 #include <climits>
 
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/tss.hpp>
+
 /**********************/
 /* PRIMECOIN PROTOCOL */
 /**********************/
@@ -17,6 +21,7 @@ unsigned int nSieveSize = nDefaultSieveSize;
 unsigned int nSieveFilterPrimes = nDefaultSieveFilterPrimes;
 unsigned int nSieveExtensions = nDefaultSieveExtensions;
 unsigned int nL1CacheSize = nDefaultL1CacheSize;
+unsigned int nSieveWeaveThreads = nDefaultSieveWeaveThreads;
 
 static unsigned int int_invert(unsigned int a, unsigned int nPrime);
 
@@ -32,7 +37,9 @@ void GeneratePrimeTable()
     nL1CacheSize = (unsigned int)  gArgs.GetArg("-l1cachesize", nDefaultL1CacheSize);
     nL1CacheSize = std::max(std::min(nL1CacheSize, nMaxL1CacheSize), nMinL1CacheSize);
     nL1CacheSize = nL1CacheSize / (nRequiredAlignment / 8) * (nRequiredAlignment / 8);
-    LogPrintf("GeneratePrimeTable() : setting nSieveExtensions = %u, nSieveSize = %u, nSieveFilterPrimes = %u, nL1CacheSize = %u\n", nSieveExtensions, nSieveSize, nSieveFilterPrimes, nL1CacheSize);
+    nSieveWeaveThreads = (unsigned int) gArgs.GetArg("-sieveweavethreads", nDefaultSieveWeaveThreads);
+    nSieveWeaveThreads = std::max(std::min(nSieveWeaveThreads, nMaxSieveWeaveThreads), 1u);
+    LogPrintf("GeneratePrimeTable() : setting nSieveExtensions = %u, nSieveSize = %u, nSieveFilterPrimes = %u, nL1CacheSize = %u, nSieveWeaveThreads = %u\n", nSieveExtensions, nSieveSize, nSieveFilterPrimes, nL1CacheSize, nSieveWeaveThreads);
 
     const unsigned nPrimeTableLimit = 1000000u;
     vPrimes.clear();
@@ -514,6 +521,196 @@ bool ProbablePrimeChainTest(const CBigNum& bnPrimeChainOrigin, unsigned int nBit
     return (nChainLengthCunningham1 >= nBits || nChainLengthCunningham2 >= nBits || nChainLengthBiTwin >= nBits);
 }
 
+/*********************************/
+/* DATACOIN PROOF-OF-WORK CHECK */
+/*********************************/
+
+// Scratch state of the GMP proof-of-work verifier
+// Each validating thread keeps its own instance so that the limbs of the
+// temporaries are allocated once and reused for every block checked.
+class CPrimeVerifyParams
+{
+public:
+    mpz_class mpzHash;
+    mpz_class mpzMultiplier;
+    mpz_class mpzOrigin;
+    mpz_class mpzOriginHalf;
+    mpz_class mpzOriginMinusOne;
+    mpz_class mpzOriginPlusOne;
+    mpz_class mpzN;
+    mpz_class mpzNMinusOne;
+    mpz_class mpzE;
+    mpz_class mpzR;
+    mpz_class mpzR2;
+    mpz_class mpzFrac;
+    std::vector<unsigned char> vchMultiplier;
+};
+
+static boost::thread_specific_ptr<CPrimeVerifyParams> pverifyparams;
+
+static CPrimeVerifyParams& GetPrimeVerifyParams()
+{
+    CPrimeVerifyParams* pparams = pverifyparams.get();
+    if (!pparams)
+    {
+        pparams = new CPrimeVerifyParams();
+        pverifyparams.reset(pparams);
+    }
+    return *pparams;
+}
+
+// Convert an OpenSSL bignum into GMP without going through its MPI format
+static void MultiplierToMpz(const CBigNum& bn, mpz_class& mpz, std::vector<unsigned char>& vch)
+{
+    const unsigned int nSize = BN_num_bytes(&bn);
+    vch.resize(nSize);
+    if (nSize > 0)
+        BN_bn2bin(&bn, &vch[0]);
+    mpz_import(mpz.get_mpz_t(), nSize, 1, 1, 1, 0, vch.data());
+    if (BN_is_negative(&bn))
+        mpz_neg(mpz.get_mpz_t(), mpz.get_mpz_t());
+}
+
+// Set fractional length from the Fermat test remainder r = 2 ** (n-1) mod n
+// Always returns false, so that callers can return its result directly
+static bool FermatFractionalLengthVerify(const mpz_class& n, const mpz_class& r, unsigned int& nLength, CPrimeVerifyParams& params, const char* pszTest)
+{
+    mpz_class& mpzFrac = params.mpzFrac;
+    mpzFrac = n - r;
+    mpzFrac <<= nFractionalBits;
+    mpzFrac /= n;
+    if (mpzFrac >= (1 << nFractionalBits))
+        return error("%s : fractional assert", pszTest);
+    nLength = (nLength & TARGET_LENGTH_MASK) | (unsigned int)mpzFrac.get_ui();
+    return false;
+}
+
+// Check Fermat probable primality test (2-PRP): 2 ** (n-1) = 1 (mod n)
+// true: n is probable prime
+// false: n is composite; set fractional length in the nLength output
+static bool FermatProbablePrimalityTestVerify(const mpz_class& n, unsigned int& nLength, CPrimeVerifyParams& params)
+{
+    mpz_class& mpzE = params.mpzE;
+    mpz_class& mpzR = params.mpzR;
+    mpzE = n - 1;
+    mpz_powm(mpzR.get_mpz_t(), mpzTwo.get_mpz_t(), mpzE.get_mpz_t(), n.get_mpz_t());
+    if (mpzR == 1)
+        return true;
+    return FermatFractionalLengthVerify(n, mpzR, nLength, params, "FermatProbablePrimalityTest()");
+}
+
+// Test probable Cunningham Chain for: n
+// Computes both the Euler-Lagrange-Lifchitz chain length and the Fermat-only
+// chain length of the double check in one pass. The Fermat remainder
+// 2 ** (N-1) is the square of the Euler-Lagrange-Lifchitz remainder
+// 2 ** ((N-1)/2), so the Fermat-only chain only has to be followed further
+// when a number passes the Fermat test but fails the stronger test.
+static void ProbableCunninghamChainTestVerify(const mpz_class& n, bool fSophieGermain, unsigned int& nProbableChainLength, unsigned int& nProbableChainLengthFermat, CPrimeVerifyParams& params)
+{
+    mpz_class& N = params.mpzN;
+    mpz_class& mpzNMinusOne = params.mpzNMinusOne;
+    mpz_class& mpzE = params.mpzE;
+    mpz_class& mpzR = params.mpzR;
+    mpz_class& mpzR2 = params.mpzR2;
+    nProbableChainLength = 0;
+    nProbableChainLengthFermat = 0;
+
+    // Fermat test for n first, shared by both chains
+    if (!FermatProbablePrimalityTestVerify(n, nProbableChainLength, params))
+    {
+        nProbableChainLengthFermat = nProbableChainLength;
+        return;
+    }
+
+    // Euler-Lagrange-Lifchitz test for the following numbers in chain
+    N = n;
+    while (true)
+    {
+        TargetIncrementLength(nProbableChainLength);
+        N <<= 1;
+        N += (fSophieGermain? 1 : (-1));
+        mpzNMinusOne = N - 1;
+        mpzE = mpzNMinusOne >> 1;
+        mpz_powm(mpzR.get_mpz_t(), mpzTwo.get_mpz_t(), mpzE.get_mpz_t(), N.get_mpz_t());
+        unsigned int nMod8 = N.get_ui() % 8;
+        bool fValidTest = true;
+        bool fPassedTest = false;
+        if (fSophieGermain && nMod8 == 7) // Euler & Lagrange
+            fPassedTest = (mpzR == 1);
+        else if (fSophieGermain && nMod8 == 3) // Lifchitz
+            fPassedTest = (mpzR == mpzNMinusOne);
+        else if (!fSophieGermain && nMod8 == 5) // Lifchitz
+            fPassedTest = (mpzR == mpzNMinusOne);
+        else if (!fSophieGermain && nMod8 == 1) // LifChitz
+            fPassedTest = (mpzR == 1);
+        else
+            fValidTest = error("EulerLagrangeLifchitzPrimalityTest() : invalid n %% 8 = %d, %s", nMod8, (fSophieGermain? "first kind" : "second kind"));
+
+        if (fPassedTest)
+            continue;
+
+        // Failed test, derive Fermat test remainder
+        const unsigned int nLengthBefore = nProbableChainLength;
+        mpzR2 = mpzR * mpzR;
+        mpzR2 %= N;
+        if (fValidTest)
+            FermatFractionalLengthVerify(N, mpzR2, nProbableChainLength, params, "EulerLagrangeLifchitzPrimalityTest()");
+
+        nProbableChainLengthFermat = nLengthBefore;
+        if (mpzR2 != 1)
+        {
+            FermatFractionalLengthVerify(N, mpzR2, nProbableChainLengthFermat, params, "FermatProbablePrimalityTest()");
+            return;
+        }
+        break;
+    }
+
+    // N passed the Fermat test only, continue the Fermat-only chain
+    while (true)
+    {
+        TargetIncrementLength(nProbableChainLengthFermat);
+        N <<= 1;
+        N += (fSophieGermain? 1 : (-1));
+        if (!FermatProbablePrimalityTestVerify(N, nProbableChainLengthFermat, params))
+            break;
+    }
+}
+
+// BiTwin Chain allows a single prime at the end for odd length chain
+static unsigned int BiTwinChainLength(unsigned int nChainLengthCunningham1, unsigned int nChainLengthCunningham2)
+{
+    return (TargetGetLength(nChainLengthCunningham1) > TargetGetLength(nChainLengthCunningham2))?
+            (nChainLengthCunningham2 + TargetFromInt(TargetGetLength(nChainLengthCunningham2)+1)) :
+            (nChainLengthCunningham1 + TargetFromInt(TargetGetLength(nChainLengthCunningham1)));
+}
+
+static bool ProbablePrimeChainTestVerify(const mpz_class& mpzPrimeChainOrigin, unsigned int nBits, unsigned int& nChainLengthCunningham1, unsigned int& nChainLengthCunningham2, unsigned int& nChainLengthBiTwin, unsigned int& nChainLengthCunningham1FermatTest, unsigned int& nChainLengthCunningham2FermatTest, unsigned int& nChainLengthBiTwinFermatTest, CPrimeVerifyParams& params)
+{
+    mpz_class& mpzOriginMinusOne = params.mpzOriginMinusOne;
+    mpz_class& mpzOriginPlusOne = params.mpzOriginPlusOne;
+
+    // Test for Cunningham Chain of first kind
+    mpzOriginMinusOne = mpzPrimeChainOrigin - 1;
+    ProbableCunninghamChainTestVerify(mpzOriginMinusOne, true, nChainLengthCunningham1, nChainLengthCunningham1FermatTest, params);
+    // Test for Cunningham Chain of second kind
+    mpzOriginPlusOne = mpzPrimeChainOrigin + 1;
+    ProbableCunninghamChainTestVerify(mpzOriginPlusOne, false, nChainLengthCunningham2, nChainLengthCunningham2FermatTest, params);
+    // Figure out BiTwin Chain length
+    nChainLengthBiTwin = BiTwinChainLength(nChainLengthCunningham1, nChainLengthCunningham2);
+    nChainLengthBiTwinFermatTest = BiTwinChainLength(nChainLengthCunningham1FermatTest, nChainLengthCunningham2FermatTest);
+
+    return (nChainLengthCunningham1 >= nBits || nChainLengthCunningham2 >= nBits || nChainLengthBiTwin >= nBits);
+}
+
+// Test probable prime chain for: mpzPrimeChainOrigin
+// GMP counterpart of ProbablePrimeChainTest() returning the lengths of both
+// the Euler-Lagrange-Lifchitz and the Fermat-only tests
+bool ProbablePrimeChainTestVerify(const mpz_class& mpzPrimeChainOrigin, unsigned int nBits, unsigned int& nChainLengthCunningham1, unsigned int& nChainLengthCunningham2, unsigned int& nChainLengthBiTwin, unsigned int& nChainLengthCunningham1FermatTest, unsigned int& nChainLengthCunningham2FermatTest, unsigned int& nChainLengthBiTwinFermatTest)
+{
+    return ProbablePrimeChainTestVerify(mpzPrimeChainOrigin, nBits, nChainLengthCunningham1, nChainLengthCunningham2, nChainLengthBiTwin,
+        nChainLengthCunningham1FermatTest, nChainLengthCunningham2FermatTest, nChainLengthBiTwinFermatTest, GetPrimeVerifyParams());
+}
+
 // Check prime proof-of-work
 bool CheckPrimeProofOfWork(uint256 hashBlockHeader, unsigned int nBits, const CBigNum& bnPrimeChainMultiplier, unsigned int& nChainType, unsigned int& nChainLength, bool fSilent)
 {
@@ -524,37 +721,44 @@ bool CheckPrimeProofOfWork(uint256 hashBlockHeader, unsigned int nBits, const CB
     // Check header hash limit
     if (UintToArith256(hashBlockHeader) < hashBlockHeaderLimit) //DATACOIN OPTIMIZE?
         return error("CheckPrimeProofOfWork() : block header hash under limit");
+
+    CPrimeVerifyParams& params = GetPrimeVerifyParams();
+    mpz_class& mpzPrimeChainOrigin = params.mpzOrigin;
+    mpz_class& mpzPrimeChainMultiplier = params.mpzMultiplier;
+    mpz_set_uint256(params.mpzHash.get_mpz_t(), hashBlockHeader);
+    MultiplierToMpz(bnPrimeChainMultiplier, mpzPrimeChainMultiplier, params.vchMultiplier);
+
     // Check target for prime proof-of-work
-    CBigNum bnPrimeChainOrigin = CBigNum(hashBlockHeader) * bnPrimeChainMultiplier;
-    if (bnPrimeChainOrigin < bnPrimeMin)
+    mpzPrimeChainOrigin = params.mpzHash * mpzPrimeChainMultiplier;
+    if (mpzPrimeChainOrigin < mpzPrimeMin)
         return error("CheckPrimeProofOfWork() : prime too small");
     // First prime in chain must not exceed cap
-    if (bnPrimeChainOrigin > bnPrimeMax)
+    if (mpzPrimeChainOrigin > mpzPrimeMax)
         return error("CheckPrimeProofOfWork() : prime too big");
 
-    // Check prime chain
+    // Check prime chain and double check it with Fermat tests only
     unsigned int nChainLengthCunningham1 = 0;
     unsigned int nChainLengthCunningham2 = 0;
     unsigned int nChainLengthBiTwin = 0;
-    if (!ProbablePrimeChainTest(bnPrimeChainOrigin, nBits, false, nChainLengthCunningham1, nChainLengthCunningham2, nChainLengthBiTwin))
+    unsigned int nChainLengthCunningham1FermatTest = 0;
+    unsigned int nChainLengthCunningham2FermatTest = 0;
+    unsigned int nChainLengthBiTwinFermatTest = 0;
+    if (!ProbablePrimeChainTestVerify(mpzPrimeChainOrigin, nBits, nChainLengthCunningham1, nChainLengthCunningham2, nChainLengthBiTwin,
+            nChainLengthCunningham1FermatTest, nChainLengthCunningham2FermatTest, nChainLengthBiTwinFermatTest, params))
         return fSilent ? false : error("CheckPrimeProofOfWork() : failed prime chain test target=%s length=(%s %s %s)", TargetToString(nBits).c_str(),
             TargetToString(nChainLengthCunningham1).c_str(), TargetToString(nChainLengthCunningham2).c_str(), TargetToString(nChainLengthBiTwin).c_str());
     if (nChainLengthCunningham1 < nBits && nChainLengthCunningham2 < nBits && nChainLengthBiTwin < nBits)
         return error("CheckPrimeProofOfWork() : prime chain length assert target=%s length=(%s %s %s)", TargetToString(nBits).c_str(),
             TargetToString(nChainLengthCunningham1).c_str(), TargetToString(nChainLengthCunningham2).c_str(), TargetToString(nChainLengthBiTwin).c_str());
 
-    // Double check prime chain with Fermat tests only
-    unsigned int nChainLengthCunningham1FermatTest = 0;
-    unsigned int nChainLengthCunningham2FermatTest = 0;
-    unsigned int nChainLengthBiTwinFermatTest = 0;
-    if (!ProbablePrimeChainTest(bnPrimeChainOrigin, nBits, true, nChainLengthCunningham1FermatTest, nChainLengthCunningham2FermatTest, nChainLengthBiTwinFermatTest))
+    if (nChainLengthCunningham1FermatTest < nBits && nChainLengthCunningham2FermatTest < nBits && nChainLengthBiTwinFermatTest < nBits)
         return error("CheckPrimeProofOfWork() : failed Fermat test target=%s length=(%s %s %s) lengthFermat=(%s %s %s)", TargetToString(nBits).c_str(),
             TargetToString(nChainLengthCunningham1).c_str(), TargetToString(nChainLengthCunningham2).c_str(), TargetToString(nChainLengthBiTwin).c_str(),
             TargetToString(nChainLengthCunningham1FermatTest).c_str(), TargetToString(nChainLengthCunningham2FermatTest).c_str(), TargetToString(nChainLengthBiTwinFermatTest).c_str());
     if (nChainLengthCunningham1 != nChainLengthCunningham1FermatTest ||
         nChainLengthCunningham2 != nChainLengthCunningham2FermatTest ||
         nChainLengthBiTwin != nChainLengthBiTwinFermatTest)
-        return error("CheckPrimeProofOfWork() : failed Fermat-only double check target=%s length=(%s %s %s) lengthFermat=(%s %s %s)", TargetToString(nBits).c_str(), 
+        return error("CheckPrimeProofOfWork() : failed Fermat-only double check target=%s length=(%s %s %s) lengthFermat=(%s %s %s)", TargetToString(nBits).c_str(),
             TargetToString(nChainLengthCunningham1).c_str(), TargetToString(nChainLengthCunningham2).c_str(), TargetToString(nChainLengthBiTwin).c_str(),
             TargetToString(nChainLengthCunningham1FermatTest).c_str(), TargetToString(nChainLengthCunningham2FermatTest).c_str(), TargetToString(nChainLengthBiTwinFermatTest).c_str());
 
@@ -573,12 +777,18 @@ bool CheckPrimeProofOfWork(uint256 hashBlockHeader, unsigned int nBits, const CB
     }
 
     // Check that the certificate (bnPrimeChainMultiplier) is normalized
-    if (bnPrimeChainMultiplier % 2 == 0 && bnPrimeChainOrigin % 4 == 0)
+    if (mpz_even_p(mpzPrimeChainMultiplier.get_mpz_t()) && mpz_divisible_2exp_p(mpzPrimeChainOrigin.get_mpz_t(), 2))
     {
         unsigned int nChainLengthCunningham1Extended = 0;
         unsigned int nChainLengthCunningham2Extended = 0;
         unsigned int nChainLengthBiTwinExtended = 0;
-        if (ProbablePrimeChainTest(bnPrimeChainOrigin / 2, nBits, false, nChainLengthCunningham1Extended, nChainLengthCunningham2Extended, nChainLengthBiTwinExtended))
+        unsigned int nChainLengthCunningham1ExtendedFermatTest = 0;
+        unsigned int nChainLengthCunningham2ExtendedFermatTest = 0;
+        unsigned int nChainLengthBiTwinExtendedFermatTest = 0;
+        mpz_class& mpzPrimeChainOriginHalf = params.mpzOriginHalf;
+        mpzPrimeChainOriginHalf = mpzPrimeChainOrigin >> 1;
+        if (ProbablePrimeChainTestVerify(mpzPrimeChainOriginHalf, nBits, nChainLengthCunningham1Extended, nChainLengthCunningham2Extended, nChainLengthBiTwinExtended,
+                nChainLengthCunningham1ExtendedFermatTest, nChainLengthCunningham2ExtendedFermatTest, nChainLengthBiTwinExtendedFermatTest, params))
         { // try extending down the primechain with a halved multiplier
             if (nChainLengthCunningham1Extended > nChainLength || nChainLengthCunningham2Extended > nChainLength || nChainLengthBiTwinExtended > nChainLength)
                 return error("CheckPrimeProofOfWork() : prime certificate not normalzied target=%s length=(%s %s %s) extend=(%s %s %s)",
@@ -719,12 +929,14 @@ static bool EulerLagrangeLifchitzPrimalityTestFast(const mpz_class& n, bool fSop
 // fSophieGermain:
 //   true - Test for Cunningham Chain of first kind (n, 2n+1, 4n+3, ...)
 //   false - Test for Cunningham Chain of second kind (n, 2n-1, 4n-3, ...)
-static void ProbableCunninghamChainTestFast(const mpz_class& n, bool fSophieGermain, unsigned int& nProbableChainLength, CPrimalityTestParams& testParams)
+// fFirstTestPassed: n is already known to pass the Fermat test
+// nMaxLength: stop testing once the chain is this long
+static void ProbableCunninghamChainTestFast(const mpz_class& n, bool fSophieGermain, unsigned int& nProbableChainLength, CPrimalityTestParams& testParams, bool fFirstTestPassed = false, unsigned int nMaxLength = TARGET_LENGTH_MASK)
 {
     nProbableChainLength = 0;
 
     // Fermat test for n first
-    if (!FermatProbablePrimalityTestFast(n, nProbableChainLength, testParams, true))
+    if (!fFirstTestPassed && !FermatProbablePrimalityTestFast(n, nProbableChainLength, testParams, true))
         return;
 
     // Euler-Lagrange-Lifchitz test for the following numbers in chain
@@ -733,6 +945,8 @@ static void ProbableCunninghamChainTestFast(const mpz_class& n, bool fSophieGerm
     for (unsigned int nChainSeq = 1; true; nChainSeq++)
     {
         TargetIncrementLength(nProbableChainLength);
+        if (nProbableChainLength >= nMaxLength)
+            break;
         N <<= 1;
         N += (fSophieGermain? 1 : (-1));
         bool fFastFail = nChainSeq < 4;
@@ -744,7 +958,9 @@ static void ProbableCunninghamChainTestFast(const mpz_class& n, bool fSophieGerm
 // Test Probable BiTwin Chain for: mpzOrigin
 // Test the numbers in the optimal order for any given chain length
 // Gives the correct length of a BiTwin chain even for short chains
-static void ProbableBiTwinChainTestFast(const mpz_class& mpzOrigin, unsigned int& nProbableChainLength, CPrimalityTestParams& testParams)
+// fFirstTestPassed: origin-1 is already known to pass the Fermat test
+// nMaxLength: stop testing once the chain is this long
+static void ProbableBiTwinChainTestFast(const mpz_class& mpzOrigin, unsigned int& nProbableChainLength, CPrimalityTestParams& testParams, bool fFirstTestPassed = false, unsigned int nMaxLength = TARGET_LENGTH_MASK)
 {
     mpz_class& mpzOriginMinusOne = testParams.mpzOriginMinusOne;
     mpz_class& mpzOriginPlusOne = testParams.mpzOriginPlusOne;
@@ -752,15 +968,19 @@ static void ProbableBiTwinChainTestFast(const mpz_class& mpzOrigin, unsigned int
 
     // Fermat test for origin-1 first
     mpzOriginMinusOne = mpzOrigin - 1;
-    if (!FermatProbablePrimalityTestFast(mpzOriginMinusOne, nProbableChainLength, testParams, true))
+    if (!fFirstTestPassed && !FermatProbablePrimalityTestFast(mpzOriginMinusOne, nProbableChainLength, testParams, true))
         return;
     TargetIncrementLength(nProbableChainLength);
+    if (nProbableChainLength >= nMaxLength)
+        return;
 
     // Fermat test for origin+1
     mpzOriginPlusOne = mpzOrigin + 1;
     if (!FermatProbablePrimalityTestFast(mpzOriginPlusOne, nProbableChainLength, testParams, true))
         return;
     TargetIncrementLength(nProbableChainLength);
+    if (nProbableChainLength >= nMaxLength)
+        return;
 
     // Euler-Lagrange-Lifchitz test for the following numbers in chain
     for (unsigned int nChainSeq = 2; true; nChainSeq += 2)
@@ -771,20 +991,26 @@ static void ProbableBiTwinChainTestFast(const mpz_class& mpzOrigin, unsigned int
         if (!EulerLagrangeLifchitzPrimalityTestFast(mpzOriginMinusOne, true, nProbableChainLength, testParams, fFastFail))
             break;
         TargetIncrementLength(nProbableChainLength);
+        if (nProbableChainLength >= nMaxLength)
+            break;
 
         mpzOriginPlusOne <<= 1;
         mpzOriginPlusOne--;
         if (!EulerLagrangeLifchitzPrimalityTestFast(mpzOriginPlusOne, false, nProbableChainLength, testParams, fFastFail))
             break;
         TargetIncrementLength(nProbableChainLength);
+        if (nProbableChainLength >= nMaxLength)
+            break;
     }
 }
 
 // Test probable prime chain for: nOrigin
+// fFirstTestPassed: the first number of the chain is already known to pass
+// the Fermat test, see TestPrimalityBatch()
 // Return value:
 //   true - Probable prime chain found (one of nChainLength meeting target)
 //   false - prime chain too short (none of nChainLength meeting target)
-static bool ProbablePrimeChainTestFast(const mpz_class& mpzPrimeChainOrigin, CPrimalityTestParams& testParams)
+static bool ProbablePrimeChainTestFast(const mpz_class& mpzPrimeChainOrigin, CPrimalityTestParams& testParams, bool fFirstTestPassed = false)
 {
     const unsigned int nBits = testParams.nBits;
     const unsigned int nCandidateType = testParams.nCandidateType;
@@ -797,22 +1023,77 @@ static bool ProbablePrimeChainTestFast(const mpz_class& mpzPrimeChainOrigin, CPr
     if (nCandidateType == PRIME_CHAIN_CUNNINGHAM1)
     {
         mpzOriginMinusOne = mpzPrimeChainOrigin - 1;
-        ProbableCunninghamChainTestFast(mpzOriginMinusOne, true, nChainLength, testParams);
+        ProbableCunninghamChainTestFast(mpzOriginMinusOne, true, nChainLength, testParams, fFirstTestPassed);
     }
     else if (nCandidateType == PRIME_CHAIN_CUNNINGHAM2)
     {
         // Test for Cunningham Chain of second kind
         mpzOriginPlusOne = mpzPrimeChainOrigin + 1;
-        ProbableCunninghamChainTestFast(mpzOriginPlusOne, false, nChainLength, testParams);
+        ProbableCunninghamChainTestFast(mpzOriginPlusOne, false, nChainLength, testParams, fFirstTestPassed);
     }
     else if (nCandidateType == PRIME_CHAIN_BI_TWIN)
     {
-        ProbableBiTwinChainTestFast(mpzPrimeChainOrigin, nChainLength, testParams);
+        ProbableBiTwinChainTestFast(mpzPrimeChainOrigin, nChainLength, testParams, fFirstTestPassed);
     }
 
     return (nChainLength >= nBits);
 }
 
+// Test the chain of one type of nOrigin, up to nMaxLength
+static void ProbablePrimeChainTestShare(const mpz_class& mpzPrimeChainOrigin, unsigned int nChainType, unsigned int nMaxLength, unsigned int& nChainLength, CPrimalityTestParams& testParams)
+{
+    nChainLength = 0;
+    if (nChainType == PRIME_CHAIN_CUNNINGHAM1)
+    {
+        testParams.mpzOriginMinusOne = mpzPrimeChainOrigin - 1;
+        ProbableCunninghamChainTestFast(testParams.mpzOriginMinusOne, true, nChainLength, testParams, false, nMaxLength);
+    }
+    else if (nChainType == PRIME_CHAIN_CUNNINGHAM2)
+    {
+        testParams.mpzOriginPlusOne = mpzPrimeChainOrigin + 1;
+        ProbableCunninghamChainTestFast(testParams.mpzOriginPlusOne, false, nChainLength, testParams, false, nMaxLength);
+    }
+    else if (nChainType == PRIME_CHAIN_BI_TWIN)
+    {
+        ProbableBiTwinChainTestFast(mpzPrimeChainOrigin, nChainLength, testParams, false, nMaxLength);
+    }
+}
+
+bool CheckPrimeShare(uint256 hashBlockHeader, const CBigNum& bnPrimeChainMultiplier, unsigned int nChainType, unsigned int nMinLength, unsigned int& nChainLength, CPrimalityTestParams& testParams)
+{
+    nChainLength = 0;
+    if (nChainType < PRIME_CHAIN_CUNNINGHAM1 || nChainType > PRIME_CHAIN_BI_TWIN)
+        return false;
+    if (UintToArith256(hashBlockHeader) < hashBlockHeaderLimit)
+        return false;
+
+    CPrimeVerifyParams& params = GetPrimeVerifyParams();
+    mpz_class& mpzPrimeChainOrigin = params.mpzOrigin;
+    mpz_class& mpzPrimeChainMultiplier = params.mpzMultiplier;
+    mpz_set_uint256(params.mpzHash.get_mpz_t(), hashBlockHeader);
+    MultiplierToMpz(bnPrimeChainMultiplier, mpzPrimeChainMultiplier, params.vchMultiplier);
+    mpzPrimeChainOrigin = params.mpzHash * mpzPrimeChainMultiplier;
+    if (mpzPrimeChainOrigin < mpzPrimeMin || mpzPrimeChainOrigin > mpzPrimeMax)
+        return false;
+
+    ProbablePrimeChainTestShare(mpzPrimeChainOrigin, nChainType, nMinLength, nChainLength, testParams);
+    if (nChainLength < nMinLength)
+        return false;
+
+    // A share with a doubled multiplier would repeat the tail of the chain
+    // of the halved one, see the normalization check of CheckPrimeProofOfWork
+    if (mpz_even_p(mpzPrimeChainMultiplier.get_mpz_t()) && mpz_divisible_2exp_p(mpzPrimeChainOrigin.get_mpz_t(), 2))
+    {
+        unsigned int nChainLengthExtended = 0;
+        params.mpzOriginHalf = mpzPrimeChainOrigin >> 1;
+        ProbablePrimeChainTestShare(params.mpzOriginHalf, nChainType, nChainLength + (1 << nFractionalBits), nChainLengthExtended, testParams);
+        if (TargetGetLength(nChainLengthExtended) > TargetGetLength(nChainLength))
+            return false;
+    }
+
+    return true;
+}
+
 // Perform Fermat test with trial division
 // Return values:
 //   true  - passes trial division test and Fermat test; probable prime
@@ -840,6 +1121,86 @@ bool ProbablePrimalityTestWithTrialDivision(const mpz_class& mpzCandidate, unsig
     return (FermatProbablePrimalityTestFast(mpzCandidate, nLength, testParams, true));
 }
 
+// Reserve the GMP variables of the primality tests once for the size of the
+// numbers of the round, so that they are not reallocated while testing
+static void ReservePrimalityTestLimbs(CPrimalityTestParams& testParams)
+{
+    CPrimalityTestBatch& batch = testParams.batch;
+    // Room for the multiplier and the doublings along the chain
+    const size_t nLimbs = mpz_size(testParams.mpzHashFixedMult.get_mpz_t()) + 2;
+    if (nLimbs <= batch.nRoundLimbs)
+        return;
+    batch.nRoundLimbs = nLimbs;
+    const mp_bitcnt_t nBits = nLimbs * GMP_NUMB_BITS;
+    mpz_realloc2(batch.mpzOrigin.get_mpz_t(), nBits);
+    for (unsigned int i = 0; i < CPrimalityTestBatch::nMaxSize; i++)
+        mpz_realloc2(batch.vOrigins[i].get_mpz_t(), nBits);
+    mpz_realloc2(testParams.mpzOriginMinusOne.get_mpz_t(), nBits);
+    mpz_realloc2(testParams.mpzOriginPlusOne.get_mpz_t(), nBits);
+    mpz_realloc2(testParams.mpzN.get_mpz_t(), nBits);
+    mpz_realloc2(testParams.mpzNMinusOne.get_mpz_t(), nBits);
+    mpz_realloc2(testParams.mpzE.get_mpz_t(), nBits);
+    mpz_realloc2(testParams.mpzR.get_mpz_t(), nBits);
+    mpz_realloc2(testParams.mpzR2.get_mpz_t(), 2 * nBits);
+    mpz_realloc2(testParams.mpzFrac.get_mpz_t(), nBits + nFractionalBits);
+}
+
+// Take up to nMaxCandidates candidates from the sieve into the batch
+// Return values:
+//   true  - the sieve may have more candidates
+//   false - the sieve is depleted
+static bool FillPrimalityTestBatch(CSieveOfEratosthenes& sieve, unsigned int nMaxCandidates, CPrimalityTestBatch& batch)
+{
+    batch.nSize = 0;
+    while (batch.nSize < nMaxCandidates)
+    {
+        unsigned int& nMultiplier = batch.vMultipliers[batch.nSize];
+        unsigned int& nCandidateType = batch.vCandidateTypes[batch.nSize];
+        if (!sieve.GetNextCandidateMultiplier(nMultiplier, nCandidateType))
+            return false;
+        batch.nSize++;
+    }
+    return true;
+}
+
+// Compute the chain origins of the batch and run the first Fermat test of
+// every chain: origin-1 for Cunningham chains of the first kind and BiTwin
+// chains, origin+1 for Cunningham chains of the second kind
+static void TestPrimalityBatch(CPrimalityTestParams& testParams)
+{
+    CPrimalityTestBatch& batch = testParams.batch;
+    mpz_class& mpzOrigin = batch.mpzOrigin;
+    mpz_class& mpzOriginMinusOne = testParams.mpzOriginMinusOne;
+    mpz_class& mpzOriginPlusOne = testParams.mpzOriginPlusOne;
+    for (unsigned int i = 0; i < batch.nSize; i++)
+    {
+        // The multipliers increase through the sieve and through each
+        // extension, so the origin mostly moves forward by a small step
+        const unsigned int nMultiplier = batch.vMultipliers[i];
+        if (batch.nOriginMultiplier != 0 && nMultiplier > batch.nOriginMultiplier)
+            mpz_addmul_ui(mpzOrigin.get_mpz_t(), testParams.mpzHashFixedMult.get_mpz_t(), nMultiplier - batch.nOriginMultiplier);
+        else
+            mpz_mul_ui(mpzOrigin.get_mpz_t(), testParams.mpzHashFixedMult.get_mpz_t(), nMultiplier);
+        batch.nOriginMultiplier = nMultiplier;
+        batch.vOrigins[i] = mpzOrigin;
+
+        unsigned int nLength = 0;
+        const unsigned int nCandidateType = batch.vCandidateTypes[i];
+        if (nCandidateType == PRIME_CHAIN_CUNNINGHAM1 || nCandidateType == PRIME_CHAIN_BI_TWIN)
+        {
+            mpz_sub_ui(mpzOriginMinusOne.get_mpz_t(), mpzOrigin.get_mpz_t(), 1);
+            batch.vfFirstTestPassed[i] = FermatProbablePrimalityTestFast(mpzOriginMinusOne, nLength, testParams, true);
+        }
+        else if (nCandidateType == PRIME_CHAIN_CUNNINGHAM2)
+        {
+            mpz_add_ui(mpzOriginPlusOne.get_mpz_t(), mpzOrigin.get_mpz_t(), 1);
+            batch.vfFirstTestPassed[i] = FermatProbablePrimalityTestFast(mpzOriginPlusOne, nLength, testParams, true);
+        }
+        else
+            batch.vfFirstTestPassed[i] = false;
+    }
+}
+
 static void SieveDebugChecks(unsigned int nBits, unsigned int nTriedMultiplier, unsigned int nCandidateType, mpz_class& mpzHash, mpz_class& mpzFixedMultiplier, mpz_class& mpzChainOrigin)
 {
     // Debugging code to verify the sieve output
@@ -905,7 +1266,7 @@ bool MineProbablePrimeChain(CBlock& block, mpz_class& mpzFixedMultiplier, bool&
     unsigned int& nChainLength = testParams.nChainLength;
     unsigned int& nCandidateType = testParams.nCandidateType;
     mpz_class& mpzHashFixedMult = testParams.mpzHashFixedMult;
-    mpz_class& mpzChainOrigin = testParams.mpzChainOrigin;
+    CPrimalityTestBatch& batch = testParams.batch;
     nBits = block.nBits;
 
     if (fNewBlock)
@@ -921,7 +1282,7 @@ bool MineProbablePrimeChain(CBlock& block, mpz_class& mpzFixedMultiplier, bool&
         // Build sieve
         if (fDebug && gArgs.GetBoolArg("-printmining", false))
             nStart = GetTimeMicros();
-        sieve.Reset(nSieveSize, nSieveFilterPrimes, nSieveExtensions, nL1CacheSize, nBits, mpzHash, mpzFixedMultiplier, pindexPrev);
+        sieve.Reset(nSieveSize, nSieveFilterPrimes, nSieveExtensions, nL1CacheSize, nBits, mpzHash, mpzFixedMultiplier, pindexPrev, nSieveWeaveThreads);
         sieve.Weave();
         if (fDebug && gArgs.GetBoolArg("-printmining", false))
             LogPrintf("MineProbablePrimeChain() : new sieve (%u/%u@%u%%) ready in %uus\n", sieve.GetCandidateCount(), nSieveSize, sieve.GetProgressPercentage(), (unsigned int) (GetTimeMicros() - nStart));
@@ -933,13 +1294,53 @@ bool MineProbablePrimeChain(CBlock& block, mpz_class& mpzFixedMultiplier, bool&
 
     // Number of candidates to be tested during a single call to this function
     const unsigned int nTestsAtOnce = 500;
+    const unsigned int nBatchSize = CPrimalityTestBatch::nMaxSize;
     mpzHashFixedMult = mpzHash * mpzFixedMultiplier;
+    ReservePrimalityTestLimbs(testParams);
+    batch.nOriginMultiplier = 0;
 
     // Process a part of the candidates
     while (nTests < nTestsAtOnce && pindexPrev == chainActive.Tip())
     {
-        unsigned int nTriedMultiplier = 0;
-        if (!sieve.GetNextCandidateMultiplier(nTriedMultiplier, nCandidateType))
+        // Run the first test of the next candidates together
+        const bool fSieveDepleted = !FillPrimalityTestBatch(sieve, std::min(nBatchSize, nTestsAtOnce - nTests), batch);
+        TestPrimalityBatch(testParams);
+
+        for (unsigned int i = 0; i < batch.nSize; i++)
+        {
+            const unsigned int nTriedMultiplier = batch.vMultipliers[i];
+            nCandidateType = batch.vCandidateTypes[i];
+            nTests++;
+            // Follow the chains that passed their first test
+            nChainLength = 0;
+            bool fChainFound = batch.vfFirstTestPassed[i] && ProbablePrimeChainTestFast(batch.vOrigins[i], testParams, true);
+            unsigned int nChainPrimeLength = TargetGetLength(nChainLength);
+
+            if (fDebug && gArgs.GetBoolArg("-debugsieve", false))
+                SieveDebugChecks(nBits, nTriedMultiplier, nCandidateType, mpzHash, mpzFixedMultiplier, batch.vOrigins[i]);
+
+            // Collect mining statistics
+            if(nChainPrimeLength >= 1)
+            {
+                nPrimesHit++;
+                vChainsFound[nChainPrimeLength - 1]++;
+            }
+
+            // Check if a chain was found
+            if (fChainFound)
+            {
+                mpz_class mpzPrimeChainMultiplier = mpzFixedMultiplier * nTriedMultiplier;
+                CBigNum bnPrimeChainMultiplier;
+                bnPrimeChainMultiplier.SetHex(mpzPrimeChainMultiplier.get_str(16));
+                block.bnPrimeChainMultiplier = bnPrimeChainMultiplier;
+                LogPrintf("nTriedMultiplier = %u\n", nTriedMultiplier); // Debugging
+                LogPrintf("Probable prime chain found for block=%s!!\n  Target: %s\n  Chain: %s\n", block.GetHash().GetHex().c_str(),
+                    TargetToString(block.nBits).c_str(), GetPrimeChainName(nCandidateType, nChainLength).c_str());
+                return true;
+            }
+        }
+
+        if (fSieveDepleted)
         {
             // power tests completed for the sieve
             if (fDebug && gArgs.GetBoolArg("-printmining2", false))
@@ -947,33 +1348,6 @@ bool MineProbablePrimeChain(CBlock& block, mpz_class& mpzFixedMultiplier, bool&
             fNewBlock = true; // notify caller to change nonce
             return false;
         }
-        nTests++;
-        mpzChainOrigin = mpzHashFixedMult * nTriedMultiplier;
-        bool fChainFound = ProbablePrimeChainTestFast(mpzChainOrigin, testParams);
-        unsigned int nChainPrimeLength = TargetGetLength(nChainLength);
-
-        if (fDebug && gArgs.GetBoolArg("-debugsieve", false))
-            SieveDebugChecks(nBits, nTriedMultiplier, nCandidateType, mpzHash, mpzFixedMultiplier, mpzChainOrigin);
-
-        // Collect mining statistics
-        if(nChainPrimeLength >= 1)
-        {
-            nPrimesHit++;
-            vChainsFound[nChainPrimeLength - 1]++;
-        }
-
-        // Check if a chain was found
-        if (fChainFound)
-        {
-            mpz_class mpzPrimeChainMultiplier = mpzFixedMultiplier * nTriedMultiplier;
-            CBigNum bnPrimeChainMultiplier;
-            bnPrimeChainMultiplier.SetHex(mpzPrimeChainMultiplier.get_str(16));
-            block.bnPrimeChainMultiplier = bnPrimeChainMultiplier;
-            LogPrintf("nTriedMultiplier = %u\n", nTriedMultiplier); // Debugging
-            LogPrintf("Probable prime chain found for block=%s!!\n  Target: %s\n  Chain: %s\n", block.GetHash().GetHex().c_str(),
-                TargetToString(block.nBits).c_str(), GetPrimeChainName(nCandidateType, nChainLength).c_str());
-            return true;
-        }
     }
     
     if (fDebug && gArgs.GetBoolArg("-printmining2", false))
@@ -1143,125 +1517,6 @@ void CSieveOfEratosthenes::ProcessMultiplier(sieve_word_t *vfComposites, const u
     }
 }
 
-inline void ApplyLayerTWNBoth(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t *vfCompositeCunningham1, sieve_word_t *vfCompositeCunningham2, sieve_word_t *vfCompositeBiTwin, sieve_word_t *vfLayerCC1, sieve_word_t *vfLayerCC2)
-{
-#if defined(USE_AVX2)
-    const sieve_word_t nMaxWordAVX2 = nMaxWord / (256 / nWordBits);
-    for (sieve_word_t nWord = nMinWord / (256 / nWordBits); nWord < nMaxWordAVX2; nWord++)
-    {
-        const __m256i xCC1Layer = ((__m256i*)vfLayerCC1)[nWord];
-        const __m256i xCC2Layer = ((__m256i*)vfLayerCC2)[nWord];
-        ((__m256i*)vfCompositeCunningham1)[nWord] |= xCC1Layer;
-        ((__m256i*)vfCompositeCunningham2)[nWord] |= xCC2Layer;
-        ((__m256i*)vfCompositeBiTwin)[nWord] |= xCC1Layer | xCC2Layer;
-    }
-#elif defined(USE_SSE2)
-    const sieve_word_t nMaxWordSSE2 = nMaxWord / (128 / nWordBits);
-    for (sieve_word_t nWord = nMinWord / (128 / nWordBits); nWord < nMaxWordSSE2; nWord++)
-    {
-        const __m128i xCC1Layer = ((__m128i*)vfLayerCC1)[nWord];
-        const __m128i xCC2Layer = ((__m128i*)vfLayerCC2)[nWord];
-        ((__m128i*)vfCompositeCunningham1)[nWord] |= xCC1Layer;
-        ((__m128i*)vfCompositeCunningham2)[nWord] |= xCC2Layer;
-        ((__m128i*)vfCompositeBiTwin)[nWord] |= xCC1Layer | xCC2Layer;
-    }
-#else
-    for (sieve_word_t nWord = nMinWord; nWord < nMaxWord; nWord++)
-    {
-        vfCompositeCunningham1[nWord] |= vfLayerCC1[nWord];
-        vfCompositeCunningham2[nWord] |= vfLayerCC2[nWord];
-        vfCompositeBiTwin[nWord] |= vfLayerCC1[nWord] | vfLayerCC2[nWord];
-    }
-#endif
-}
-
-inline void ApplyLayerTWNOnlyCC1(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t *vfCompositeCunningham1, sieve_word_t *vfCompositeCunningham2, sieve_word_t *vfCompositeBiTwin, sieve_word_t *vfLayerCC1, sieve_word_t *vfLayerCC2)
-{
-#if defined(USE_AVX2)
-    const sieve_word_t nMaxWordAVX2 = nMaxWord / (256 / nWordBits);
-    for (sieve_word_t nWord = nMinWord / (256 / nWordBits); nWord < nMaxWordAVX2; nWord++)
-    {
-        const __m256i xCC1Layer = ((__m256i*)vfLayerCC1)[nWord];
-        const __m256i xCC2Layer = ((__m256i*)vfLayerCC2)[nWord];
-        ((__m256i*)vfCompositeCunningham1)[nWord] |= xCC1Layer;
-        ((__m256i*)vfCompositeCunningham2)[nWord] |= xCC2Layer;
-        ((__m256i*)vfCompositeBiTwin)[nWord] |= xCC1Layer;
-    }
-#elif defined(USE_SSE2)
-    const sieve_word_t nMaxWordSSE2 = nMaxWord / (128 / nWordBits);
-    for (sieve_word_t nWord = nMinWord / (128 / nWordBits); nWord < nMaxWordSSE2; nWord++)
-    {
-        const __m128i xCC1Layer = ((__m128i*)vfLayerCC1)[nWord];
-        const __m128i xCC2Layer = ((__m128i*)vfLayerCC2)[nWord];
-        ((__m128i*)vfCompositeCunningham1)[nWord] |= xCC1Layer;
-        ((__m128i*)vfCompositeCunningham2)[nWord] |= xCC2Layer;
-        ((__m128i*)vfCompositeBiTwin)[nWord] |= xCC1Layer;
-    }
-#else
-        for (sieve_word_t nWord = nMinWord; nWord < nMaxWord; nWord++)
-        {
-            vfCompositeCunningham1[nWord] |= vfLayerCC1[nWord];
-            vfCompositeCunningham2[nWord] |= vfLayerCC2[nWord];
-            vfCompositeBiTwin[nWord] |= vfLayerCC1[nWord];
-        }
-#endif
-}
-
-inline void ApplyLayerTWNNone(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t *vfCompositeCunningham1, sieve_word_t *vfCompositeCunningham2, sieve_word_t *vfLayerCC1, sieve_word_t *vfLayerCC2)
-{
-#if defined(USE_AVX2)
-    const sieve_word_t nMaxWordAVX2 = nMaxWord / (256 / nWordBits);
-    for (sieve_word_t nWord = nMinWord / (256 / nWordBits); nWord < nMaxWordAVX2; nWord++)
-    {
-        const __m256i xCC1Layer = ((__m256i*)vfLayerCC1)[nWord];
-        const __m256i xCC2Layer = ((__m256i*)vfLayerCC2)[nWord];
-        ((__m256i*)vfCompositeCunningham1)[nWord] |= xCC1Layer;
-        ((__m256i*)vfCompositeCunningham2)[nWord] |= xCC2Layer;
-    }
-#elif defined(USE_SSE2)
-    const sieve_word_t nMaxWordSSE2 = nMaxWord / (128 / nWordBits);
-    for (sieve_word_t nWord = nMinWord / (128 / nWordBits); nWord < nMaxWordSSE2; nWord++)
-    {
-        const __m128i xCC1Layer = ((__m128i*)vfLayerCC1)[nWord];
-        const __m128i xCC2Layer = ((__m128i*)vfLayerCC2)[nWord];
-        ((__m128i*)vfCompositeCunningham1)[nWord] |= xCC1Layer;
-        ((__m128i*)vfCompositeCunningham2)[nWord] |= xCC2Layer;
-    }
-#else
-        for (sieve_word_t nWord = nMinWord; nWord < nMaxWord; nWord++)
-        {
-            vfCompositeCunningham1[nWord] |= vfLayerCC1[nWord];
-            vfCompositeCunningham2[nWord] |= vfLayerCC2[nWord];
-        }
-#endif
-}
-
-inline void CombineBitsets(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t *vfCandidates, sieve_word_t *vfCompositeCunningham1, sieve_word_t *vfCompositeCunningham2, sieve_word_t *vfCompositeBiTwin)
-{
-#if defined(USE_AVX2)
-    const sieve_word_t nMaxWordAVX2 = nMaxWord / (256 / nWordBits);
-    for (sieve_word_t nWord = nMinWord / (256 / nWordBits); nWord < nMaxWordAVX2; nWord++)
-    {
-        const __m256i xCompositesCC1 = ((__m256i*)vfCompositeCunningham1)[nWord];
-        const __m256i xCompositesCC2 = ((__m256i*)vfCompositeCunningham2)[nWord];
-        const __m256i xCompositesBiTwin = ((__m256i*)vfCompositeBiTwin)[nWord];
-        ((__m256i*)vfCandidates)[nWord] = ~(xCompositesCC1 & xCompositesCC2 & xCompositesBiTwin);
-    }
-#elif defined(USE_SSE2)
-    const sieve_word_t nMaxWordSSE2 = nMaxWord / (128 / nWordBits);
-    for (sieve_word_t nWord = nMinWord / (128 / nWordBits); nWord < nMaxWordSSE2; nWord++)
-    {
-        const __m128i xCompositesCC1 = ((__m128i*)vfCompositeCunningham1)[nWord];
-        const __m128i xCompositesCC2 = ((__m128i*)vfCompositeCunningham2)[nWord];
-        const __m128i xCompositesBiTwin = ((__m128i*)vfCompositeBiTwin)[nWord];
-        ((__m128i*)vfCandidates)[nWord] = ~(xCompositesCC1 & xCompositesCC2 & xCompositesBiTwin);
-    }
-#else
-    for (sieve_word_t nWord = nMinWord; nWord < nMaxWord; nWord++)
-        vfCandidates[nWord] = ~(vfCompositeCunningham1[nWord] & vfCompositeCunningham2[nWord] & vfCompositeBiTwin[nWord]);
-#endif
-}
-
 // Weave sieve for the next prime in table
 // Return values:
 //   True  - weaved another prime; nComposite - number of composites removed
@@ -1348,12 +1603,36 @@ bool CSieveOfEratosthenes::Weave()
     // Process the array in chunks that fit the L1 cache
     const unsigned int nArrayRounds = (nSieveSize + nL1CacheElements - 1) / nL1CacheElements;
 
+    // Split the rounds between the weave threads. Round boundaries are
+    // aligned to nRequiredAlignment bits, so the ranges share no words.
+    const unsigned int nThreads = std::min(nWeaveThreads, nArrayRounds);
+    if (nThreads > 1)
+    {
+        // The shared multipliers stay read-only while the threads copy them
+        boost::thread_group weaveThreads;
+        for (unsigned int i = 1; i < nThreads; i++)
+            weaveThreads.create_thread(boost::bind(&CSieveOfEratosthenes::WeaveRoundsThread, this, nArrayRounds * i / nThreads, nArrayRounds * (i + 1) / nThreads));
+        WeaveRoundsThread(0, nArrayRounds / nThreads);
+        weaveThreads.join_all();
+    }
+    else
+        WeaveRounds(0, nArrayRounds, vCunningham1Multipliers, vCunningham2Multipliers);
+
+    // The sieve has been partially weaved
+    this->nPrimeSeq = nPrimes - 1;
+
+    return false;
+}
+
+// Weave the rounds [nMinRound, nMaxRound) of the sieve
+void CSieveOfEratosthenes::WeaveRounds(unsigned int nMinRound, unsigned int nMaxRound, unsigned int *vCC1Multipliers, unsigned int *vCC2Multipliers)
+{
     // Calculate the number of CC1 and CC2 layers needed for BiTwin candidates
     const unsigned int nBiTwinCC1Layers = (nChainLength + 1) / 2;
     const unsigned int nBiTwinCC2Layers = nChainLength / 2;
 
     // Loop over each array one at a time for optimal L1 cache performance
-    for (unsigned int j = 0; j < nArrayRounds; j++)
+    for (unsigned int j = nMinRound; j < nMaxRound; j++)
     {
         const unsigned int nMinMultiplier = nL1CacheElements * j;
         const unsigned int nMaxMultiplier = std::min(nMinMultiplier + nL1CacheElements, nSieveSize);
@@ -1366,18 +1645,18 @@ bool CSieveOfEratosthenes::Weave()
         for (unsigned int nLayerSeq = 0; nLayerSeq < nSieveLayers; nLayerSeq++) {
             if (pindexPrev != chainActive.Tip())
                 break;  // new block
-            ProcessMultiplier(vfCompositeLayerCC1, nMinMultiplier, nMaxMultiplier, vCunningham1Multipliers, nLayerSeq);
-            ProcessMultiplier(vfCompositeLayerCC2, nMinMultiplier, nMaxMultiplier, vCunningham2Multipliers, nLayerSeq);
+            ProcessMultiplier(vfCompositeLayerCC1, nMinMultiplier, nMaxMultiplier, vCC1Multipliers, nLayerSeq);
+            ProcessMultiplier(vfCompositeLayerCC2, nMinMultiplier, nMaxMultiplier, vCC2Multipliers, nLayerSeq);
 
             // Apply the layer to the primary sieve arrays
             if (nLayerSeq < nChainLength)
             {
                 if (nLayerSeq < nBiTwinCC2Layers)
-                    ApplyLayerTWNBoth(nMinWord, nMaxWord, vfCompositeCunningham1, vfCompositeCunningham2, vfCompositeBiTwin, vfCompositeLayerCC1, vfCompositeLayerCC2);
+                    sieveKernels.ApplyLayerTWNBoth(nMinWord, nMaxWord, vfCompositeCunningham1, vfCompositeCunningham2, vfCompositeBiTwin, vfCompositeLayerCC1, vfCompositeLayerCC2);
                 else if (nLayerSeq < nBiTwinCC1Layers)
-                    ApplyLayerTWNOnlyCC1(nMinWord, nMaxWord, vfCompositeCunningham1, vfCompositeCunningham2, vfCompositeBiTwin, vfCompositeLayerCC1, vfCompositeLayerCC2);
+                    sieveKernels.ApplyLayerTWNOnlyCC1(nMinWord, nMaxWord, vfCompositeCunningham1, vfCompositeCunningham2, vfCompositeBiTwin, vfCompositeLayerCC1, vfCompositeLayerCC2);
                 else
-                    ApplyLayerTWNNone(nMinWord, nMaxWord, vfCompositeCunningham1, vfCompositeCunningham2, vfCompositeLayerCC1, vfCompositeLayerCC2);
+                    sieveKernels.ApplyLayerTWNNone(nMinWord, nMaxWord, vfCompositeCunningham1, vfCompositeCunningham2, vfCompositeLayerCC1, vfCompositeLayerCC2);
             }
 
             // Apply the layer to extensions
@@ -1391,18 +1670,18 @@ bool CSieveOfEratosthenes::Weave()
                     sieve_word_t *vfExtCC2 = vfExtendedCompositeCunningham2 + nExtensionSeq * nCandidatesWords;
                     sieve_word_t *vfExtTWN = vfExtendedCompositeBiTwin + nExtensionSeq * nCandidatesWords;
                     if (nLayerExtendedSeq < nBiTwinCC2Layers)
-                        ApplyLayerTWNBoth(nMinWord, nMaxWord, vfExtCC1, vfExtCC2, vfExtTWN, vfCompositeLayerCC1, vfCompositeLayerCC2);
+                        sieveKernels.ApplyLayerTWNBoth(nMinWord, nMaxWord, vfExtCC1, vfExtCC2, vfExtTWN, vfCompositeLayerCC1, vfCompositeLayerCC2);
                     else if (nLayerExtendedSeq < nBiTwinCC1Layers)
-                        ApplyLayerTWNOnlyCC1(nMinWord, nMaxWord, vfExtCC1, vfExtCC2, vfExtTWN, vfCompositeLayerCC1, vfCompositeLayerCC2);
+                        sieveKernels.ApplyLayerTWNOnlyCC1(nMinWord, nMaxWord, vfExtCC1, vfExtCC2, vfExtTWN, vfCompositeLayerCC1, vfCompositeLayerCC2);
                     else
-                        ApplyLayerTWNNone(nMinWord, nMaxWord, vfExtCC1, vfExtCC2, vfCompositeLayerCC1, vfCompositeLayerCC2);
+                        sieveKernels.ApplyLayerTWNNone(nMinWord, nMaxWord, vfExtCC1, vfExtCC2, vfCompositeLayerCC1, vfCompositeLayerCC2);
                 }
             }
         }
 
         // Combine the bitsets
         // vfCandidates = ~(vfCompositeCunningham1 & vfCompositeCunningham2 & vfCompositeBiTwin)
-        CombineBitsets(nMinWord, nMaxWord, vfCandidates, vfCompositeCunningham1, vfCompositeCunningham2, vfCompositeBiTwin);
+        sieveKernels.CombineBitsets(nMinWord, nMaxWord, vfCandidates, vfCompositeCunningham1, vfCompositeCunningham2, vfCompositeBiTwin);
 
         // Combine the extended bitsets
         for (unsigned int j = 0, nExtOffset = 0; j < nSieveExtensions; j++, nExtOffset += nCandidatesWords)
@@ -1411,14 +1690,31 @@ bool CSieveOfEratosthenes::Weave()
             sieve_word_t *vfExtCompositeCC1 = &vfExtendedCompositeCunningham1[nExtOffset];
             sieve_word_t *vfExtCompositeCC2 = &vfExtendedCompositeCunningham2[nExtOffset];
             sieve_word_t *vfExtCompositeTWN = &vfExtendedCompositeBiTwin[nExtOffset];
-            CombineBitsets(nMinWord, nMaxWord, vfExtCandidates, vfExtCompositeCC1, vfExtCompositeCC2, vfExtCompositeTWN);
+            sieveKernels.CombineBitsets(nMinWord, nMaxWord, vfExtCandidates, vfExtCompositeCC1, vfExtCompositeCC2, vfExtCompositeTWN);
         }
     }
+}
 
-    // The sieve has been partially weaved
-    this->nPrimeSeq = nPrimes - 1;
-
-    return false;
+// Weave the rounds [nMinRound, nMaxRound) of the sieve on a private copy of
+// the layer multipliers, moved forward to the first multiple in the range
+void CSieveOfEratosthenes::WeaveRoundsThread(unsigned int nMinRound, unsigned int nMaxRound)
+{
+    const unsigned int nMultipliers = nPrimes * nSieveLayers;
+    const unsigned int nMinMultiplier = nL1CacheElements * nMinRound;
+    std::vector<unsigned int> vCC1Multipliers(vCunningham1Multipliers, vCunningham1Multipliers + nMultipliers);
+    std::vector<unsigned int> vCC2Multipliers(vCunningham2Multipliers, vCunningham2Multipliers + nMultipliers);
+    for (unsigned int nMultiplierIndex = 0; nMultiplierIndex < nMultipliers; nMultiplierIndex++)
+    {
+        const unsigned int nPrime = vPrimes[nMultiplierIndex % nPrimes];
+        unsigned int& nCC1Mult = vCC1Multipliers[nMultiplierIndex];
+        unsigned int& nCC2Mult = vCC2Multipliers[nMultiplierIndex];
+        // Primes not dividing anything in the sieve are left at UINT_MAX
+        if (nCC1Mult < nMinMultiplier)
+            nCC1Mult += (nMinMultiplier - nCC1Mult + nPrime - 1) / nPrime * nPrime;
+        if (nCC2Mult < nMinMultiplier)
+            nCC2Mult += (nMinMultiplier - nCC2Mult + nPrime - 1) / nPrime * nPrime;
+    }
+    WeaveRounds(nMinRound, nMaxRound, &vCC1Multipliers[0], &vCC2Multipliers[0]);
 }
 
 static const double dLogTwo = log(2.0);
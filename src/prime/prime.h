@@ -9,6 +9,7 @@
 #include "base58.h"
 #include "arith_uint256.h"
 #include "chain.h"
+#include "prime/sieve_kernels.h"
 #include "util.h"
 
 #include <gmp.h>
@@ -34,6 +35,9 @@ static const unsigned int nMaxSieveSize = 10000000u;
 static const unsigned int nDefaultSieveSize = 1376256u;
 static const unsigned int nMinSieveSize = 100000u;
 extern unsigned int nSieveSize;
+static const unsigned int nMaxSieveWeaveThreads = 64;
+static const unsigned int nDefaultSieveWeaveThreads = 1;
+extern unsigned int nSieveWeaveThreads;
 static const unsigned int nMaxL1CacheSize = 128000u;
 static const unsigned int nDefaultL1CacheSize = 28672u;
 static const unsigned int nMinL1CacheSize = 12000u;
@@ -99,6 +103,14 @@ void PrimorialAt(mpz_class& bn, mpz_class& mpzPrimorial);
 //   true - Probable prime chain found (one of nChainLength meeting target)
 //   false - prime chain too short (none of nChainLength meeting target)
 bool ProbablePrimeChainTest(const CBigNum& bnPrimeChainOrigin, unsigned int nBits, bool fFermatTest, unsigned int& nChainLengthCunningham1, unsigned int& nChainLengthCunningham2, unsigned int& nChainLengthBiTwin);
+// Test probable prime chain for: mpzPrimeChainOrigin
+// GMP engine of proof-of-work verification. Gives the same lengths as
+// ProbablePrimeChainTest with fFermatTest false (first three outputs) and
+// true (last three outputs), computed in a single pass.
+// Return value:
+//   true - Probable prime chain found by Euler-Lagrange-Lifchitz tests
+//   false - prime chain too short
+bool ProbablePrimeChainTestVerify(const mpz_class& mpzPrimeChainOrigin, unsigned int nBits, unsigned int& nChainLengthCunningham1, unsigned int& nChainLengthCunningham2, unsigned int& nChainLengthBiTwin, unsigned int& nChainLengthCunningham1FermatTest, unsigned int& nChainLengthCunningham2FermatTest, unsigned int& nChainLengthBiTwinFermatTest);
 
 static const unsigned int nFractionalBits = 24;
 static const unsigned int TARGET_FRACTIONAL_MASK = (1u<<nFractionalBits) - 1;
@@ -150,6 +162,13 @@ class CPrimalityTestParams;
 // Mine probable prime chain of form: n = h * p# +/- 1
 bool MineProbablePrimeChain(CBlock& block, mpz_class& mpzFixedMultiplier, bool& fNewBlock, unsigned int& nTests, unsigned int& nPrimesHit, mpz_class& mpzHash, CBlockIndex* pindexPrev, unsigned int vChainsFound[nMaxChainLength], CSieveOfEratosthenes& sieve, CPrimalityTestParams& testParams);
 
+// Check the prime chain of a pool share. Only the chain of type nChainType is
+// tested, and the test stops once the chain is nMinLength long.
+// Return values:
+//   true  - the chain is at least nMinLength long
+//   false - invalid share or chain too short
+bool CheckPrimeShare(uint256 hashBlockHeader, const CBigNum& bnPrimeChainMultiplier, unsigned int nChainType, unsigned int nMinLength, unsigned int& nChainLength, CPrimalityTestParams& testParams);
+
 // Perform Fermat test with trial division
 // Return values:
 //   true  - passes trial division test and Fermat test; probable prime
@@ -195,23 +214,6 @@ double EstimateNormalPrimeProbability(unsigned int nPrimorialMultiplier, unsigne
 #    define USE_UNROLLED_LOOPS
 #endif
 
-#ifdef USE_INTRINSICS
-#    include <immintrin.h>
-#endif
-
-// Check if the target platform is 64-bit
-#if defined(__x86_64__) || defined(_M_X64)
-#define USE_64BIT
-typedef unsigned long long sieve_word_t;
-typedef signed long long sieve_signed_t;
-#else
-typedef unsigned int sieve_word_t;
-typedef signed int sieve_signed_t;
-#endif
-
-static const unsigned int nWordBits = 8 * sizeof(sieve_word_t);
-static const unsigned int nWordBitsLog = (nWordBits == 64) ? 6 : 5;
-
 #ifdef USE_BTS
 // The bts instruction should be very fast starting from Intel Core 2
 inline sieve_word_t bts(sieve_word_t nr, sieve_word_t bits)
@@ -244,18 +246,9 @@ inline sieve_word_t rotate_left(sieve_word_t bits, unsigned int count)
 #   define USE_BMI2
 #endif
 
-#if defined(USE_INTRINSICS) && defined(__SSE2__)
-#    define USE_SSE2
-#endif
-
-#if defined(USE_INTRINSICS) && defined(__AVX2__)
-#    define USE_AVX2
-#endif
-
-#if defined(USE_AVX2)
-const unsigned int nRequiredAlignment = 256;
-#elif defined(USE_SSE2)
-const unsigned int nRequiredAlignment = 128;
+// The sieve kernels are selected at runtime and use up to 512-bit vectors
+#if defined(USE_INTRINSICS) && defined(USE_64BIT)
+const unsigned int nRequiredAlignment = 512;
 #elif defined(USE_64BIT)
 const unsigned int nRequiredAlignment = 64;
 #else
@@ -282,6 +275,35 @@ inline sieve_word_t shlx(sieve_word_t bits, sieve_word_t count)
 }
 #endif
 
+// Block of sieve candidates tested together by MineProbablePrimeChain. The
+// chain origins are computed incrementally and the first probable primality
+// test of every chain runs before any chain is followed further.
+class CPrimalityTestBatch
+{
+public:
+    static const unsigned int nMaxSize = 64;
+
+    unsigned int nSize;
+    unsigned int vMultipliers[nMaxSize];
+    unsigned int vCandidateTypes[nMaxSize];
+    bool vfFirstTestPassed[nMaxSize];
+    mpz_class vOrigins[nMaxSize]; // hash * fixed multiplier * vMultipliers[i], for every candidate
+
+    // Running origin hash * primorial * multiplier
+    mpz_class mpzOrigin;
+    unsigned int nOriginMultiplier;
+
+    // Limbs reserved for the scratch variables of the current round
+    size_t nRoundLimbs;
+
+    CPrimalityTestBatch()
+    {
+        nSize = 0;
+        nOriginMultiplier = 0;
+        nRoundLimbs = 0;
+    }
+};
+
 class CPrimalityTestParams
 {
 public:
@@ -305,6 +327,9 @@ public:
     // Results
     unsigned int nChainLength;
 
+    // Candidates being tested
+    CPrimalityTestBatch batch;
+
     CPrimalityTestParams()
     {
         nBits = 0;
@@ -387,6 +412,7 @@ class CSieveOfEratosthenes
     unsigned int nPrimes; // number of times to weave the sieve
     unsigned int nL1CacheElements; // number of bits that can be stored in L1 cache
     unsigned int nMinPrimeSeq; // smallest prime which will be used for sieving
+    unsigned int nWeaveThreads; // number of threads weaving the sieve
 
     CBlockIndex* pindexPrev;
 
@@ -408,6 +434,14 @@ class CSieveOfEratosthenes
 
     void ProcessMultiplier(sieve_word_t *vfComposites, const unsigned int nMinMultiplier, const unsigned int nMaxMultiplier, unsigned int *vMultipliers, unsigned int nLayerSeq);
 
+    // Weave the L1 cache sized rounds [nMinRound, nMaxRound) of the sieve
+    // with the given layer multipliers, advanced to the start of nMinRound
+    void WeaveRounds(unsigned int nMinRound, unsigned int nMaxRound, unsigned int *vCC1Multipliers, unsigned int *vCC2Multipliers);
+
+    // Weave rounds [nMinRound, nMaxRound) on a private copy of the layer
+    // multipliers, when more than one thread weaves the sieve
+    void WeaveRoundsThread(unsigned int nMinRound, unsigned int nMaxRound);
+
     void freeArrays()
     {
         if (vfRawCandidates)
@@ -504,6 +538,7 @@ public:
         nPrimes = 0;
         nL1CacheElements = 0;
         nMinPrimeSeq = 0;
+        nWeaveThreads = 1;
         pindexPrev = NULL;
         fIsReady = false;
         fIsDepleted = true;
@@ -514,11 +549,12 @@ public:
         freeArrays();
     }
 
-    void Reset(unsigned int nSieveSize, unsigned int nSieveFilterPrimes, unsigned int nSieveExtensions, unsigned int nL1CacheSize, unsigned int nBits, mpz_class& mpzHash, mpz_class& mpzFixedMultiplier, CBlockIndex* pindexPrev)
+    void Reset(unsigned int nSieveSize, unsigned int nSieveFilterPrimes, unsigned int nSieveExtensions, unsigned int nL1CacheSize, unsigned int nBits, mpz_class& mpzHash, mpz_class& mpzFixedMultiplier, CBlockIndex* pindexPrev, unsigned int nWeaveThreads = 1)
     {
         this->nSieveSize = nSieveSize;
         this->nSieveFilterPrimes = nSieveFilterPrimes;
         this->nSieveExtensions = nSieveExtensions;
+        this->nWeaveThreads = std::max(1u, nWeaveThreads);
         nL1CacheElements = nL1CacheSize * 8;
         this->nBits = nBits;
         this->mpzHash = mpzHash;
@@ -721,13 +757,8 @@ public:
 
             if (unlikely(nCandidateIndex % nWordBits == 0))
             {
-                sieve_word_t nWord = nCandidateIndex / nWordBits;
-                // Fast loop to skip empty words
-                for (; likely(nWord < nMaxWord); nWord++)
-                {
-                    if (vfActiveCandidates[nWord] != 0)
-                        break;
-                }
+                // Fast scan to skip empty words
+                const sieve_word_t nWord = sieveKernels.FindNonZeroWord(nCandidateIndex / nWordBits, nMaxWord, vfActiveCandidates);
                 nCandidateIndex = nWord * nWordBits;
                 if (nCandidateIndex >= _nSieveSize)
                     continue;
@@ -757,6 +788,9 @@ public:
     unsigned int GetProgressPercentage();
 
     // Weave the sieve for the next prime in table
+    // The sieve is split into ranges of L1 cache sized rounds, one for each
+    // of nWeaveThreads threads. Every thread owns the composite bitmaps of
+    // its range and combines them into the candidates itself.
     // Return values:
     //   True  - weaved another prime; nComposite - number of composites removed
     //   False - sieve already completed
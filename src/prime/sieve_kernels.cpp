@@ -0,0 +1,315 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "prime/sieve_kernels.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__amd64__)
+#if defined(ENABLE_AVX2)
+namespace sieve_avx2
+{
+void ApplyLayerTWNBoth(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2);
+void ApplyLayerTWNOnlyCC1(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2);
+void ApplyLayerTWNNone(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2);
+void CombineBitsets(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCandidates, const sieve_word_t* vfCC1, const sieve_word_t* vfCC2, const sieve_word_t* vfTWN);
+unsigned int FindNonZeroWord(unsigned int nMinWord, unsigned int nMaxWord, const sieve_word_t* vfBits);
+}
+#endif
+#if defined(ENABLE_AVX512F)
+namespace sieve_avx512
+{
+void ApplyLayerTWNBoth(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2);
+void ApplyLayerTWNOnlyCC1(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2);
+void ApplyLayerTWNNone(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2);
+void CombineBitsets(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCandidates, const sieve_word_t* vfCC1, const sieve_word_t* vfCC2, const sieve_word_t* vfTWN);
+unsigned int FindNonZeroWord(unsigned int nMinWord, unsigned int nMaxWord, const sieve_word_t* vfBits);
+}
+#endif
+#endif
+
+namespace sieve_scalar
+{
+void ApplyLayerTWNBoth(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    for (unsigned int nWord = nMinWord; nWord < nMaxWord; nWord++)
+    {
+        vfCC1[nWord] |= vfLayerCC1[nWord];
+        vfCC2[nWord] |= vfLayerCC2[nWord];
+        vfTWN[nWord] |= vfLayerCC1[nWord] | vfLayerCC2[nWord];
+    }
+}
+
+void ApplyLayerTWNOnlyCC1(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    for (unsigned int nWord = nMinWord; nWord < nMaxWord; nWord++)
+    {
+        vfCC1[nWord] |= vfLayerCC1[nWord];
+        vfCC2[nWord] |= vfLayerCC2[nWord];
+        vfTWN[nWord] |= vfLayerCC1[nWord];
+    }
+}
+
+void ApplyLayerTWNNone(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    for (unsigned int nWord = nMinWord; nWord < nMaxWord; nWord++)
+    {
+        vfCC1[nWord] |= vfLayerCC1[nWord];
+        vfCC2[nWord] |= vfLayerCC2[nWord];
+    }
+}
+
+void CombineBitsets(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCandidates, const sieve_word_t* vfCC1, const sieve_word_t* vfCC2, const sieve_word_t* vfTWN)
+{
+    for (unsigned int nWord = nMinWord; nWord < nMaxWord; nWord++)
+        vfCandidates[nWord] = ~(vfCC1[nWord] & vfCC2[nWord] & vfTWN[nWord]);
+}
+
+unsigned int FindNonZeroWord(unsigned int nMinWord, unsigned int nMaxWord, const sieve_word_t* vfBits)
+{
+    unsigned int nWord = nMinWord;
+    while (nWord < nMaxWord && vfBits[nWord] == 0)
+        nWord++;
+    return nWord;
+}
+} // namespace sieve_scalar
+
+#if defined(__SSE2__)
+// SSE2 is part of the x86-64 baseline, so this needs no runtime check
+namespace sieve_sse2
+{
+static const unsigned int nVectorWords = 128 / nWordBits;
+
+void ApplyLayerTWNBoth(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    unsigned int nWord = nMinWord;
+    for (; nWord + nVectorWords <= nMaxWord; nWord += nVectorWords)
+    {
+        const __m128i xCC1Layer = _mm_loadu_si128((const __m128i*)&vfLayerCC1[nWord]);
+        const __m128i xCC2Layer = _mm_loadu_si128((const __m128i*)&vfLayerCC2[nWord]);
+        _mm_storeu_si128((__m128i*)&vfCC1[nWord], _mm_or_si128(_mm_loadu_si128((const __m128i*)&vfCC1[nWord]), xCC1Layer));
+        _mm_storeu_si128((__m128i*)&vfCC2[nWord], _mm_or_si128(_mm_loadu_si128((const __m128i*)&vfCC2[nWord]), xCC2Layer));
+        _mm_storeu_si128((__m128i*)&vfTWN[nWord], _mm_or_si128(_mm_loadu_si128((const __m128i*)&vfTWN[nWord]), _mm_or_si128(xCC1Layer, xCC2Layer)));
+    }
+    sieve_scalar::ApplyLayerTWNBoth(nWord, nMaxWord, vfCC1, vfCC2, vfTWN, vfLayerCC1, vfLayerCC2);
+}
+
+void ApplyLayerTWNOnlyCC1(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    unsigned int nWord = nMinWord;
+    for (; nWord + nVectorWords <= nMaxWord; nWord += nVectorWords)
+    {
+        const __m128i xCC1Layer = _mm_loadu_si128((const __m128i*)&vfLayerCC1[nWord]);
+        const __m128i xCC2Layer = _mm_loadu_si128((const __m128i*)&vfLayerCC2[nWord]);
+        _mm_storeu_si128((__m128i*)&vfCC1[nWord], _mm_or_si128(_mm_loadu_si128((const __m128i*)&vfCC1[nWord]), xCC1Layer));
+        _mm_storeu_si128((__m128i*)&vfCC2[nWord], _mm_or_si128(_mm_loadu_si128((const __m128i*)&vfCC2[nWord]), xCC2Layer));
+        _mm_storeu_si128((__m128i*)&vfTWN[nWord], _mm_or_si128(_mm_loadu_si128((const __m128i*)&vfTWN[nWord]), xCC1Layer));
+    }
+    sieve_scalar::ApplyLayerTWNOnlyCC1(nWord, nMaxWord, vfCC1, vfCC2, vfTWN, vfLayerCC1, vfLayerCC2);
+}
+
+void ApplyLayerTWNNone(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    unsigned int nWord = nMinWord;
+    for (; nWord + nVectorWords <= nMaxWord; nWord += nVectorWords)
+    {
+        const __m128i xCC1Layer = _mm_loadu_si128((const __m128i*)&vfLayerCC1[nWord]);
+        const __m128i xCC2Layer = _mm_loadu_si128((const __m128i*)&vfLayerCC2[nWord]);
+        _mm_storeu_si128((__m128i*)&vfCC1[nWord], _mm_or_si128(_mm_loadu_si128((const __m128i*)&vfCC1[nWord]), xCC1Layer));
+        _mm_storeu_si128((__m128i*)&vfCC2[nWord], _mm_or_si128(_mm_loadu_si128((const __m128i*)&vfCC2[nWord]), xCC2Layer));
+    }
+    sieve_scalar::ApplyLayerTWNNone(nWord, nMaxWord, vfCC1, vfCC2, vfLayerCC1, vfLayerCC2);
+}
+
+void CombineBitsets(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCandidates, const sieve_word_t* vfCC1, const sieve_word_t* vfCC2, const sieve_word_t* vfTWN)
+{
+    const __m128i xOnes = _mm_set1_epi32(-1);
+    unsigned int nWord = nMinWord;
+    for (; nWord + nVectorWords <= nMaxWord; nWord += nVectorWords)
+    {
+        const __m128i xCompositesCC1 = _mm_loadu_si128((const __m128i*)&vfCC1[nWord]);
+        const __m128i xCompositesCC2 = _mm_loadu_si128((const __m128i*)&vfCC2[nWord]);
+        const __m128i xCompositesBiTwin = _mm_loadu_si128((const __m128i*)&vfTWN[nWord]);
+        _mm_storeu_si128((__m128i*)&vfCandidates[nWord], _mm_xor_si128(_mm_and_si128(_mm_and_si128(xCompositesCC1, xCompositesCC2), xCompositesBiTwin), xOnes));
+    }
+    sieve_scalar::CombineBitsets(nWord, nMaxWord, vfCandidates, vfCC1, vfCC2, vfTWN);
+}
+
+unsigned int FindNonZeroWord(unsigned int nMinWord, unsigned int nMaxWord, const sieve_word_t* vfBits)
+{
+    const __m128i xZero = _mm_setzero_si128();
+    unsigned int nWord = nMinWord;
+    for (; nWord + nVectorWords <= nMaxWord; nWord += nVectorWords)
+    {
+        const __m128i xBits = _mm_loadu_si128((const __m128i*)&vfBits[nWord]);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(xBits, xZero)) != 0xFFFF)
+            break;
+    }
+    // Locate the word within the vector, or scan the tail
+    return sieve_scalar::FindNonZeroWord(nWord, nMaxWord, vfBits);
+}
+} // namespace sieve_sse2
+#endif
+
+const SieveKernels sieveKernelsScalar = {
+    "scalar",
+    sieve_scalar::ApplyLayerTWNBoth,
+    sieve_scalar::ApplyLayerTWNOnlyCC1,
+    sieve_scalar::ApplyLayerTWNNone,
+    sieve_scalar::CombineBitsets,
+    sieve_scalar::FindNonZeroWord,
+};
+
+namespace
+{
+#if defined(__SSE2__)
+const SieveKernels sieveKernelsSSE2 = {
+    "sse2",
+    sieve_sse2::ApplyLayerTWNBoth,
+    sieve_sse2::ApplyLayerTWNOnlyCC1,
+    sieve_sse2::ApplyLayerTWNNone,
+    sieve_sse2::CombineBitsets,
+    sieve_sse2::FindNonZeroWord,
+};
+#endif
+
+#if defined(__x86_64__) || defined(__amd64__)
+#if defined(ENABLE_AVX2)
+const SieveKernels sieveKernelsAVX2 = {
+    "avx2",
+    sieve_avx2::ApplyLayerTWNBoth,
+    sieve_avx2::ApplyLayerTWNOnlyCC1,
+    sieve_avx2::ApplyLayerTWNNone,
+    sieve_avx2::CombineBitsets,
+    sieve_avx2::FindNonZeroWord,
+};
+#endif
+#if defined(ENABLE_AVX512F)
+const SieveKernels sieveKernelsAVX512 = {
+    "avx512",
+    sieve_avx512::ApplyLayerTWNBoth,
+    sieve_avx512::ApplyLayerTWNOnlyCC1,
+    sieve_avx512::ApplyLayerTWNNone,
+    sieve_avx512::CombineBitsets,
+    sieve_avx512::FindNonZeroWord,
+};
+#endif
+
+#if defined(ENABLE_AVX2) || defined(ENABLE_AVX512F)
+void inline cpuid(uint32_t leaf, uint32_t subleaf, uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d)
+{
+    __asm__ ("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "0"(leaf), "2"(subleaf));
+}
+
+/** Check whether the OS saves the given XCR0 register states on context switches */
+bool XSaveEnabled(uint32_t nStates)
+{
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, 0, eax, ebx, ecx, edx);
+    if (!((ecx >> 27) & 1)) // OSXSAVE
+        return false;
+    uint32_t xcr0_lo, xcr0_hi;
+    __asm__ ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    return (xcr0_lo & nStates) == nStates;
+}
+
+/** Read the extended feature flags (CPUID leaf 7) */
+uint32_t ExtendedFeatures()
+{
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(0, 0, eax, ebx, ecx, edx);
+    if (eax < 7)
+        return 0;
+    cpuid(7, 0, eax, ebx, ecx, edx);
+    return ebx;
+}
+#endif
+#endif
+
+/** Compare the kernels against the scalar ones on unaligned ranges of a
+ *  pseudo-random bitmap. */
+bool SelfTest(const SieveKernels& kernels)
+{
+    static const unsigned int nWords = 61;
+    sieve_word_t vfInput[5][nWords];
+    uint32_t nState = 0x2545f491;
+    for (unsigned int i = 0; i < 5; i++) {
+        for (unsigned int j = 0; j < nWords; j++) {
+            sieve_word_t nWord = 0;
+            for (unsigned int k = 0; k < sizeof(sieve_word_t); k++) {
+                nState = nState * 1103515245 + 12345;
+                nWord = (nWord << 8) | (nState >> 24);
+            }
+            vfInput[i][j] = nWord;
+        }
+    }
+    // Keep a stretch of empty words for the scan
+    for (unsigned int j = 3; j < 29; j++)
+        vfInput[0][j] = 0;
+
+    for (unsigned int nMinWord = 0; nMinWord < 3; nMinWord++) {
+        for (unsigned int nMaxWord = nWords - 3; nMaxWord <= nWords; nMaxWord++) {
+            sieve_word_t vfExpected[3][nWords], vfResult[3][nWords];
+            memcpy(vfExpected, vfInput, sizeof(vfExpected));
+            memcpy(vfResult, vfInput, sizeof(vfResult));
+            sieveKernelsScalar.ApplyLayerTWNBoth(nMinWord, nMaxWord, vfExpected[0], vfExpected[1], vfExpected[2], vfInput[3], vfInput[4]);
+            kernels.ApplyLayerTWNBoth(nMinWord, nMaxWord, vfResult[0], vfResult[1], vfResult[2], vfInput[3], vfInput[4]);
+            sieveKernelsScalar.ApplyLayerTWNOnlyCC1(nMinWord, nMaxWord, vfExpected[2], vfExpected[0], vfExpected[1], vfInput[4], vfInput[3]);
+            kernels.ApplyLayerTWNOnlyCC1(nMinWord, nMaxWord, vfResult[2], vfResult[0], vfResult[1], vfInput[4], vfInput[3]);
+            sieveKernelsScalar.ApplyLayerTWNNone(nMinWord, nMaxWord, vfExpected[1], vfExpected[2], vfInput[3], vfInput[0]);
+            kernels.ApplyLayerTWNNone(nMinWord, nMaxWord, vfResult[1], vfResult[2], vfInput[3], vfInput[0]);
+            sieveKernelsScalar.CombineBitsets(nMinWord, nMaxWord, vfExpected[0], vfInput[1], vfInput[2], vfInput[3]);
+            kernels.CombineBitsets(nMinWord, nMaxWord, vfResult[0], vfInput[1], vfInput[2], vfInput[3]);
+            if (memcmp(vfExpected, vfResult, sizeof(vfResult)))
+                return false;
+            for (unsigned int nWord = nMinWord; nWord < nMaxWord; nWord++)
+                if (kernels.FindNonZeroWord(nWord, nMaxWord, vfInput[0]) != sieveKernelsScalar.FindNonZeroWord(nWord, nMaxWord, vfInput[0]))
+                    return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+#if defined(__SSE2__)
+SieveKernels sieveKernels = sieveKernelsSSE2;
+#else
+SieveKernels sieveKernels = sieveKernelsScalar;
+#endif
+
+std::vector<SieveKernels> SieveKernelsSupported()
+{
+    std::vector<SieveKernels> vKernels;
+#if (defined(__x86_64__) || defined(__amd64__)) && (defined(ENABLE_AVX2) || defined(ENABLE_AVX512F))
+    const uint32_t nFeatures = ExtendedFeatures();
+#if defined(ENABLE_AVX512F)
+    // AVX512F and the opmask, ZMM0-15 and ZMM16-31 states
+    if (((nFeatures >> 16) & 1) && XSaveEnabled(0xe6))
+        vKernels.push_back(sieveKernelsAVX512);
+#endif
+#if defined(ENABLE_AVX2)
+    // AVX2 and the XMM and YMM states
+    if (((nFeatures >> 5) & 1) && XSaveEnabled(0x06))
+        vKernels.push_back(sieveKernelsAVX2);
+#endif
+#endif
+#if defined(__SSE2__)
+    vKernels.push_back(sieveKernelsSSE2);
+#endif
+    vKernels.push_back(sieveKernelsScalar);
+    return vKernels;
+}
+
+std::string SieveKernelsAutoDetect()
+{
+    sieveKernels = SieveKernelsSupported().front();
+    assert(SelfTest(sieveKernels));
+    return sieveKernels.name;
+}
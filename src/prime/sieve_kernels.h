@@ -0,0 +1,59 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_PRIME_SIEVE_KERNELS_H
+#define BITCOIN_PRIME_SIEVE_KERNELS_H
+
+#include <string>
+#include <vector>
+
+// Check if the target platform is 64-bit
+#if defined(__x86_64__) || defined(_M_X64)
+#define USE_64BIT
+typedef unsigned long long sieve_word_t;
+typedef signed long long sieve_signed_t;
+#else
+typedef unsigned int sieve_word_t;
+typedef signed int sieve_signed_t;
+#endif
+
+static const unsigned int nWordBits = 8 * sizeof(sieve_word_t);
+static const unsigned int nWordBitsLog = (nWordBits == 64) ? 6 : 5;
+
+/**
+ * Bitmap kernels of the sieve. Each kernel processes the words
+ * [nMinWord, nMaxWord) and gives the same result for any alignment of the
+ * range, so the implementations can be swapped freely.
+ */
+struct SieveKernels
+{
+    const char* name;
+
+    // vfCC1 |= vfLayerCC1, vfCC2 |= vfLayerCC2, vfTWN |= vfLayerCC1 | vfLayerCC2
+    void (*ApplyLayerTWNBoth)(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2);
+    // vfCC1 |= vfLayerCC1, vfCC2 |= vfLayerCC2, vfTWN |= vfLayerCC1
+    void (*ApplyLayerTWNOnlyCC1)(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2);
+    // vfCC1 |= vfLayerCC1, vfCC2 |= vfLayerCC2
+    void (*ApplyLayerTWNNone)(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2);
+    // vfCandidates = ~(vfCC1 & vfCC2 & vfTWN)
+    void (*CombineBitsets)(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCandidates, const sieve_word_t* vfCC1, const sieve_word_t* vfCC2, const sieve_word_t* vfTWN);
+    // Index of the first non-zero word in [nMinWord, nMaxWord), or nMaxWord
+    unsigned int (*FindNonZeroWord)(unsigned int nMinWord, unsigned int nMaxWord, const sieve_word_t* vfBits);
+};
+
+/** The kernels used by the sieve, selected by SieveKernelsAutoDetect. */
+extern SieveKernels sieveKernels;
+
+/** The portable kernels, processing one word at a time. */
+extern const SieveKernels sieveKernelsScalar;
+
+/** All kernels usable on this build and CPU, best first. */
+std::vector<SieveKernels> SieveKernelsSupported();
+
+/** Autodetect the best available sieve kernels.
+ *  Returns the name of the implementation.
+ */
+std::string SieveKernelsAutoDetect();
+
+#endif // BITCOIN_PRIME_SIEVE_KERNELS_H
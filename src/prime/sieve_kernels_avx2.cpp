@@ -0,0 +1,104 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// This file is compiled with AVX2 enabled. Its kernels are only called after
+// SieveKernelsAutoDetect has checked for CPU and OS support.
+
+#include "prime/sieve_kernels.h"
+
+#if defined(__x86_64__) || defined(__amd64__)
+
+#include <immintrin.h>
+
+namespace sieve_avx2
+{
+static const unsigned int nVectorWords = 256 / nWordBits;
+
+void ApplyLayerTWNBoth(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    unsigned int nWord = nMinWord;
+    for (; nWord + nVectorWords <= nMaxWord; nWord += nVectorWords)
+    {
+        const __m256i xCC1Layer = _mm256_loadu_si256((const __m256i*)&vfLayerCC1[nWord]);
+        const __m256i xCC2Layer = _mm256_loadu_si256((const __m256i*)&vfLayerCC2[nWord]);
+        _mm256_storeu_si256((__m256i*)&vfCC1[nWord], _mm256_or_si256(_mm256_loadu_si256((const __m256i*)&vfCC1[nWord]), xCC1Layer));
+        _mm256_storeu_si256((__m256i*)&vfCC2[nWord], _mm256_or_si256(_mm256_loadu_si256((const __m256i*)&vfCC2[nWord]), xCC2Layer));
+        _mm256_storeu_si256((__m256i*)&vfTWN[nWord], _mm256_or_si256(_mm256_loadu_si256((const __m256i*)&vfTWN[nWord]), _mm256_or_si256(xCC1Layer, xCC2Layer)));
+    }
+    for (; nWord < nMaxWord; nWord++)
+    {
+        vfCC1[nWord] |= vfLayerCC1[nWord];
+        vfCC2[nWord] |= vfLayerCC2[nWord];
+        vfTWN[nWord] |= vfLayerCC1[nWord] | vfLayerCC2[nWord];
+    }
+}
+
+void ApplyLayerTWNOnlyCC1(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    unsigned int nWord = nMinWord;
+    for (; nWord + nVectorWords <= nMaxWord; nWord += nVectorWords)
+    {
+        const __m256i xCC1Layer = _mm256_loadu_si256((const __m256i*)&vfLayerCC1[nWord]);
+        const __m256i xCC2Layer = _mm256_loadu_si256((const __m256i*)&vfLayerCC2[nWord]);
+        _mm256_storeu_si256((__m256i*)&vfCC1[nWord], _mm256_or_si256(_mm256_loadu_si256((const __m256i*)&vfCC1[nWord]), xCC1Layer));
+        _mm256_storeu_si256((__m256i*)&vfCC2[nWord], _mm256_or_si256(_mm256_loadu_si256((const __m256i*)&vfCC2[nWord]), xCC2Layer));
+        _mm256_storeu_si256((__m256i*)&vfTWN[nWord], _mm256_or_si256(_mm256_loadu_si256((const __m256i*)&vfTWN[nWord]), xCC1Layer));
+    }
+    for (; nWord < nMaxWord; nWord++)
+    {
+        vfCC1[nWord] |= vfLayerCC1[nWord];
+        vfCC2[nWord] |= vfLayerCC2[nWord];
+        vfTWN[nWord] |= vfLayerCC1[nWord];
+    }
+}
+
+void ApplyLayerTWNNone(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    unsigned int nWord = nMinWord;
+    for (; nWord + nVectorWords <= nMaxWord; nWord += nVectorWords)
+    {
+        const __m256i xCC1Layer = _mm256_loadu_si256((const __m256i*)&vfLayerCC1[nWord]);
+        const __m256i xCC2Layer = _mm256_loadu_si256((const __m256i*)&vfLayerCC2[nWord]);
+        _mm256_storeu_si256((__m256i*)&vfCC1[nWord], _mm256_or_si256(_mm256_loadu_si256((const __m256i*)&vfCC1[nWord]), xCC1Layer));
+        _mm256_storeu_si256((__m256i*)&vfCC2[nWord], _mm256_or_si256(_mm256_loadu_si256((const __m256i*)&vfCC2[nWord]), xCC2Layer));
+    }
+    for (; nWord < nMaxWord; nWord++)
+    {
+        vfCC1[nWord] |= vfLayerCC1[nWord];
+        vfCC2[nWord] |= vfLayerCC2[nWord];
+    }
+}
+
+void CombineBitsets(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCandidates, const sieve_word_t* vfCC1, const sieve_word_t* vfCC2, const sieve_word_t* vfTWN)
+{
+    const __m256i xOnes = _mm256_set1_epi32(-1);
+    unsigned int nWord = nMinWord;
+    for (; nWord + nVectorWords <= nMaxWord; nWord += nVectorWords)
+    {
+        const __m256i xCompositesCC1 = _mm256_loadu_si256((const __m256i*)&vfCC1[nWord]);
+        const __m256i xCompositesCC2 = _mm256_loadu_si256((const __m256i*)&vfCC2[nWord]);
+        const __m256i xCompositesBiTwin = _mm256_loadu_si256((const __m256i*)&vfTWN[nWord]);
+        _mm256_storeu_si256((__m256i*)&vfCandidates[nWord], _mm256_xor_si256(_mm256_and_si256(_mm256_and_si256(xCompositesCC1, xCompositesCC2), xCompositesBiTwin), xOnes));
+    }
+    for (; nWord < nMaxWord; nWord++)
+        vfCandidates[nWord] = ~(vfCC1[nWord] & vfCC2[nWord] & vfTWN[nWord]);
+}
+
+unsigned int FindNonZeroWord(unsigned int nMinWord, unsigned int nMaxWord, const sieve_word_t* vfBits)
+{
+    unsigned int nWord = nMinWord;
+    for (; nWord + nVectorWords <= nMaxWord; nWord += nVectorWords)
+    {
+        const __m256i xBits = _mm256_loadu_si256((const __m256i*)&vfBits[nWord]);
+        if (!_mm256_testz_si256(xBits, xBits))
+            break;
+    }
+    // Locate the word within the vector, or scan the tail
+    while (nWord < nMaxWord && vfBits[nWord] == 0)
+        nWord++;
+    return nWord;
+}
+} // namespace sieve_avx2
+
+#endif
@@ -0,0 +1,92 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// This file is compiled with AVX-512F enabled. Its kernels are only called
+// after SieveKernelsAutoDetect has checked for CPU and OS support.
+
+#include "prime/sieve_kernels.h"
+
+#if defined(__x86_64__) || defined(__amd64__)
+
+#include <immintrin.h>
+
+namespace sieve_avx512
+{
+static const unsigned int nVectorWords = 512 / nWordBits;
+
+// Truth tables for _mm512_ternarylogic_epi64(a, b, c, imm)
+static const int TERNARY_OR = 0xfe;      // a | b | c
+static const int TERNARY_NOT_AND = 0x7f; // ~(a & b & c)
+
+/** Mask of the words [nWord, nMaxWord) within a vector. The final partial
+ *  vector of a range is processed with masked loads and stores. */
+static inline __mmask8 WordMask(unsigned int nWord, unsigned int nMaxWord)
+{
+    return (nMaxWord - nWord >= nVectorWords) ? (__mmask8)0xff : (__mmask8)((1u << (nMaxWord - nWord)) - 1);
+}
+
+void ApplyLayerTWNBoth(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    for (unsigned int nWord = nMinWord; nWord < nMaxWord; nWord += nVectorWords)
+    {
+        const __mmask8 mask = WordMask(nWord, nMaxWord);
+        const __m512i xCC1Layer = _mm512_maskz_loadu_epi64(mask, &vfLayerCC1[nWord]);
+        const __m512i xCC2Layer = _mm512_maskz_loadu_epi64(mask, &vfLayerCC2[nWord]);
+        _mm512_mask_storeu_epi64(&vfCC1[nWord], mask, _mm512_or_si512(_mm512_maskz_loadu_epi64(mask, &vfCC1[nWord]), xCC1Layer));
+        _mm512_mask_storeu_epi64(&vfCC2[nWord], mask, _mm512_or_si512(_mm512_maskz_loadu_epi64(mask, &vfCC2[nWord]), xCC2Layer));
+        _mm512_mask_storeu_epi64(&vfTWN[nWord], mask, _mm512_ternarylogic_epi64(_mm512_maskz_loadu_epi64(mask, &vfTWN[nWord]), xCC1Layer, xCC2Layer, TERNARY_OR));
+    }
+}
+
+void ApplyLayerTWNOnlyCC1(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, sieve_word_t* vfTWN, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    for (unsigned int nWord = nMinWord; nWord < nMaxWord; nWord += nVectorWords)
+    {
+        const __mmask8 mask = WordMask(nWord, nMaxWord);
+        const __m512i xCC1Layer = _mm512_maskz_loadu_epi64(mask, &vfLayerCC1[nWord]);
+        const __m512i xCC2Layer = _mm512_maskz_loadu_epi64(mask, &vfLayerCC2[nWord]);
+        _mm512_mask_storeu_epi64(&vfCC1[nWord], mask, _mm512_or_si512(_mm512_maskz_loadu_epi64(mask, &vfCC1[nWord]), xCC1Layer));
+        _mm512_mask_storeu_epi64(&vfCC2[nWord], mask, _mm512_or_si512(_mm512_maskz_loadu_epi64(mask, &vfCC2[nWord]), xCC2Layer));
+        _mm512_mask_storeu_epi64(&vfTWN[nWord], mask, _mm512_or_si512(_mm512_maskz_loadu_epi64(mask, &vfTWN[nWord]), xCC1Layer));
+    }
+}
+
+void ApplyLayerTWNNone(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCC1, sieve_word_t* vfCC2, const sieve_word_t* vfLayerCC1, const sieve_word_t* vfLayerCC2)
+{
+    for (unsigned int nWord = nMinWord; nWord < nMaxWord; nWord += nVectorWords)
+    {
+        const __mmask8 mask = WordMask(nWord, nMaxWord);
+        const __m512i xCC1Layer = _mm512_maskz_loadu_epi64(mask, &vfLayerCC1[nWord]);
+        const __m512i xCC2Layer = _mm512_maskz_loadu_epi64(mask, &vfLayerCC2[nWord]);
+        _mm512_mask_storeu_epi64(&vfCC1[nWord], mask, _mm512_or_si512(_mm512_maskz_loadu_epi64(mask, &vfCC1[nWord]), xCC1Layer));
+        _mm512_mask_storeu_epi64(&vfCC2[nWord], mask, _mm512_or_si512(_mm512_maskz_loadu_epi64(mask, &vfCC2[nWord]), xCC2Layer));
+    }
+}
+
+void CombineBitsets(unsigned int nMinWord, unsigned int nMaxWord, sieve_word_t* vfCandidates, const sieve_word_t* vfCC1, const sieve_word_t* vfCC2, const sieve_word_t* vfTWN)
+{
+    for (unsigned int nWord = nMinWord; nWord < nMaxWord; nWord += nVectorWords)
+    {
+        const __mmask8 mask = WordMask(nWord, nMaxWord);
+        const __m512i xCompositesCC1 = _mm512_maskz_loadu_epi64(mask, &vfCC1[nWord]);
+        const __m512i xCompositesCC2 = _mm512_maskz_loadu_epi64(mask, &vfCC2[nWord]);
+        const __m512i xCompositesBiTwin = _mm512_maskz_loadu_epi64(mask, &vfTWN[nWord]);
+        _mm512_mask_storeu_epi64(&vfCandidates[nWord], mask, _mm512_ternarylogic_epi64(xCompositesCC1, xCompositesCC2, xCompositesBiTwin, TERNARY_NOT_AND));
+    }
+}
+
+unsigned int FindNonZeroWord(unsigned int nMinWord, unsigned int nMaxWord, const sieve_word_t* vfBits)
+{
+    for (unsigned int nWord = nMinWord; nWord < nMaxWord; nWord += nVectorWords)
+    {
+        const __m512i xBits = _mm512_maskz_loadu_epi64(WordMask(nWord, nMaxWord), &vfBits[nWord]);
+        const __mmask8 nonzero = _mm512_test_epi64_mask(xBits, xBits);
+        if (nonzero)
+            return nWord + __builtin_ctz(nonzero);
+    }
+    return nMaxWord;
+}
+} // namespace sieve_avx512
+
+#endif
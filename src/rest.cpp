@@ -6,6 +6,8 @@
 #include "chain.h"
 #include "chainparams.h"
 #include "core_io.h"
+#include "crypto/sha256.h"
+#include "datahashindex.h"
 #include "primitives/block.h"
 #include "primitives/transaction.h"
 #include "validation.h"
@@ -14,6 +16,7 @@
 #include "rpc/server.h"
 #include "streams.h"
 #include "sync.h"
+#include "txdb.h"
 #include "txmempool.h"
 #include "utilstrencodings.h"
 #include "version.h"
@@ -381,6 +384,170 @@ static bool rest_tx(HTTPRequest* req, const std::string& strURIPart)
     }
 }
 
+enum ByteRange {
+    RANGE_NONE,
+    RANGE_OK,
+    RANGE_UNSATISFIABLE,
+};
+
+/** Parse a Range header of a single "bytes=" range. Anything else is
+ *  answered with the whole payload, as HTTP allows. */
+static enum ByteRange ParseByteRange(const std::string& strRange, uint64_t nSize, uint64_t& nStart, uint64_t& nLength)
+{
+    if (strRange.compare(0, 6, "bytes=") != 0 || strRange.find(',') != std::string::npos)
+        return RANGE_NONE;
+    const std::string::size_type pos = strRange.find('-', 6);
+    if (pos == std::string::npos)
+        return RANGE_NONE;
+    const std::string strFirst = boost::trim_copy(strRange.substr(6, pos - 6));
+    const std::string strLast = boost::trim_copy(strRange.substr(pos + 1));
+
+    int64_t nFirst, nLast;
+    if (strFirst.empty()) {
+        // Suffix range: the last nLast bytes
+        if (!ParseInt64(strLast, &nLast) || nLast < 0)
+            return RANGE_NONE;
+        if (nLast == 0 || nSize == 0)
+            return RANGE_UNSATISFIABLE;
+        nLength = std::min((uint64_t)nLast, nSize);
+        nStart = nSize - nLength;
+        return RANGE_OK;
+    }
+    if (!ParseInt64(strFirst, &nFirst) || nFirst < 0)
+        return RANGE_NONE;
+    if (strLast.empty())
+        nLast = std::numeric_limits<int64_t>::max();
+    else if (!ParseInt64(strLast, &nLast) || nLast < nFirst)
+        return RANGE_NONE;
+    if ((uint64_t)nFirst >= nSize)
+        return RANGE_UNSATISFIABLE;
+    nStart = nFirst;
+    nLength = std::min((uint64_t)nLast, nSize - 1) - nStart + 1;
+    return RANGE_OK;
+}
+
+static bool rest_data(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string hashStr;
+    const RetFormat rf = ParseDataFormat(hashStr, strURIPart);
+    if (rf != RF_BINARY)
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: .bin)");
+
+    uint256 hash;
+    if (!ParseHashStr(hashStr, hash))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
+
+    // With the data index only the requested bytes are read from the block
+    // file; otherwise the payload comes with its transaction.
+    CDiskDataPos pos;
+    std::vector<unsigned char> data;
+    const bool fIndexed = fDataIndex && pdataindex->ReadDataIndex(hash, pos);
+    if (!fIndexed) {
+        CTransactionRef tx;
+        uint256 hashBlock;
+        if (!GetTransaction(hash, tx, Params().GetConsensus(), hashBlock, true))
+            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        data = tx->data;
+        pos.nSize = data.size();
+        CSHA256().Write(data.data(), data.size()).Finalize(pos.hash.begin());
+    }
+
+    // The payload of a txid never changes, so its hash is a strong validator
+    const std::string strETag = "\"" + HexStr(pos.hash.begin(), pos.hash.end()) + "\"";
+    req->WriteHeader("ETag", strETag);
+    req->WriteHeader("Accept-Ranges", "bytes");
+
+    const std::pair<bool, std::string> ifNoneMatch = req->GetHeader("If-None-Match");
+    if (ifNoneMatch.first && (ifNoneMatch.second == strETag || ifNoneMatch.second == "*")) {
+        req->WriteReply(HTTP_NOT_MODIFIED);
+        return true;
+    }
+
+    uint64_t nStart = 0, nLength = pos.nSize;
+    enum ByteRange range = RANGE_NONE;
+    const std::pair<bool, std::string> rangeHeader = req->GetHeader("Range");
+    const std::pair<bool, std::string> ifRange = req->GetHeader("If-Range");
+    if (rangeHeader.first && (!ifRange.first || ifRange.second == strETag))
+        range = ParseByteRange(rangeHeader.second, pos.nSize, nStart, nLength);
+    if (range == RANGE_UNSATISFIABLE) {
+        req->WriteHeader("Content-Range", strprintf("bytes */%u", pos.nSize));
+        return RESTERR(req, HTTP_RANGE_NOT_SATISFIABLE, "Range not satisfiable");
+    }
+
+    std::vector<unsigned char> vchReply;
+    if (fIndexed) {
+        if (!ReadDataFromDisk(pos, vchReply, nStart, nLength))
+            return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Failed to read data of " + hashStr);
+    } else {
+        vchReply.assign(data.begin() + nStart, data.begin() + nStart + nLength);
+    }
+
+    req->WriteHeader("Content-Type", "application/octet-stream");
+    req->WriteHeader("Content-Length", std::to_string(vchReply.size()));
+    if (range == RANGE_OK) {
+        req->WriteHeader("Content-Range", strprintf("bytes %u-%u/%u", nStart, nStart + nLength - 1, pos.nSize));
+        req->WriteReply(HTTP_PARTIAL_CONTENT, std::string(vchReply.begin(), vchReply.end()));
+    } else {
+        req->WriteReply(HTTP_OK, std::string(vchReply.begin(), vchReply.end()));
+    }
+    return true;
+}
+
+static bool rest_data_hash(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string hashStr;
+    const RetFormat rf = ParseDataFormat(hashStr, strURIPart);
+
+    // The SHA256 of the payload as sha256sum prints it, not reversed like txids
+    if (!IsHex(hashStr) || hashStr.size() != 64)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
+    uint256 hash(ParseHex(hashStr));
+
+    if (!g_datahashindex)
+        return RESTERR(req, HTTP_NOT_FOUND, "Data hash index is not enabled (use -datahashindex)");
+    if (!g_datahashindex->IsSynced())
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Data hash index is being built");
+
+    std::vector<std::pair<uint256, int> > vTx;
+    if (!g_datahashindex->FindData(hash, vTx, MAX_DATAHASH_RESULTS))
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Failed to read the data hash index");
+
+    switch (rf) {
+    case RF_BINARY: {
+        CDataStream ssTx(SER_NETWORK, PROTOCOL_VERSION);
+        ssTx << vTx;
+        std::string binaryTx = ssTx.str();
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, binaryTx);
+        return true;
+    }
+
+    case RF_HEX: {
+        CDataStream ssTx(SER_NETWORK, PROTOCOL_VERSION);
+        ssTx << vTx;
+        std::string strHex = HexStr(ssTx.begin(), ssTx.end()) + "\n";
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, strHex);
+        return true;
+    }
+
+    case RF_JSON: {
+        std::string strJSON = datatxsToJSON(vTx).write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+}
+
 static bool rest_getutxos(HTTPRequest* req, const std::string& strURIPart)
 {
     if (!CheckWarmup(req))
@@ -575,6 +742,8 @@ static const struct {
       {"/rest/mempool/contents", rest_mempool_contents},
       {"/rest/headers/", rest_headers},
       {"/rest/getutxos", rest_getutxos},
+      {"/rest/data/hash/", rest_data_hash},
+      {"/rest/data/", rest_data},
 };
 
 bool StartREST()
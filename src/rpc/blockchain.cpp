@@ -12,6 +12,10 @@
 #include "checkpoints.h"
 #include "coins.h"
 #include "consensus/validation.h"
+#include "crypto/sha256.h"
+#include "datahashindex.h"
+#include "filemanifest.h"
+#include "fs.h"
 #include "validation.h"
 #include "core_io.h"
 #include "policy/feerate.h"
@@ -39,6 +43,7 @@
 
 #include <mutex>
 #include <condition_variable>
+#include <thread>
 
 struct CUpdatedBlock
 {
@@ -100,7 +105,7 @@ UniValue blockheaderToJSON(const CBlockIndex* blockindex)
 
     if (blockindex->pprev) {
         result.push_back(Pair("previousblockhash", blockindex->pprev->GetBlockHash().GetHex()));
-		CBigNum bnPrimeChainOrigin = CBigNum(blockindex->GetHeaderHash()) * blockindex->bnPrimeChainMultiplier;
+		CBigNum bnPrimeChainOrigin = CBigNum(blockindex->GetHeaderHash()) * blockindex->bnPrimeChainMultiplier.GetBigNum();
 		result.push_back(Pair("primeorigin", bnPrimeChainOrigin.ToString()));
 	}
     CBlockIndex *pnext = chainActive.Next(blockindex);
@@ -910,6 +915,159 @@ UniValue pruneblockchain(const JSONRPCRequest& request)
     return uint64_t(height);
 }
 
+UniValue datatxsToJSON(const std::vector<std::pair<uint256, int> >& vTx)
+{
+    UniValue result(UniValue::VARR);
+    for (const auto& entry : vTx) {
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("txid", entry.first.GetHex()));
+        obj.push_back(Pair("height", entry.second));
+        result.push_back(obj);
+    }
+    return result;
+}
+
+UniValue getdatabyhash(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 2)
+        throw std::runtime_error(
+            "getdatabyhash \"sha256\" ( count )\n"
+            "\nReturns the transactions of the active chain whose data payload has the given SHA256.\n"
+            "Requires -datahashindex.\n"
+            "\nArguments:\n"
+            "1. \"sha256\"     (string, required) The SHA256 of the payload, as printed by sha256sum\n"
+            "2. count          (numeric, optional, default=" + std::to_string(DEFAULT_DATAHASH_RESULTS) + ") The maximum number of transactions to return\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"txid\" : \"id\",  (string) The transaction id\n"
+            "    \"height\" : n,     (numeric) The height of the block containing it\n"
+            "  }, ...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getdatabyhash", "\"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855\"")
+            + HelpExampleRpc("getdatabyhash", "\"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855\"")
+        );
+
+    if (!g_datahashindex)
+        throw JSONRPCError(RPC_MISC_ERROR, "Data hash index is not enabled (use -datahashindex)");
+    if (!g_datahashindex->IsSynced())
+        throw JSONRPCError(RPC_IN_WARMUP, strprintf("Data hash index is being built (height %d)", g_datahashindex->GetHeight()));
+
+    std::string strHash = request.params[0].get_str();
+    if (!IsHex(strHash) || strHash.size() != 64)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "sha256 must be a 64 character hex string");
+    uint256 hash(ParseHex(strHash));
+
+    int nCount = DEFAULT_DATAHASH_RESULTS;
+    if (!request.params[1].isNull())
+        nCount = request.params[1].get_int();
+    if (nCount < 1 || nCount > (int)MAX_DATAHASH_RESULTS)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("count must be between 1 and %u", MAX_DATAHASH_RESULTS));
+
+    std::vector<std::pair<uint256, int> > vTx;
+    if (!g_datahashindex->FindData(hash, vTx, nCount))
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to read the data hash index");
+    return datatxsToJSON(vTx);
+}
+
+UniValue retrievefile(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 2)
+        throw std::runtime_error(
+            "retrievefile \"manifest\" \"filename\"\n"
+            "\nReassembles a file stored by storefile into a server-side file, and checks it against its manifest.\n"
+            "This does not allow overwriting existing files.\n"
+            "\nArguments:\n"
+            "1. \"manifest\"    (string, required) The id of the manifest transaction\n"
+            "2. \"filename\"    (string, required) The filename with path (either absolute or relative to datacoind)\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"filename\" : \"name\",   (string) The filename with full absolute path\n"
+            "  \"name\" : \"name\",       (string) The name the file was stored with\n"
+            "  \"size\" : n,             (numeric) The size of the file\n"
+            "  \"sha256\" : \"hash\"      (string) The SHA256 of the file\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("retrievefile", "\"txid\" \"picture.png\"")
+            + HelpExampleRpc("retrievefile", "\"txid\", \"picture.png\"")
+        );
+
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+
+    uint256 hashManifest = ParseHashV(request.params[0], "manifest");
+    std::vector<unsigned char> vchManifest;
+    if (!GetTransactionData(hashManifest, vchManifest, consensusParams))
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available about transaction");
+    CFileManifest manifest;
+    try {
+        CDataStream ssManifest(vchManifest, SER_NETWORK, PROTOCOL_VERSION);
+        ssManifest >> manifest;
+    } catch (const std::exception&) {
+        throw JSONRPCError(RPC_DESERIALIZATION_ERROR, "Transaction is not a file manifest");
+    }
+    if (manifest.nVersion > CFileManifest::CURRENT_VERSION)
+        throw JSONRPCError(RPC_DESERIALIZATION_ERROR, strprintf("Unknown file manifest version %d", manifest.nVersion));
+
+    fs::path filepath = fs::absolute(request.params[1].get_str());
+    if (fs::exists(filepath))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, filepath.string() + " already exists. If you are sure this is what you want, move it out of the way first");
+    FILE* file = fsbridge::fopen(filepath, "wb");
+    if (!file)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Cannot open " + filepath.string());
+
+    // Chunks are fetched RETRIEVEFILE_THREADS at a time, as transaction
+    // reads do not hold cs_main, and written out in order as each batch
+    // completes.
+    CSHA256 hasher;
+    uint64_t nSize = 0;
+    std::string strError;
+    for (size_t nBatch = 0; nBatch < manifest.vChunks.size() && strError.empty(); nBatch += RETRIEVEFILE_THREADS) {
+        const size_t nCount = std::min<size_t>(RETRIEVEFILE_THREADS, manifest.vChunks.size() - nBatch);
+        std::vector<std::vector<unsigned char> > vData(nCount);
+        std::vector<char> vFound(nCount, false);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < nCount; i++) {
+            threads.emplace_back([&, i]() {
+                vFound[i] = GetTransactionData(manifest.vChunks[nBatch + i], vData[i], consensusParams);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        for (size_t i = 0; i < nCount; i++) {
+            if (!vFound[i]) {
+                strError = "Chunk " + manifest.vChunks[nBatch + i].GetHex() + " not found";
+                break;
+            }
+            if (fwrite(vData[i].data(), 1, vData[i].size(), file) != vData[i].size()) {
+                strError = "Cannot write " + filepath.string();
+                break;
+            }
+            hasher.Write(vData[i].data(), vData[i].size());
+            nSize += vData[i].size();
+        }
+    }
+    if (fclose(file) != 0 && strError.empty())
+        strError = "Cannot write " + filepath.string();
+
+    uint256 hash;
+    hasher.Finalize(hash.begin());
+    if (strError.empty() && (nSize != manifest.nSize || hash != manifest.hash))
+        strError = "File does not match its manifest";
+    if (!strError.empty()) {
+        fs::remove(filepath);
+        throw JSONRPCError(RPC_MISC_ERROR, strError);
+    }
+
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair("filename", filepath.string()));
+    result.push_back(Pair("name", manifest.strName));
+    result.push_back(Pair("size", nSize));
+    result.push_back(Pair("sha256", HexStr(hash.begin(), hash.end())));
+    return result;
+}
+
 UniValue gettxoutsetinfo(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0)
@@ -1897,6 +2055,8 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getblockhash",           &getblockhash,           {"height"} },
     { "blockchain",         "getblockheader",         &getblockheader,         {"blockhash","verbose"} },
     { "blockchain",         "getchaintips",           &getchaintips,           {} },
+    { "blockchain",         "getdatabyhash",          &getdatabyhash,          {"sha256","count"} },
+    { "blockchain",         "retrievefile",           &retrievefile,           {"manifest","filename"} },
     { "blockchain",         "getdifficulty",          &getdifficulty,          {} },
     { "blockchain",         "getmempoolancestors",    &getmempoolancestors,    {"txid","verbose"} },
     { "blockchain",         "getmempooldescendants",  &getmempooldescendants,  {"txid","verbose"} },
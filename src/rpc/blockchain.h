@@ -5,9 +5,13 @@
 #ifndef BITCOIN_RPC_BLOCKCHAIN_H
 #define BITCOIN_RPC_BLOCKCHAIN_H
 
+#include <utility>
+#include <vector>
+
 class CBlock;
 class CBlockIndex;
 class UniValue;
+class uint256;
 
 /**
  * Get the difficulty of the net wrt to the given block index, or the chain tip if
@@ -33,5 +37,8 @@ UniValue mempoolToJSON(bool fVerbose = false);
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex* blockindex);
 
+/** Transactions found in the data hash index to JSON */
+UniValue datatxsToJSON(const std::vector<std::pair<uint256, int> >& vTx);
+
 #endif
 
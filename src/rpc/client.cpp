@@ -66,6 +66,9 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "listaccounts", 1, "include_watchonly" },
     { "walletpassphrase", 1, "timeout" },
     { "getblocktemplate", 0, "template_request" },
+    { "getpoolshares", 0, "startheight" },
+    { "getpoolshares", 1, "endheight" },
+    { "getpoolshares", 2, "count" },
     { "listsinceblock", 1, "target_confirmations" },
     { "listsinceblock", 2, "include_watchonly" },
     { "listsinceblock", 3, "include_removed" },
@@ -87,6 +90,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getblock", 1, "verbose" },
     { "getblockheader", 1, "verbose" },
     { "getchaintxstats", 0, "nblocks" },
+    { "getdatabyhash", 1, "count" },
+    { "storefile", 1, "chunksize" },
     { "gettransaction", 1, "include_watchonly" },
     { "getrawtransaction", 1, "verbose" },
     { "createrawtransaction", 0, "inputs" },
@@ -147,6 +152,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "setgenerate", 1, "genproclimit"}, // ConvertTo<boost::int64_t>(params[0]);
     { "setsievesize", 0, "sievesize"}, // ConvertTo<boost::int64_t>(params[0]);
     { "setsievefilterprimes", 0, "number_of_primes"}, // ConvertTo<boost::int64_t>(params[0]);
+    { "getprimespersec", 0, "verbose" },
     { "setsieveextensions", 0, "sieveextensions"}, // ConvertTo<boost::int64_t>(params[0]);
     { "sendalert", 2, "minver"}, // ConvertTo<boost::int64_t>(params[2]);
     { "sendalert", 3, "maxver"}, // ConvertTo<boost::int64_t>(params[3]);
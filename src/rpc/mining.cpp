@@ -27,6 +27,7 @@
 #include "validationinterface.h"
 #include "warnings.h"
 #include "prime/prime.h"
+#include "madpool/primeserver.h"
 
 #include <memory>
 #include <stdint.h>
@@ -162,14 +163,119 @@ UniValue setsieveextensions(const JSONRPCRequest& request)
 
 UniValue getprimespersec(const JSONRPCRequest& request)
 {
-    if (request.fHelp || request.params.size() != 0)
+    if (request.fHelp || request.params.size() > 1)
         throw std::runtime_error(
-            "getprimespersec\n"
-            "Returns a recent primes per second performance measurement while generating.");
+            "getprimespersec ( verbose )\n"
+            "Returns a recent primes per second performance measurement while generating.\n"
+            "\nArguments:\n"
+            "1. verbose         (boolean, optional, default=false) Also return the candidate test rate\n"
+            "\nResult (for verbose = false):\n"
+            "n                  (numeric) Primes per second\n"
+            "\nResult (for verbose = true):\n"
+            "{\n"
+            "  \"primespersec\" : n,  (numeric) Primes per second\n"
+            "  \"testspersec\" : n,   (numeric) Sieve candidates tested per second\n"
+            "  \"testbatchsize\" : n  (numeric) Number of candidates whose first Fermat tests run together\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getprimespersec", "true")
+            + HelpExampleRpc("getprimespersec", "true")
+        );
+
+    if (request.params.size() > 0 && request.params[0].get_bool())
+    {
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("primespersec", dPrimesPerSec));
+        obj.push_back(Pair("testspersec", dTestsPerSec));
+        obj.push_back(Pair("testbatchsize", (int)CPrimalityTestBatch::nMaxSize));
+        return obj;
+    }
 
     return (boost::int64_t)dPrimesPerSec;
 }
 
+UniValue getpoolstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getpoolstats\n"
+            "Returns the pool server statistics of the last minute, summed over its worker threads.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"name\" : \"name\",     (string) The -servername of the pool\n"
+            "  \"threads\" : n,         (numeric) Number of worker threads\n"
+            "  \"workers\" : n,         (numeric) Number of miners that requested work for the previous block\n"
+            "  \"latency\" : n,         (numeric) Average latency reported by the miners in milliseconds\n"
+            "  \"cpd\" : x.x,           (numeric) Chains per day reported by the miners\n"
+            "  \"sharequeue\" : n,      (numeric) Number of shares waiting for or in validation\n"
+            "  \"shares\" : n,          (numeric) Number of shares validated\n"
+            "  \"sharesbusy\" : n,      (numeric) Number of shares refused because the client or the validators had too many waiting\n"
+            "  \"sharelatency\" : n,    (numeric) Average time from receiving a share to its reply in milliseconds\n"
+            "  \"tablemem\" : n,        (numeric) Memory of the duplicate work, request and share tables in kilobytes\n"
+            "  \"requests\" : [         (array) Requests handled\n"
+            "    {\n"
+            "      \"type\" : \"type\",   (string) Request type\n"
+            "      \"error\" : \"error\", (string) Reply error\n"
+            "      \"count\" : n        (numeric) Number of requests\n"
+            "    }\n"
+            "    ,...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getpoolstats", "")
+            + HelpExampleRpc("getpoolstats", "")
+        );
+
+    LOCK(cs_primeserver);
+    if (!gPrimeServer)
+        throw JSONRPCError(RPC_MISC_ERROR, "Pool server is not running");
+
+    return gPrimeServer->GetStats();
+}
+
+UniValue getpoolshares(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 3)
+        throw std::runtime_error(
+            "getpoolshares startheight ( endheight count )\n"
+            "Returns the shares accepted by the pool server from the share log, ordered by height.\n"
+            "Shares are written in batches, the last second of shares may be missing.\n"
+            "\nArguments:\n"
+            "1. startheight    (numeric, required) First block height of the shares\n"
+            "2. endheight      (numeric, optional, default=startheight) Last block height of the shares\n"
+            "3. count          (numeric, optional, default=1000) Maximum number of shares, at most 100000\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"addr\" : \"address\",  (string) Payout address of the miner\n"
+            "    \"name\" : \"name\",     (string) Name of the miner\n"
+            "    \"height\" : n,          (numeric) Height of the block the share was mined for\n"
+            "    \"length\" : n,          (numeric) Chain length of the share, as verified\n"
+            "    \"chaintype\" : n,       (numeric) Chain type of the share\n"
+            "    \"time\" : ttt           (numeric) Time the share was received in seconds since epoch\n"
+            "  }\n"
+            "  ,...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getpoolshares", "1000 1010")
+            + HelpExampleRpc("getpoolshares", "1000, 1010, 5000")
+        );
+
+    LOCK(cs_primeserver);
+    if (!gPrimeServer)
+        throw JSONRPCError(RPC_MISC_ERROR, "Pool server is not running");
+
+    int nStartHeight = request.params[0].get_int();
+    int nEndHeight = request.params.size() > 1 ? request.params[1].get_int() : nStartHeight;
+    int nCount = request.params.size() > 2 ? request.params[2].get_int() : 1000;
+    if (nStartHeight < 0 || nEndHeight < nStartHeight)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid height range");
+    if (nCount < 0)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative count");
+
+    return gPrimeServer->GetShares(nStartHeight, nEndHeight, nCount);
+}
+
 
 extern UniValue getdifficulty(const JSONRPCRequest& request);
 
@@ -1054,7 +1160,9 @@ static const CRPCCommand commands[] =
     { "mining",             "setsievefilterprimes",   &setsievefilterprimes,   {"number_of_primes"} },
     { "mining",             "getsieveextensions",     &getsieveextensions,     {} },
     { "mining",             "setsieveextensions",     &setsieveextensions,     {"sieveextensions"} },
-    { "mining",             "getprimespersec",        &getprimespersec,        {} },
+    { "mining",             "getprimespersec",        &getprimespersec,        {"verbose"} },
+    { "mining",             "getpoolstats",           &getpoolstats,           {} },
+    { "mining",             "getpoolshares",          &getpoolshares,          {"startheight","endheight","count"} },
 
     { "generating",         "generatetoaddress",      &generatetoaddress,      {"nblocks","address","maxtries"} },
 
@@ -0,0 +1,206 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "madpool/pool.h"
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(pool_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(busy_reply)
+{
+    // Clients that know BUSY send the share again
+    proto::Reply rep;
+    BOOST_CHECK_EQUAL(SetBusyReply(rep, POOL_BUSY_VERSION), proto::Reply::BUSY);
+    BOOST_CHECK(!rep.has_errstr());
+    BOOST_CHECK_EQUAL(SetBusyReply(rep, POOL_BUSY_VERSION + 1), proto::Reply::BUSY);
+
+    // Older clients are told why the share was dropped
+    BOOST_CHECK_EQUAL(SetBusyReply(rep, POOL_BUSY_VERSION - 1), proto::Reply::STALE);
+    BOOST_CHECK(rep.has_errstr());
+}
+
+BOOST_AUTO_TEST_CASE(client_shares)
+{
+    PoolClientShares shares(2);
+    BOOST_CHECK(!shares.Full("a"));
+    shares.Add("a");
+    BOOST_CHECK(!shares.Full("a"));
+    shares.Add("a");
+    BOOST_CHECK(shares.Full("a"));
+    BOOST_CHECK_EQUAL(shares.Count("a"), 2U);
+
+    // The limit is per client
+    BOOST_CHECK(!shares.Full("b"));
+    shares.Add("b");
+    BOOST_CHECK_EQUAL(shares.Clients(), 2U);
+
+    // A client is forgotten once its last share is checked
+    shares.Remove("a");
+    BOOST_CHECK(!shares.Full("a"));
+    shares.Remove("a");
+    shares.Remove("b");
+    BOOST_CHECK_EQUAL(shares.Count("a"), 0U);
+    BOOST_CHECK_EQUAL(shares.Clients(), 0U);
+    shares.Remove("c");
+    BOOST_CHECK_EQUAL(shares.Clients(), 0U);
+
+    // At least one share per client
+    PoolClientShares single(0);
+    BOOST_CHECK(!single.Full("a"));
+    single.Add("a");
+    BOOST_CHECK(single.Full("a"));
+}
+
+BOOST_AUTO_TEST_CASE(share_validator_queue)
+{
+    // Without threads the shares stay queued, the validator deletes them
+    ShareValidator validator(nullptr, 0, 2);
+    BOOST_CHECK(!validator.Full());
+    BOOST_CHECK(validator.Push(new PoolShare()));
+    BOOST_CHECK(!validator.Full());
+    BOOST_CHECK(validator.Push(new PoolShare()));
+    BOOST_CHECK(validator.Full());
+
+    PoolShare* share = new PoolShare();
+    BOOST_CHECK(!validator.Push(share));
+    delete share;
+
+    // A stopped validator refuses every share
+    ShareValidator stopped(nullptr, 0, 2);
+    stopped.Stop();
+    BOOST_CHECK(stopped.Full());
+    share = new PoolShare();
+    BOOST_CHECK(!stopped.Push(share));
+    delete share;
+}
+
+BOOST_AUTO_TEST_CASE(hash_table_insert)
+{
+    PoolHashTable<unsigned> table;
+    std::vector<uint256> keys;
+    for (unsigned i = 0; i < 100; i++) {
+        keys.push_back(InsecureRand256());
+        BOOST_CHECK(table.Insert(keys.back(), i));
+    }
+    BOOST_CHECK_EQUAL(table.Size(), 100U);
+    for (unsigned i = 0; i < keys.size(); i++) {
+        const unsigned* value = table.Find(keys[i]);
+        BOOST_CHECK(value && *value == i);
+    }
+    BOOST_CHECK(!table.Find(InsecureRand256()));
+
+    // A duplicate keeps the first value
+    BOOST_CHECK(!table.Insert(keys[0], 1000));
+    BOOST_CHECK_EQUAL(*table.Find(keys[0]), 0U);
+    BOOST_CHECK_EQUAL(table.Size(), 100U);
+
+    table.Clear();
+    BOOST_CHECK_EQUAL(table.Size(), 0U);
+    BOOST_CHECK(!table.Find(keys[0]));
+    BOOST_CHECK_EQUAL(table.DynamicMemoryUsage(), 0U);
+    BOOST_CHECK(table.Insert(keys[0]));
+}
+
+BOOST_AUTO_TEST_CASE(hash_table_rotate)
+{
+    PoolHashTable<bool> table;
+    std::vector<uint256> older, current;
+    while (!table.Full()) {
+        older.push_back(InsecureRand256());
+        BOOST_CHECK(table.Insert(older.back()));
+    }
+
+    // The next key starts a new generation, the first one is still known
+    current.push_back(InsecureRand256());
+    BOOST_CHECK(table.Insert(current.back()));
+    BOOST_CHECK(!table.Full());
+    BOOST_CHECK_EQUAL(table.Size(), older.size() + 1);
+    for (const uint256& key : older)
+        BOOST_CHECK(!table.Insert(key));
+
+    // Filling the second generation drops the first but keeps the second
+    while (!table.Full()) {
+        current.push_back(InsecureRand256());
+        BOOST_CHECK(table.Insert(current.back()));
+    }
+    size_t nMemory = table.DynamicMemoryUsage();
+    BOOST_CHECK(table.Insert(InsecureRand256()));
+    BOOST_CHECK_EQUAL(table.Size(), current.size() + 1);
+    for (const uint256& key : older)
+        BOOST_CHECK(!table.Find(key));
+    for (const uint256& key : current)
+        BOOST_CHECK(table.Find(key));
+    BOOST_CHECK_EQUAL(table.DynamicMemoryUsage(), nMemory);
+}
+
+BOOST_AUTO_TEST_CASE(work_tables_rotate)
+{
+    PoolWorkTables tables;
+    uint256 work = InsecureRand256();
+    BOOST_CHECK(tables.works.Insert(work, 1));
+    BOOST_CHECK(!tables.MakeRoom());
+
+    // A full share table rotates the works with it, the work is dropped with
+    // the generation after the one it was inserted in
+    for (unsigned i = 0; i < 2; i++) {
+        while (!tables.shares.Full())
+            tables.shares.Insert(InsecureRand256());
+        BOOST_CHECK(tables.works.Find(work));
+        BOOST_CHECK(tables.MakeRoom());
+        BOOST_CHECK(!tables.shares.Full());
+    }
+    BOOST_CHECK(!tables.works.Find(work));
+    BOOST_CHECK(!tables.MakeRoom());
+
+    tables.Clear();
+    BOOST_CHECK_EQUAL(tables.DynamicMemoryUsage(), 0U);
+    BOOST_CHECK_EQUAL(tables.TableMem(), 0U);
+}
+
+// Inserts keys into each table the way a worker does until every table
+// rotated twice, and returns the most keys a share table held
+static size_t FillWorkTables(PoolWorkTables& tables, size_t nMaxMemory)
+{
+    size_t nMaxShares = 0;
+    unsigned nRotations = 0;
+    while (nRotations < 2) {
+        if (tables.MakeRoom())
+            nRotations++;
+        tables.works.Insert(InsecureRand256(), nRotations);
+        tables.reqnonces.Insert(InsecureRand256());
+        tables.shares.Insert(InsecureRand256());
+        nMaxShares = std::max(nMaxShares, tables.shares.Size());
+        BOOST_REQUIRE(tables.DynamicMemoryUsage() <= nMaxMemory);
+        BOOST_REQUIRE_EQUAL(tables.TableMem(), tables.DynamicMemoryUsage() >> 10);
+    }
+    return nMaxShares;
+}
+
+BOOST_AUTO_TEST_CASE(work_tables_memory)
+{
+    // The limit is in MB, at least one
+    gArgs.ForceSetArg("-pooltablemem", "0");
+    BOOST_CHECK_EQUAL(GetPoolTableMemory(), 1U << 20);
+    gArgs.ForceSetArg("-pooltablemem", "1");
+    BOOST_CHECK_EQUAL(GetPoolTableMemory(), 1U << 20);
+
+    PoolWorkTables small(GetPoolTableMemory());
+    size_t nSmallShares = FillWorkTables(small, 1 << 20);
+    BOOST_CHECK(small.TableMem() <= 1024);
+    BOOST_CHECK(small.TableMem() > 0);
+
+    // A larger limit keeps more shares
+    gArgs.ForceSetArg("-pooltablemem", "4");
+    BOOST_CHECK_EQUAL(GetPoolTableMemory(), 4U << 20);
+    PoolWorkTables large(GetPoolTableMemory());
+    size_t nLargeShares = FillWorkTables(large, 4 << 20);
+    BOOST_CHECK(large.TableMem() <= 4 * 1024);
+    BOOST_CHECK(nLargeShares > nSmallShares);
+
+    gArgs.ForceSetArg("-pooltablemem", std::to_string(DEFAULT_POOL_TABLE_MEM));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
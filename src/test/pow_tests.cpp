@@ -5,6 +5,7 @@
 #include "chain.h"
 #include "chainparams.h"
 #include "pow.h"
+#include "prime/prime.h"
 #include "random.h"
 #include "util.h"
 #include "test/test_bitcoin.h"
@@ -83,4 +84,30 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(CheckProofOfWork_cache)
+{
+    const CBlock& genesis = Params().GenesisBlock();
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    unsigned int nChainType = 0, nChainLength = 0;
+    unsigned int nChainTypeUncached = 0, nChainLengthUncached = 0;
+    BOOST_CHECK(CheckPrimeProofOfWork(genesis.GetHeaderHash(), genesis.nBits, genesis.bnPrimeChainMultiplier, nChainTypeUncached, nChainLengthUncached));
+
+    // The second call is answered from the cache with the same chain
+    for (int i = 0; i < 2; i++) {
+        const uint64_t nHits = GetPowCacheHits();
+        nChainType = nChainLength = 0;
+        BOOST_CHECK(CheckProofOfWork(genesis.GetHeaderHash(), genesis.nBits, consensusParams, genesis.bnPrimeChainMultiplier, nChainType, nChainLength));
+        BOOST_CHECK_EQUAL(nChainType, nChainTypeUncached);
+        BOOST_CHECK_EQUAL(nChainLength, nChainLengthUncached);
+        if (i > 0)
+            BOOST_CHECK_EQUAL(GetPowCacheHits(), nHits + 1);
+    }
+
+    // A different multiplier or target must not hit the cached entry
+    const uint64_t nHits = GetPowCacheHits();
+    BOOST_CHECK(!CheckProofOfWork(genesis.GetHeaderHash(), genesis.nBits, consensusParams, genesis.bnPrimeChainMultiplier + 2, nChainType, nChainLength, true));
+    BOOST_CHECK(!CheckProofOfWork(genesis.GetHeaderHash(), TargetFromInt(TargetGetLength(nChainLengthUncached) + 1), consensusParams, genesis.bnPrimeChainMultiplier, nChainType, nChainLength, true));
+    BOOST_CHECK_EQUAL(GetPowCacheHits(), nHits);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,500 @@
+// Copyright (c) 2017 The Datacoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "arith_uint256.h"
+#include "chain.h"
+#include "chainparams.h"
+#include "consensus/validation.h"
+#include "pow.h"
+#include "prime/prime.h"
+#include "prime/sieve_kernels.h"
+#include "streams.h"
+#include "test/test_bitcoin.h"
+#include "validation.h"
+
+#include <boost/test/unit_test.hpp>
+
+struct PrimeTestingSetup : public BasicTestingSetup {
+    PrimeTestingSetup() : BasicTestingSetup(CBaseChainParams::REGTEST) {}
+};
+
+struct PrimeChainTestingSetup : public TestingSetup {
+    PrimeChainTestingSetup() : TestingSetup(CBaseChainParams::REGTEST) {}
+};
+
+BOOST_FIXTURE_TEST_SUITE(prime_tests, PrimeTestingSetup)
+
+// The CBigNum implementation of CheckPrimeProofOfWork before the GMP engine,
+// kept as reference for the differential tests below
+static bool CheckPrimeProofOfWorkReference(uint256 hashBlockHeader, unsigned int nBits, const CBigNum& bnPrimeChainMultiplier, unsigned int& nChainType, unsigned int& nChainLength)
+{
+    if (TargetGetLength(nBits) < Params().GetConsensus().nTargetMinLength || TargetGetLength(nBits) > 99)
+        return false;
+    if (UintToArith256(hashBlockHeader) < hashBlockHeaderLimit)
+        return false;
+    CBigNum bnPrimeChainOrigin = CBigNum(hashBlockHeader) * bnPrimeChainMultiplier;
+    if (bnPrimeChainOrigin < bnPrimeMin || bnPrimeChainOrigin > bnPrimeMax)
+        return false;
+
+    unsigned int nChainLengthCunningham1 = 0;
+    unsigned int nChainLengthCunningham2 = 0;
+    unsigned int nChainLengthBiTwin = 0;
+    if (!ProbablePrimeChainTest(bnPrimeChainOrigin, nBits, false, nChainLengthCunningham1, nChainLengthCunningham2, nChainLengthBiTwin))
+        return false;
+    unsigned int nChainLengthCunningham1FermatTest = 0;
+    unsigned int nChainLengthCunningham2FermatTest = 0;
+    unsigned int nChainLengthBiTwinFermatTest = 0;
+    if (!ProbablePrimeChainTest(bnPrimeChainOrigin, nBits, true, nChainLengthCunningham1FermatTest, nChainLengthCunningham2FermatTest, nChainLengthBiTwinFermatTest))
+        return false;
+    if (nChainLengthCunningham1 != nChainLengthCunningham1FermatTest ||
+        nChainLengthCunningham2 != nChainLengthCunningham2FermatTest ||
+        nChainLengthBiTwin != nChainLengthBiTwinFermatTest)
+        return false;
+
+    nChainLength = nChainLengthCunningham1;
+    nChainType = PRIME_CHAIN_CUNNINGHAM1;
+    if (nChainLengthCunningham2 > nChainLength)
+    {
+        nChainLength = nChainLengthCunningham2;
+        nChainType = PRIME_CHAIN_CUNNINGHAM2;
+    }
+    if (nChainLengthBiTwin > nChainLength)
+    {
+        nChainLength = nChainLengthBiTwin;
+        nChainType = PRIME_CHAIN_BI_TWIN;
+    }
+
+    if (bnPrimeChainMultiplier % 2 == 0 && bnPrimeChainOrigin % 4 == 0)
+    {
+        unsigned int nChainLengthCunningham1Extended = 0;
+        unsigned int nChainLengthCunningham2Extended = 0;
+        unsigned int nChainLengthBiTwinExtended = 0;
+        if (ProbablePrimeChainTest(bnPrimeChainOrigin / 2, nBits, false, nChainLengthCunningham1Extended, nChainLengthCunningham2Extended, nChainLengthBiTwinExtended))
+        {
+            if (nChainLengthCunningham1Extended > nChainLength || nChainLengthCunningham2Extended > nChainLength || nChainLengthBiTwinExtended > nChainLength)
+                return false;
+        }
+    }
+    return true;
+}
+
+static void CheckChainTestMatches(const CBigNum& bnOrigin, unsigned int nBits)
+{
+    mpz_class mpzOrigin;
+    mpzOrigin.set_str(bnOrigin.GetHex(), 16);
+
+    unsigned int nCC1 = 0, nCC2 = 0, nTWN = 0;
+    unsigned int nCC1Fermat = 0, nCC2Fermat = 0, nTWNFermat = 0;
+    bool fChain = ProbablePrimeChainTest(bnOrigin, nBits, false, nCC1, nCC2, nTWN);
+    bool fChainFermat = ProbablePrimeChainTest(bnOrigin, nBits, true, nCC1Fermat, nCC2Fermat, nTWNFermat);
+
+    unsigned int nCC1Verify = 0, nCC2Verify = 0, nTWNVerify = 0;
+    unsigned int nCC1FermatVerify = 0, nCC2FermatVerify = 0, nTWNFermatVerify = 0;
+    bool fChainVerify = ProbablePrimeChainTestVerify(mpzOrigin, nBits, nCC1Verify, nCC2Verify, nTWNVerify, nCC1FermatVerify, nCC2FermatVerify, nTWNFermatVerify);
+
+    BOOST_CHECK_EQUAL(fChain, fChainVerify);
+    BOOST_CHECK_EQUAL(fChainFermat, nCC1FermatVerify >= nBits || nCC2FermatVerify >= nBits || nTWNFermatVerify >= nBits);
+    BOOST_CHECK_EQUAL(nCC1, nCC1Verify);
+    BOOST_CHECK_EQUAL(nCC2, nCC2Verify);
+    BOOST_CHECK_EQUAL(nTWN, nTWNVerify);
+    BOOST_CHECK_EQUAL(nCC1Fermat, nCC1FermatVerify);
+    BOOST_CHECK_EQUAL(nCC2Fermat, nCC2FermatVerify);
+    BOOST_CHECK_EQUAL(nTWNFermat, nTWNFermatVerify);
+}
+
+static uint256 RandomHeaderHash()
+{
+    uint256 hash = InsecureRand256();
+    *(hash.end() - 1) |= 0x80; // above hashBlockHeaderLimit
+    return hash;
+}
+
+BOOST_AUTO_TEST_CASE(chain_test_small_origins)
+{
+    // Small numbers reach Fermat pseudoprimes where the Euler-Lagrange-Lifchitz
+    // and the Fermat-only chains differ
+    for (unsigned int nOrigin = 4; nOrigin < 20000; nOrigin++)
+        CheckChainTestMatches(CBigNum(nOrigin), TargetFromInt(2));
+}
+
+BOOST_AUTO_TEST_CASE(chain_test_random_origins)
+{
+    const CBigNum bnPrimorial = CBigNum(2 * 3 * 5 * 7 * 11 * 13 * 17 * 19 * 23);
+    for (int i = 0; i < 2000; i++)
+    {
+        CBigNum bnHash(RandomHeaderHash());
+        CBigNum bnMultiplier(InsecureRandRange(1000000) + 1);
+        if (i % 4 != 0)
+            bnMultiplier *= bnPrimorial;
+        CheckChainTestMatches(bnHash * bnMultiplier, TargetFromInt(1));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(check_pow_genesis)
+{
+    const std::string vChains[] = {CBaseChainParams::MAIN, CBaseChainParams::TESTNET, CBaseChainParams::REGTEST};
+    for (const std::string& strChain : vChains)
+    {
+        SelectParams(strChain);
+        const CBlock& genesis = Params().GenesisBlock();
+        unsigned int nChainType = 0, nChainLength = 0;
+        unsigned int nChainTypeReference = 0, nChainLengthReference = 0;
+        BOOST_CHECK(CheckPrimeProofOfWork(genesis.GetHeaderHash(), genesis.nBits, genesis.bnPrimeChainMultiplier, nChainType, nChainLength));
+        BOOST_CHECK(CheckPrimeProofOfWorkReference(genesis.GetHeaderHash(), genesis.nBits, genesis.bnPrimeChainMultiplier, nChainTypeReference, nChainLengthReference));
+        BOOST_CHECK_EQUAL(nChainType, nChainTypeReference);
+        BOOST_CHECK_EQUAL(nChainLength, nChainLengthReference);
+    }
+    SelectParams(CBaseChainParams::REGTEST);
+}
+
+BOOST_AUTO_TEST_CASE(check_pow_differential)
+{
+    const CBigNum bnPrimorial = CBigNum(2 * 3 * 5 * 7 * 11 * 13 * 17 * 19 * 23);
+    unsigned int nValid = 0;
+    for (int i = 0; i < 2000; i++)
+    {
+        uint256 hash = RandomHeaderHash();
+        unsigned int nBits = TargetFromInt(1 + InsecureRandRange(2)) | InsecureRandBits(nFractionalBits);
+        CBigNum bnMultiplier = CBigNum(InsecureRandRange(100000) + 1) * bnPrimorial;
+        // Even multipliers run the normalization check
+        if (i % 2 == 0)
+            bnMultiplier /= 2;
+        unsigned int nChainType = 0, nChainLength = 0;
+        unsigned int nChainTypeReference = 0, nChainLengthReference = 0;
+        bool fValid = CheckPrimeProofOfWork(hash, nBits, bnMultiplier, nChainType, nChainLength, true);
+        bool fValidReference = CheckPrimeProofOfWorkReference(hash, nBits, bnMultiplier, nChainTypeReference, nChainLengthReference);
+        BOOST_CHECK_EQUAL(fValid, fValidReference);
+        if (fValid && fValidReference)
+        {
+            BOOST_CHECK_EQUAL(nChainType, nChainTypeReference);
+            BOOST_CHECK_EQUAL(nChainLength, nChainLengthReference);
+            nValid++;
+        }
+    }
+    BOOST_CHECK(nValid > 0);
+
+    // Out of range origins
+    unsigned int nChainType = 0, nChainLength = 0;
+    BOOST_CHECK(!CheckPrimeProofOfWork(RandomHeaderHash(), TargetFromInt(1), CBigNum(0), nChainType, nChainLength, true));
+    BOOST_CHECK(!CheckPrimeProofOfWork(RandomHeaderHash(), TargetFromInt(1), CBigNum(-1), nChainType, nChainLength, true));
+    BOOST_CHECK(!CheckPrimeProofOfWork(RandomHeaderHash(), TargetFromInt(1), bnOne << 1800, nChainType, nChainLength, true));
+}
+
+BOOST_AUTO_TEST_CASE(sieve_weave_threads)
+{
+    GeneratePrimeTable();
+    mpz_class mpzFixedMultiplier;
+    Primorial(nInitialPrimorialMultiplier, mpzFixedMultiplier);
+    for (unsigned int nWeaveThreads = 2; nWeaveThreads <= 5; nWeaveThreads++)
+    {
+        uint256 hash = RandomHeaderHash();
+        mpz_class mpzHash;
+        mpz_set_uint256(mpzHash.get_mpz_t(), hash);
+
+        // 2048 byte rounds split the sieve into 13 rounds
+        CSieveOfEratosthenes sieve;
+        CSieveOfEratosthenes sieveThreaded;
+        sieve.Reset(200000, 5000, 4, 2048, TargetFromInt(6), mpzHash, mpzFixedMultiplier, nullptr, 1);
+        sieveThreaded.Reset(200000, 5000, 4, 2048, TargetFromInt(6), mpzHash, mpzFixedMultiplier, nullptr, nWeaveThreads);
+        sieve.Weave();
+        sieveThreaded.Weave();
+        BOOST_CHECK(sieve.GetCandidateCount() > 0);
+        BOOST_CHECK_EQUAL(sieve.GetCandidateCount(), sieveThreaded.GetCandidateCount());
+
+        // Both sieves give the same candidates in the same order
+        unsigned int nMultiplier = 0, nCandidateType = 0;
+        unsigned int nMultiplierThreaded = 0, nCandidateTypeThreaded = 0;
+        unsigned int nMismatches = 0;
+        bool fMore, fMoreThreaded;
+        do
+        {
+            fMore = sieve.GetNextCandidateMultiplier(nMultiplier, nCandidateType);
+            fMoreThreaded = sieveThreaded.GetNextCandidateMultiplier(nMultiplierThreaded, nCandidateTypeThreaded);
+            if (fMore != fMoreThreaded || nMultiplier != nMultiplierThreaded || nCandidateType != nCandidateTypeThreaded)
+                nMismatches++;
+        } while (fMore && fMoreThreaded);
+        BOOST_CHECK_EQUAL(nMismatches, 0U);
+    }
+}
+
+static std::vector<sieve_word_t> RandomBitmap(unsigned int nWords)
+{
+    std::vector<sieve_word_t> vfBits(nWords);
+    for (sieve_word_t& nWord : vfBits)
+    {
+        // Mix in empty words for the scan
+        nWord = InsecureRandBits(2) ? (sieve_word_t)InsecureRandBits(nWordBits) : 0;
+    }
+    return vfBits;
+}
+
+BOOST_AUTO_TEST_CASE(sieve_kernels)
+{
+    const unsigned int nWords = 256;
+    const std::vector<SieveKernels> vKernels = SieveKernelsSupported();
+    BOOST_CHECK_EQUAL(vKernels.back().name, sieveKernelsScalar.name);
+    for (const SieveKernels& kernels : vKernels)
+    {
+        for (unsigned int i = 0; i < 200; i++)
+        {
+            // Ranges of any alignment and length, including empty ones
+            const unsigned int nMinWord = InsecureRandRange(nWords);
+            const unsigned int nMaxWord = nMinWord + InsecureRandRange(nWords - nMinWord + 1);
+            std::vector<sieve_word_t> vfLayerCC1 = RandomBitmap(nWords), vfLayerCC2 = RandomBitmap(nWords);
+            std::vector<sieve_word_t> vfExpected[4] = {RandomBitmap(nWords), RandomBitmap(nWords), RandomBitmap(nWords), RandomBitmap(nWords)};
+            std::vector<sieve_word_t> vfResult[4] = {vfExpected[0], vfExpected[1], vfExpected[2], vfExpected[3]};
+
+            sieveKernelsScalar.ApplyLayerTWNBoth(nMinWord, nMaxWord, vfExpected[0].data(), vfExpected[1].data(), vfExpected[2].data(), vfLayerCC1.data(), vfLayerCC2.data());
+            kernels.ApplyLayerTWNBoth(nMinWord, nMaxWord, vfResult[0].data(), vfResult[1].data(), vfResult[2].data(), vfLayerCC1.data(), vfLayerCC2.data());
+            for (unsigned int j = 0; j < 4; j++)
+                BOOST_CHECK_MESSAGE(vfExpected[j] == vfResult[j], kernels.name << " ApplyLayerTWNBoth");
+
+            sieveKernelsScalar.ApplyLayerTWNOnlyCC1(nMinWord, nMaxWord, vfExpected[1].data(), vfExpected[2].data(), vfExpected[3].data(), vfLayerCC1.data(), vfLayerCC2.data());
+            kernels.ApplyLayerTWNOnlyCC1(nMinWord, nMaxWord, vfResult[1].data(), vfResult[2].data(), vfResult[3].data(), vfLayerCC1.data(), vfLayerCC2.data());
+            for (unsigned int j = 0; j < 4; j++)
+                BOOST_CHECK_MESSAGE(vfExpected[j] == vfResult[j], kernels.name << " ApplyLayerTWNOnlyCC1");
+
+            sieveKernelsScalar.ApplyLayerTWNNone(nMinWord, nMaxWord, vfExpected[2].data(), vfExpected[3].data(), vfLayerCC1.data(), vfLayerCC2.data());
+            kernels.ApplyLayerTWNNone(nMinWord, nMaxWord, vfResult[2].data(), vfResult[3].data(), vfLayerCC1.data(), vfLayerCC2.data());
+            for (unsigned int j = 0; j < 4; j++)
+                BOOST_CHECK_MESSAGE(vfExpected[j] == vfResult[j], kernels.name << " ApplyLayerTWNNone");
+
+            sieveKernelsScalar.CombineBitsets(nMinWord, nMaxWord, vfExpected[0].data(), vfExpected[1].data(), vfExpected[2].data(), vfExpected[3].data());
+            kernels.CombineBitsets(nMinWord, nMaxWord, vfResult[0].data(), vfResult[1].data(), vfResult[2].data(), vfResult[3].data());
+            for (unsigned int j = 0; j < 4; j++)
+                BOOST_CHECK_MESSAGE(vfExpected[j] == vfResult[j], kernels.name << " CombineBitsets");
+
+            BOOST_CHECK_EQUAL(kernels.FindNonZeroWord(nMinWord, nMaxWord, vfLayerCC1.data()), sieveKernelsScalar.FindNonZeroWord(nMinWord, nMaxWord, vfLayerCC1.data()));
+            std::fill(vfLayerCC2.begin() + nMinWord, vfLayerCC2.begin() + nMaxWord, 0);
+            BOOST_CHECK_EQUAL(kernels.FindNonZeroWord(nMinWord, nMaxWord, vfLayerCC2.data()), nMaxWord);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sieve_kernels_weave)
+{
+    GeneratePrimeTable();
+    mpz_class mpzFixedMultiplier;
+    Primorial(nInitialPrimorialMultiplier, mpzFixedMultiplier);
+    uint256 hash = RandomHeaderHash();
+    mpz_class mpzHash;
+    mpz_set_uint256(mpzHash.get_mpz_t(), hash);
+
+    // Collect the candidates of a sieve with a size that is not a multiple of
+    // any vector width
+    const SieveKernels kernelsSaved = sieveKernels;
+    std::vector<std::pair<unsigned int, unsigned int> > vExpected;
+    for (const SieveKernels& kernels : SieveKernelsSupported())
+    {
+        sieveKernels = kernels;
+        CSieveOfEratosthenes sieve;
+        sieve.Reset(200003, 5000, 4, 2048, TargetFromInt(6), mpzHash, mpzFixedMultiplier, nullptr, 1);
+        sieve.Weave();
+        std::vector<std::pair<unsigned int, unsigned int> > vCandidates;
+        unsigned int nMultiplier = 0, nCandidateType = 0;
+        while (sieve.GetNextCandidateMultiplier(nMultiplier, nCandidateType))
+            vCandidates.push_back(std::make_pair(nMultiplier, nCandidateType));
+        BOOST_CHECK(!vCandidates.empty());
+        if (vExpected.empty())
+            vExpected = vCandidates;
+        BOOST_CHECK_MESSAGE(vCandidates == vExpected, kernels.name);
+    }
+    sieveKernels = kernelsSaved;
+}
+
+BOOST_AUTO_TEST_CASE(mine_prime_chain_batch)
+{
+    GeneratePrimeTable();
+    CBlock block;
+    block.nVersion = 2;
+    block.nTime = 1385686192;
+    block.nBits = TargetFromInt(4);
+    mpz_class mpzFixedMultiplier;
+    Primorial(nInitialPrimorialMultiplier, mpzFixedMultiplier);
+
+    // Mine until a chain is found, moving to the next nonce whenever the
+    // sieve is depleted. Every chain found must be a valid proof-of-work.
+    CSieveOfEratosthenes sieve;
+    CPrimalityTestParams testParams;
+    unsigned int vChainsFound[nMaxChainLength] = {};
+    mpz_class mpzHash;
+    bool fNewBlock = true;
+    bool fFound = false;
+    unsigned int nTotalTests = 0;
+    for (int nCalls = 0; nCalls < 2000 && !fFound; nCalls++)
+    {
+        if (fNewBlock)
+        {
+            do
+                block.nNonce++;
+            while (UintToArith256(block.GetHeaderHash()) < hashBlockHeaderLimit);
+            uint256 hash = block.GetHeaderHash();
+            mpz_set_uint256(mpzHash.get_mpz_t(), hash);
+        }
+        unsigned int nTests = 0, nPrimesHit = 0;
+        fFound = MineProbablePrimeChain(block, mpzFixedMultiplier, fNewBlock, nTests, nPrimesHit, mpzHash, nullptr, vChainsFound, sieve, testParams);
+        BOOST_CHECK(nPrimesHit <= nTests);
+        nTotalTests += nTests;
+    }
+    BOOST_REQUIRE(fFound);
+    BOOST_CHECK(nTotalTests > 0);
+
+    unsigned int nChainType = 0, nChainLength = 0;
+    BOOST_CHECK(CheckPrimeProofOfWork(block.GetHeaderHash(), block.nBits, block.bnPrimeChainMultiplier, nChainType, nChainLength));
+    BOOST_CHECK(nChainLength >= block.nBits);
+
+    // The pool share check accepts the chain up to its whole length only
+    const unsigned int nWholeLength = TargetGetLength(nChainLength);
+    unsigned int nShareLength = 0;
+    BOOST_CHECK(CheckPrimeShare(block.GetHeaderHash(), block.bnPrimeChainMultiplier, nChainType, TargetFromInt(2), nShareLength, testParams));
+    BOOST_CHECK_EQUAL(nShareLength, TargetFromInt(2));
+    BOOST_CHECK(CheckPrimeShare(block.GetHeaderHash(), block.bnPrimeChainMultiplier, nChainType, TargetFromInt(nWholeLength), nShareLength, testParams));
+    BOOST_CHECK(!CheckPrimeShare(block.GetHeaderHash(), block.bnPrimeChainMultiplier, nChainType, TargetFromInt(nWholeLength + 1), nShareLength, testParams));
+    BOOST_CHECK(!CheckPrimeShare(block.GetHeaderHash(), block.bnPrimeChainMultiplier, PRIME_CHAIN_BI_TWIN + 1, TargetFromInt(2), nShareLength, testParams));
+}
+
+static void MineHeader(CBlockHeader& header)
+{
+    CBlock block(header);
+    mpz_class mpzFixedMultiplier;
+    Primorial(nInitialPrimorialMultiplier, mpzFixedMultiplier);
+
+    CSieveOfEratosthenes sieve;
+    CPrimalityTestParams testParams;
+    unsigned int vChainsFound[nMaxChainLength] = {};
+    mpz_class mpzHash;
+    bool fNewBlock = true;
+    bool fFound = false;
+    for (int nCalls = 0; nCalls < 2000 && !fFound; nCalls++)
+    {
+        if (fNewBlock)
+        {
+            do
+                block.nNonce++;
+            while (UintToArith256(block.GetHeaderHash()) < hashBlockHeaderLimit);
+            uint256 hash = block.GetHeaderHash();
+            mpz_set_uint256(mpzHash.get_mpz_t(), hash);
+        }
+        unsigned int nTests = 0, nPrimesHit = 0;
+        fFound = MineProbablePrimeChain(block, mpzFixedMultiplier, fNewBlock, nTests, nPrimesHit, mpzHash, nullptr, vChainsFound, sieve, testParams);
+    }
+    BOOST_REQUIRE(fFound);
+    header = block.GetBlockHeader();
+}
+
+// Headers forking off genesis, the header at nInvalid with a broken proof-of-work
+static std::vector<CBlockHeader> CreateHeaders(unsigned int nBranch, size_t nCount, size_t nInvalid)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    std::vector<CBlockHeader> vHeaders(nCount);
+    std::vector<uint256> vHash(nCount);
+    std::vector<CBlockIndex> vIndex;
+    vIndex.reserve(nCount);
+    CBlockIndex* pindexPrev = chainActive.Genesis();
+    for (size_t i = 0; i < nCount; i++)
+    {
+        CBlockHeader& header = vHeaders[i];
+        header.nVersion = 4;
+        header.hashPrevBlock = pindexPrev->GetBlockHash();
+        header.hashMerkleRoot = ArithToUint256(arith_uint256(nBranch));
+        header.nTime = pindexPrev->nTime + consensusParams.nPowTargetSpacing;
+        header.nBits = GetNextWorkRequired(pindexPrev, &header, consensusParams);
+        MineHeader(header);
+        if (i == nInvalid)
+        {
+            header.bnPrimeChainMultiplier += 1;
+            unsigned int nChainType = 0, nChainLength = 0;
+            BOOST_REQUIRE(!CheckProofOfWork(header.GetHeaderHash(), header.nBits, consensusParams, header.bnPrimeChainMultiplier, nChainType, nChainLength, true));
+        }
+
+        vHash[i] = header.GetHash();
+        vIndex.emplace_back(header);
+        vIndex[i].phashBlock = &vHash[i];
+        vIndex[i].pprev = pindexPrev;
+        vIndex[i].nHeight = pindexPrev->nHeight + 1;
+        pindexPrev = &vIndex[i];
+    }
+    return vHeaders;
+}
+
+static bool HaveHeader(const CBlockHeader& header)
+{
+    LOCK(cs_main);
+    return mapBlockIndex.count(header.GetHash()) > 0;
+}
+
+BOOST_FIXTURE_TEST_CASE(process_headers_pow_check, PrimeChainTestingSetup)
+{
+    GeneratePrimeTable();
+    const CChainParams& chainparams = Params();
+    const size_t nCount = 6, nInvalid = 3;
+
+    // A valid batch passes the parallel check
+    std::vector<CBlockHeader> vHeaders = CreateHeaders(1, nCount, nCount);
+    CValidationState state;
+    const CBlockIndex* pindex = nullptr;
+    BOOST_CHECK(ProcessNewBlockHeaders(vHeaders, state, chainparams, &pindex));
+    BOOST_CHECK(state.IsValid());
+    BOOST_REQUIRE(pindex != nullptr);
+    BOOST_CHECK(pindex->GetBlockHash() == vHeaders.back().GetHash());
+    BOOST_CHECK_EQUAL(pindex->nHeight, (int)nCount);
+
+    // One bad proof-of-work fails the parallel check of the batch. Each
+    // header is then checked again, which accepts the headers before the
+    // bad one and reports it.
+    vHeaders = CreateHeaders(2, nCount, nInvalid);
+    state = CValidationState();
+    BOOST_CHECK(!ProcessNewBlockHeaders(vHeaders, state, chainparams, &pindex));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "high-hash");
+    for (size_t i = 0; i < nCount; i++)
+        BOOST_CHECK_EQUAL(HaveHeader(vHeaders[i]), i < nInvalid);
+
+    // Same without the pow check threads
+    const int nScriptCheckThreadsSaved = nScriptCheckThreads;
+    nScriptCheckThreads = 0;
+    vHeaders = CreateHeaders(3, nCount, nInvalid);
+    state = CValidationState();
+    BOOST_CHECK(!ProcessNewBlockHeaders(vHeaders, state, chainparams, &pindex));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "high-hash");
+    for (size_t i = 0; i < nCount; i++)
+        BOOST_CHECK_EQUAL(HaveHeader(vHeaders[i]), i < nInvalid);
+    nScriptCheckThreads = nScriptCheckThreadsSaved;
+}
+
+BOOST_AUTO_TEST_CASE(compact_multiplier)
+{
+    const CBigNum bnPrimorial = CBigNum(2 * 3 * 5 * 7 * 11 * 13 * 17 * 19 * 23);
+    std::vector<CBigNum> vMultipliers = {CBigNum(0), CBigNum(1), CBigNum(-1), CBigNum(0x80), bnPrimorial, bnPrimorial * bnPrimorial * bnPrimorial, bnOne << 159, bnOne << 160, bnOne << 1024, -(bnOne << 2100)};
+    for (int i = 0; i < 100; i++)
+        vMultipliers.push_back(CBigNum(InsecureRandRange(100000) + 1) * bnPrimorial);
+
+    for (const CBigNum& bn : vMultipliers)
+    {
+        CCompactMultiplier multiplier;
+        multiplier = bn;
+        BOOST_CHECK(multiplier.GetBigNum() == bn);
+        BOOST_CHECK_EQUAL(multiplier.IsNull(), bn == 0);
+        BOOST_CHECK_EQUAL(multiplier.IsSpilled(), bn.getvch().size() > CCompactMultiplier::INLINE_SIZE);
+
+        // Same serialization as the CBigNum it replaces in CDiskBlockIndex
+        CDataStream ssBigNum(SER_DISK, PROTOCOL_VERSION);
+        CDataStream ssCompact(SER_DISK, PROTOCOL_VERSION);
+        ssBigNum << bn;
+        ssCompact << multiplier;
+        BOOST_CHECK(ssBigNum.str() == ssCompact.str());
+
+        CCompactMultiplier multiplierRead;
+        ssBigNum >> multiplierRead;
+        BOOST_CHECK(multiplierRead.GetBigNum() == bn);
+    }
+
+    // Shrinking back from a spilled multiplier stores it inline again
+    CCompactMultiplier multiplier;
+    multiplier = bnOne << 1024;
+    multiplier = bnPrimorial;
+    BOOST_CHECK(!multiplier.IsSpilled());
+    BOOST_CHECK_EQUAL(multiplier.DynamicMemoryUsage(), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -32,6 +32,8 @@ static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
 
+static const char DB_DATAINDEX = 'd';
+
 namespace {
 
 struct CoinEntry {
@@ -267,6 +269,12 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
 
     pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
 
+    // Memory taken by the prime chain multipliers, against what CBigNum would take
+    size_t nEntries = 0;
+    size_t nMultiplierSpilled = 0;
+    size_t nMultiplierUsage = 0;
+    size_t nMultiplierBigNumUsage = 0;
+
     // Load mapBlockIndex
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
@@ -294,6 +302,12 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                 pindexNew->nTx            = diskindex.nTx;
                 pindexNew->nDataSize      = diskindex.nDataSize;
 
+                nEntries++;
+                nMultiplierUsage += sizeof(CCompactMultiplier) + pindexNew->bnPrimeChainMultiplier.DynamicMemoryUsage();
+                nMultiplierBigNumUsage += pindexNew->bnPrimeChainMultiplier.BigNumMemoryUsage();
+                if (pindexNew->bnPrimeChainMultiplier.IsSpilled())
+                    nMultiplierSpilled++;
+
                 //DATACOIN OPTIMIZE? Понятно почему XPM отключили это. У них не было bnPrimeChainMultiplier.
                 //Но у нас есть. Включить? Замедлит загрузку. Замерить на сколько.
                 // Primecoin: disabled proof-of-work check for loading block index
@@ -309,6 +323,10 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
         }
     }
 
+    if (nEntries > 0 && nMultiplierBigNumUsage > nMultiplierUsage)
+        LogPrintf("%s: %u block index entries, prime chain multipliers use %u bytes (%u spilled to the heap), %u bytes per entry less than CBigNum\n", __func__,
+            nEntries, nMultiplierUsage, nMultiplierSpilled, (nMultiplierBigNumUsage - nMultiplierUsage) / nEntries);
+
     return true;
 }
 
@@ -333,6 +351,20 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
 //    return Write(std::string("strCheckpointPubKey"), strPubKey);
 //}
 
+CDataIndexDB::CDataIndexDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "data", nCacheSize, fMemory, fWipe) {
+}
+
+bool CDataIndexDB::ReadDataIndex(const uint256 &txid, CDiskDataPos &pos) {
+    return Read(std::make_pair(DB_DATAINDEX, txid), pos);
+}
+
+bool CDataIndexDB::WriteDataIndex(const std::vector<std::pair<uint256, CDiskDataPos> > &vect) {
+    CDBBatch batch(*this);
+    for (const auto& entry : vect)
+        batch.Write(std::make_pair(DB_DATAINDEX, entry.first), entry.second);
+    return WriteBatch(batch);
+}
+
 
 namespace {
 
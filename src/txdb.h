@@ -39,6 +39,8 @@ static const int64_t nMaxBlockDBCache = 2;
 static const int64_t nMaxBlockDBAndTxIndexCache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
+//! Max memory allocated to data payload index specific cache, if -dataindex (MiB)
+static const int64_t nMaxDataIndexCache = 64;
 
 struct CDiskTxPos : public CDiskBlockPos
 {
@@ -65,6 +67,37 @@ struct CDiskTxPos : public CDiskBlockPos
     }
 };
 
+/** Location of the data payload of a transaction: unlike CDiskTxPos, nPos is
+ *  the file offset of the payload bytes themselves, so they can be read
+ *  without deserializing the block header or the transaction. */
+struct CDiskDataPos : public CDiskBlockPos
+{
+    unsigned int nSize; // payload length in bytes
+    uint256 hash;       // SHA256 of the payload
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(*(CDiskBlockPos*)this);
+        READWRITE(VARINT(nSize));
+        READWRITE(hash);
+    }
+
+    CDiskDataPos(const CDiskBlockPos &posIn, unsigned int nSizeIn, const uint256 &hashIn) : CDiskBlockPos(posIn.nFile, posIn.nPos), nSize(nSizeIn), hash(hashIn) {
+    }
+
+    CDiskDataPos() {
+        SetNull();
+    }
+
+    void SetNull() {
+        CDiskBlockPos::SetNull();
+        nSize = 0;
+        hash.SetNull();
+    }
+};
+
 /** CCoinsView backed by the coin database (chainstate/) */
 class CCoinsViewDB final : public CCoinsView
 {
@@ -135,4 +168,17 @@ public:
     //bool WriteCheckpointPubKey(const std::string& strPubKey);
 };
 
+/** Access to the data payload index (blocks/data/) */
+class CDataIndexDB : public CDBWrapper
+{
+public:
+    explicit CDataIndexDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    CDataIndexDB(const CDataIndexDB&) = delete;
+    CDataIndexDB& operator=(const CDataIndexDB&) = delete;
+
+    bool ReadDataIndex(const uint256 &txid, CDiskDataPos &pos);
+    bool WriteDataIndex(const std::vector<std::pair<uint256, CDiskDataPos> > &vect);
+};
+
 #endif // BITCOIN_TXDB_H
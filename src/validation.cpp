@@ -74,6 +74,7 @@ int nScriptCheckThreads = 0;
 std::atomic_bool fImporting(false);
 std::atomic_bool fReindex(false);
 bool fTxIndex = false;
+bool fDataIndex = false;
 bool fHavePruned = false;
 bool fPruneMode = false;
 bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
@@ -187,6 +188,7 @@ CBlockIndex* FindForkInGlobalIndex(const CChain& chain, const CBlockLocator& loc
 CCoinsViewDB *pcoinsdbview = nullptr;
 CCoinsViewCache *pcoinsTip = nullptr;
 CBlockTreeDB *pblocktree = nullptr;
+CDataIndexDB *pdataindex = nullptr;
 
 enum FlushStateMode {
     FLUSH_STATE_NONE,
@@ -909,13 +911,28 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransa
     return AcceptToMemoryPoolWithTime(chainparams, pool, state, tx, pfMissingInputs, GetTime(), plTxnReplaced, bypass_limits, nAbsurdFee);
 }
 
+bool ReadTransactionFromDisk(const CDiskTxPos& postx, CTransactionRef& txOut, uint256& hashBlock)
+{
+    CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
+    if (file.IsNull())
+        return error("%s: OpenBlockFile failed for %s", __func__, postx.ToString());
+    CBlockHeader header;
+    try {
+        file >> header;
+        fseek(file.Get(), postx.nTxOffset, SEEK_CUR);
+        file >> txOut;
+    } catch (const std::exception& e) {
+        return error("%s: Deserialize or I/O error - %s", __func__, e.what());
+    }
+    hashBlock = header.GetHash();
+    return true;
+}
+
 /** Return transaction in txOut, and if it was found inside a block, its hash is placed in hashBlock */
 bool GetTransaction(const uint256 &hash, CTransactionRef &txOut, const Consensus::Params& consensusParams, uint256 &hashBlock, bool fAllowSlow)
 {
-    CBlockIndex *pindexSlow = nullptr;
-
-    LOCK(cs_main);
-
+    // cs_main is only taken to locate the block of the slow path: the mempool and
+    // the tx index have their own locks, and stored blocks are never rewritten.
     CTransactionRef ptx = mempool.get(hash);
     if (ptx)
     {
@@ -926,36 +943,35 @@ bool GetTransaction(const uint256 &hash, CTransactionRef &txOut, const Consensus
     if (fTxIndex) {
         CDiskTxPos postx;
         if (pblocktree->ReadTxIndex(hash, postx)) {
-            CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
-            if (file.IsNull())
-                return error("%s: OpenBlockFile failed", __func__);
-            CBlockHeader header;
-            try {
-                file >> header;
-                fseek(file.Get(), postx.nTxOffset, SEEK_CUR);
-                file >> txOut;
-            } catch (const std::exception& e) {
-                return error("%s: Deserialize or I/O error - %s", __func__, e.what());
-            }
-            hashBlock = header.GetHash();
+            if (!ReadTransactionFromDisk(postx, txOut, hashBlock))
+                return false;
             if (txOut->GetHash() != hash)
                 return error("%s: txid mismatch", __func__);
             return true;
         }
     }
 
+    CDiskBlockPos posSlow;
+    uint256 hashSlow;
     if (fAllowSlow) { // use coin database to locate block that contains transaction, and scan it
+        LOCK(cs_main);
         const Coin& coin = AccessByTxid(*pcoinsTip, hash);
-        if (!coin.IsSpent()) pindexSlow = chainActive[coin.nHeight];
+        if (!coin.IsSpent()) {
+            CBlockIndex* pindexSlow = chainActive[coin.nHeight];
+            if (pindexSlow && (pindexSlow->nStatus & BLOCK_HAVE_DATA)) {
+                posSlow = pindexSlow->GetBlockPos();
+                hashSlow = pindexSlow->GetBlockHash();
+            }
+        }
     }
 
-    if (pindexSlow) {
+    if (!posSlow.IsNull()) {
         CBlock block;
-        if (ReadBlockFromDisk(block, pindexSlow, consensusParams)) {
+        if (ReadBlockFromDisk(block, posSlow, consensusParams) && block.GetHash() == hashSlow) {
             for (const auto& tx : block.vtx) {
                 if (tx->GetHash() == hash) {
                     txOut = tx;
-                    hashBlock = pindexSlow->GetBlockHash();
+                    hashBlock = hashSlow;
                     return true;
                 }
             }
@@ -965,6 +981,44 @@ bool GetTransaction(const uint256 &hash, CTransactionRef &txOut, const Consensus
     return false;
 }
 
+bool ReadDataFromDisk(const CDiskDataPos& pos, std::vector<unsigned char>& data, uint64_t nOffset, uint64_t nLength)
+{
+    data.clear();
+    if (nOffset >= pos.nSize)
+        return nOffset == 0;
+    nLength = std::min(nLength, pos.nSize - nOffset);
+
+    // A single bounded read: the index points at the payload bytes themselves
+    CAutoFile file(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
+    if (file.IsNull())
+        return error("%s: OpenBlockFile failed for %s", __func__, pos.ToString());
+    if (nOffset && fseek(file.Get(), nOffset, SEEK_CUR))
+        return error("%s: seek failed for %s", __func__, pos.ToString());
+    data.resize(nLength);
+    if (fread(data.data(), 1, nLength, file.Get()) != nLength) {
+        data.clear();
+        return error("%s: read failed for %s", __func__, pos.ToString());
+    }
+    return true;
+}
+
+bool GetTransactionData(const uint256 &hash, std::vector<unsigned char>& data, const Consensus::Params& consensusParams)
+{
+    if (fDataIndex) {
+        CDiskDataPos pos;
+        if (pdataindex->ReadDataIndex(hash, pos))
+            return ReadDataFromDisk(pos, data);
+    }
+
+    // Mempool transactions, and those without a payload, are not in the data index
+    CTransactionRef tx;
+    uint256 hashBlock;
+    if (!GetTransaction(hash, tx, consensusParams, hashBlock, true))
+        return false;
+    data = tx->data;
+    return true;
+}
+
 
 
 
@@ -1538,6 +1592,40 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+/**
+ * Closure representing the prime proof-of-work check of one block header.
+ * The header must outlive the check.
+ */
+class CPowCheck
+{
+private:
+    const CBlockHeader* pheader;
+    const Consensus::Params* pconsensusParams;
+
+public:
+    CPowCheck(): pheader(nullptr), pconsensusParams(nullptr) {}
+    CPowCheck(const CBlockHeader& headerIn, const Consensus::Params& consensusParamsIn) :
+        pheader(&headerIn), pconsensusParams(&consensusParamsIn) {}
+
+    bool operator()() {
+        unsigned int nChainType = 0;
+        unsigned int nChainLength = 0;
+        return CheckProofOfWork(pheader->GetHeaderHash(), pheader->nBits, *pconsensusParams, pheader->bnPrimeChainMultiplier, nChainType, nChainLength, true);
+    }
+
+    void swap(CPowCheck& check) {
+        std::swap(pheader, check.pheader);
+        std::swap(pconsensusParams, check.pconsensusParams);
+    }
+};
+
+static CCheckQueue<CPowCheck> powcheckqueue(16);
+
+void ThreadPowCheck() {
+    RenameThread("datacoin-powch");
+    powcheckqueue.Thread();
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -1750,6 +1838,9 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     CDiskTxPos pos(pindex->GetBlockPos(), GetSizeOfCompactSize(block.vtx.size()));
     std::vector<std::pair<uint256, CDiskTxPos> > vPos;
     vPos.reserve(block.vtx.size());
+    // The payload is serialized last, so it ends where its transaction does
+    const unsigned int nHeaderSize = ::GetSerializeSize(block.GetBlockHeader(), SER_DISK, CLIENT_VERSION);
+    std::vector<std::pair<uint256, CDiskDataPos> > vDataPos;
     blockundo.vtxundo.reserve(block.vtx.size() - 1);
     std::vector<PrecomputedTransactionData> txdata;
     txdata.reserve(block.vtx.size()); // Required so that pointers to individual PrecomputedTransactionData don't get invalidated
@@ -1819,6 +1910,12 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
 
         vPos.push_back(std::make_pair(tx.GetHash(), pos));
         pos.nTxOffset += ::GetSerializeSize(tx, SER_DISK, CLIENT_VERSION);
+        if (fDataIndex && !fJustCheck && !tx.data.empty()) {
+            uint256 hashData;
+            CSHA256().Write(tx.data.data(), tx.data.size()).Finalize(hashData.begin());
+            CDiskBlockPos posData(pos.nFile, pos.nPos + nHeaderSize + pos.nTxOffset - tx.data.size());
+            vDataPos.push_back(std::make_pair(tx.GetHash(), CDiskDataPos(posData, tx.data.size(), hashData)));
+        }
     }
 
     if (!fJustCheck)
@@ -1883,6 +1980,10 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
         if (!pblocktree->WriteTxIndex(vPos))
             return AbortNode(state, "Failed to write transaction index");
 
+    if (fDataIndex && !vDataPos.empty())
+        if (!pdataindex->WriteDataIndex(vDataPos))
+            return AbortNode(state, "Failed to write data index");
+
     assert(pindex->phashBlock);
     // add this block to the view's block chain
     view.SetBestBlock(pindex->GetBlockHash());
@@ -3162,7 +3263,7 @@ static bool ContextualCheckBlock(const CBlock& block, CValidationState& state, c
     return true;
 }
 
-static bool AcceptBlockHeader(const CBlockHeader& block, const uint256* phash, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool isFullBlock = false) //DATACOIN OLDCLIENT костыль. block обязан быть ссылкой на полный блок если isFullBlock == true
+static bool AcceptBlockHeader(const CBlockHeader& block, const uint256* phash, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool isFullBlock = false, bool fPowChecked = false) //DATACOIN OLDCLIENT костыль. block обязан быть ссылкой на полный блок если isFullBlock == true
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
@@ -3194,7 +3295,7 @@ static bool AcceptBlockHeader(const CBlockHeader& block, const uint256* phash, C
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), phash ? false : true))
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), (phash || fPowChecked) ? false : true))
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -3219,9 +3320,64 @@ static bool AcceptBlockHeader(const CBlockHeader& block, const uint256* phash, C
     return true;
 }
 
+/**
+ * Primecoin: check the prime proof-of-work of a batch of headers without
+ * holding cs_main, spreading the checks over the pow check threads.
+ * Headers already in mapBlockIndex and headers of old clients (without a
+ * multiplier) are skipped. vfPowChecked is only set if every check passed;
+ * otherwise AcceptBlockHeader checks each header again to report the
+ * failing one.
+ */
+static void CheckHeadersProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams, std::vector<bool>& vfPowChecked)
+{
+    vfPowChecked.assign(headers.size(), false);
+
+    std::vector<uint256> vHash(headers.size());
+    for (size_t i = 0; i < headers.size(); i++) {
+        if (!headers[i].bnPrimeChainMultiplier)
+            continue;
+        vHash[i] = headers[i].GetHash();
+    }
+
+    std::vector<CPowCheck> vChecks;
+    {
+        LOCK(cs_main);
+        for (size_t i = 0; i < headers.size(); i++) {
+            if (!headers[i].bnPrimeChainMultiplier || mapBlockIndex.count(vHash[i]))
+                continue;
+            vChecks.push_back(CPowCheck(headers[i], consensusParams));
+            vfPowChecked[i] = true;
+        }
+    }
+    if (vChecks.empty())
+        return;
+
+    bool fAllOk = true;
+    if (nScriptCheckThreads && vChecks.size() > 1) {
+        CCheckQueueControl<CPowCheck> control(&powcheckqueue);
+        control.Add(vChecks);
+        fAllOk = control.Wait();
+    } else {
+        for (CPowCheck& check : vChecks) {
+            if (!check()) {
+                fAllOk = false;
+                break;
+            }
+        }
+    }
+
+    if (!fAllOk)
+        vfPowChecked.assign(headers.size(), false);
+}
+
 // Exposed wrapper for AcceptBlockHeader
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex)
 {
+    // Verify the proof-of-work first so that cs_main only covers the
+    // contextual checks
+    std::vector<bool> vfPowChecked;
+    CheckHeadersProofOfWork(headers, chainparams.GetConsensus(), vfPowChecked);
+
     {
         LOCK(cs_main);
         //for (const CBlockHeader& header : headers) {
@@ -3244,7 +3400,7 @@ bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidatio
 				else break;
 			}
 			
-            if (!AcceptBlockHeader(header, phash, state, chainparams, &pindex)) {
+            if (!AcceptBlockHeader(header, phash, state, chainparams, &pindex, false, vfPowChecked[i])) {
                 return false;
             }
             if (ppindex) {
@@ -3754,6 +3910,10 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
     pblocktree->ReadFlag("txindex", fTxIndex);
     LogPrintf("%s: transaction index %s\n", __func__, fTxIndex ? "enabled" : "disabled");
 
+    // Check whether we have a data payload index
+    pblocktree->ReadFlag("dataindex", fDataIndex);
+    LogPrintf("%s: data index %s\n", __func__, fDataIndex ? "enabled" : "disabled");
+
     return true;
 }
 
@@ -4121,6 +4281,8 @@ bool LoadBlockIndex(const CChainParams& chainparams)
         // Use the provided setting for -txindex in the new database
         fTxIndex = gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX);
         pblocktree->WriteFlag("txindex", fTxIndex);
+        fDataIndex = gArgs.GetBoolArg("-dataindex", DEFAULT_DATAINDEX);
+        pblocktree->WriteFlag("dataindex", fDataIndex);
     }
 
 	// ppcoin: if checkpoint master key changed must reset sync-checkpoint
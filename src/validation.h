@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <limits>
 #include <map>
 #include <set>
 #include <stdint.h>
@@ -33,6 +34,7 @@
 
 class CBlockIndex;
 class CBlockTreeDB;
+class CDataIndexDB;
 class CChainParams;
 class CCoinsViewDB;
 class CInv;
@@ -42,6 +44,8 @@ class CBlockPolicyEstimator;
 class CTxMemPool;
 class CValidationState;
 struct ChainTxData;
+struct CDiskTxPos;
+struct CDiskDataPos;
 
 struct PrecomputedTransactionData;
 struct LockPoints;
@@ -131,6 +135,7 @@ static const int64_t MAX_FEE_ESTIMATION_TIP_AGE = 3 * 60 * 60;
 static const bool DEFAULT_PERMIT_BAREMULTISIG = true;
 static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
 static const bool DEFAULT_TXINDEX = true; //DATACOIN CHANGED
+static const bool DEFAULT_DATAINDEX = false;
 static const unsigned int DEFAULT_BANSCORE_THRESHOLD = 100;
 /** Default for -persistmempool */
 static const bool DEFAULT_PERSIST_MEMPOOL = true;
@@ -170,6 +175,7 @@ extern std::atomic_bool fImporting;
 extern std::atomic_bool fReindex;
 extern int nScriptCheckThreads;
 extern bool fTxIndex;
+extern bool fDataIndex;
 extern bool fIsBareMultisigStd;
 extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
@@ -270,10 +276,18 @@ bool LoadChainTip(const CChainParams& chainparams);
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run an instance of the header proof-of-work checking thread */
+void ThreadPowCheck();
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
+/** Read the transaction at postx and the hash of its block, without cs_main */
+bool ReadTransactionFromDisk(const CDiskTxPos& postx, CTransactionRef& txOut, uint256& hashBlock);
 /** Retrieve a transaction (from memory pool, or from disk, if possible) */
 bool GetTransaction(const uint256 &hash, CTransactionRef &tx, const Consensus::Params& params, uint256 &hashBlock, bool fAllowSlow = false);
+/** Read nLength bytes of the payload at pos, starting nOffset bytes into it (clamped to the payload), without cs_main */
+bool ReadDataFromDisk(const CDiskDataPos& pos, std::vector<unsigned char>& data, uint64_t nOffset = 0, uint64_t nLength = std::numeric_limits<uint64_t>::max());
+/** Retrieve the data payload of a transaction, through the data index if possible */
+bool GetTransactionData(const uint256 &hash, std::vector<unsigned char>& data, const Consensus::Params& params);
 /** Find the best known block, and make it the tip of the block chain */
 bool ActivateBestChain(CValidationState& state, const CChainParams& chainparams, std::shared_ptr<const CBlock> pblock = std::shared_ptr<const CBlock>());
 CAmount GetBlockSubsidy(int nBits, const Consensus::Params& consensusParams);
@@ -452,6 +466,9 @@ extern CCoinsViewCache *pcoinsTip;
 /** Global variable that points to the active block tree (protected by cs_main) */
 extern CBlockTreeDB *pblocktree;
 
+/** Global variable that points to the data payload index, if -dataindex */
+extern CDataIndexDB *pdataindex;
+
 /**
  * Return the spend height, which is one more than the inputs.GetBestBlock().
  * While checking, GetBestBlock() refers to the parent block. (protected by cs_main)
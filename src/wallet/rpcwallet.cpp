@@ -8,6 +8,9 @@
 #include "chain.h"
 #include "consensus/validation.h"
 #include "core_io.h"
+#include "crypto/sha256.h"
+#include "filemanifest.h"
+#include "fs.h"
 #include "httpserver.h"
 #include "validation.h"
 #include "net.h"
@@ -557,16 +560,96 @@ UniValue getdata(const JSONRPCRequest& request)
     std::string strHash = request.params[0].get_str();
     uint256 hash = uint256S(strHash);
 
-    CTransactionRef tx;
-    uint256 hashBlock = 0;
-    if (!GetTransaction(hash, tx, Params().GetConsensus(), hashBlock, true))
+    std::vector<unsigned char> data;
+    if (!GetTransactionData(hash, data, Params().GetConsensus()))
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available about transaction");
 
-    std::string data = tx->GetBase64Data();
-
-    return data;
+    return EncodeBase64(data.data(), data.size());
 }
 
+UniValue storefile(const JSONRPCRequest& request)
+{
+    CWallet * const pwallet = GetWalletForJSONRPCRequest(request);
+    if (!EnsureWalletIsAvailable(pwallet, request.fHelp)) {
+        return NullUniValue;
+    }
+
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 2)
+        throw std::runtime_error(
+            "storefile \"filename\" ( chunksize )\n"
+            "\nStores a server-side file in data transactions, followed by a transaction with its manifest.\n"
+            "Each transaction is funded by confirmed coins of its own.\n"
+            + HelpRequiringPassphrase(pwallet) + "\n"
+            "\nArguments:\n"
+            "1. \"filename\"    (string, required) The filename with path (either absolute or relative to datacoind)\n"
+            "2. chunksize     (numeric, optional, default=" + std::to_string(MAX_TX_DATA_SIZE) + ") The payload size of each data transaction\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"manifest\" : \"txid\",   (string) The id of the manifest transaction, to pass to retrievefile\n"
+            "  \"size\" : n,             (numeric) The size of the file\n"
+            "  \"sha256\" : \"hash\",     (string) The SHA256 of the file\n"
+            "  \"chunks\" : [ \"txid\", ... ]  (array) The data transactions, in order\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("storefile", "\"picture.png\"")
+            + HelpExampleRpc("storefile", "\"picture.png\"")
+        );
+
+    ObserveSafeMode();
+
+    unsigned int nChunkSize = MAX_TX_DATA_SIZE;
+    if (!request.params[1].isNull()) {
+        int nChunkSizeParam = request.params[1].get_int();
+        if (nChunkSizeParam < 1 || nChunkSizeParam > (int)MAX_TX_DATA_SIZE)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("chunksize must be between 1 and %u", MAX_TX_DATA_SIZE));
+        nChunkSize = nChunkSizeParam;
+    }
+
+    fs::path filepath = fs::absolute(request.params[0].get_str());
+    FILE* file = fsbridge::fopen(filepath, "rb");
+    if (!file)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Cannot open " + filepath.string());
+    std::vector<unsigned char> vchFile;
+    unsigned char buf[65536];
+    size_t nRead;
+    while ((nRead = fread(buf, 1, sizeof(buf), file)) > 0) {
+        vchFile.insert(vchFile.end(), buf, buf + nRead);
+        if (vchFile.size() > (uint64_t)MAX_FILE_CHUNKS * nChunkSize) {
+            fclose(file);
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("File is larger than %u chunks of %u bytes", MAX_FILE_CHUNKS, nChunkSize));
+        }
+    }
+    bool fError = ferror(file);
+    fclose(file);
+    if (fError)
+        throw JSONRPCError(RPC_MISC_ERROR, "Cannot read " + filepath.string());
+
+    LOCK2(cs_main, pwallet->cs_wallet);
+
+    EnsureWalletIsUnlocked(pwallet);
+
+    std::vector<CWalletTx> vwtxChunks;
+    CWalletTx wtxManifest;
+    std::string strError = pwallet->SendFile(vchFile, filepath.filename().string(), nChunkSize, vwtxChunks, wtxManifest);
+    if (strError != "") {
+        // Chunks broadcast before the failure stay in the wallet
+        for (size_t i = 0; i < vwtxChunks.size(); i++)
+            strError += (i == 0 ? ". Chunks already broadcast: " : ", ") + vwtxChunks[i].GetHash().GetHex();
+        throw JSONRPCError(RPC_WALLET_ERROR, strError);
+    }
+
+    uint256 hash;
+    CSHA256().Write(vchFile.data(), vchFile.size()).Finalize(hash.begin());
+    UniValue chunks(UniValue::VARR);
+    for (const CWalletTx& wtx : vwtxChunks)
+        chunks.push_back(wtx.GetHash().GetHex());
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair("manifest", wtxManifest.GetHash().GetHex()));
+    result.push_back(Pair("size", (uint64_t)vchFile.size()));
+    result.push_back(Pair("sha256", HexStr(hash.begin(), hash.end())));
+    result.push_back(Pair("chunks", chunks));
+    return result;
+}
 
 UniValue listaddressgroupings(const JSONRPCRequest& request)
 {
@@ -3455,6 +3538,7 @@ static const CRPCCommand commands[] =
 
     { "wallet",             "senddata",                 &senddata,                 {"data"} },
     { "wallet",             "getdata",                  &getdata,                  {"hash"} },
+    { "wallet",             "storefile",                &storefile,                {"filename","chunksize"} },
  
     { "wallet",             "setaccount",               &setaccount,               {"address","account"} },
     { "wallet",             "settxfee",                 &settxfee,                 {"amount"} },
@@ -11,6 +11,8 @@
 #include "wallet/coincontrol.h"
 #include "consensus/consensus.h"
 #include "consensus/validation.h"
+#include "crypto/sha256.h"
+#include "filemanifest.h"
 #include "fs.h"
 #include "init.h"
 #include "key.h"
@@ -3080,6 +3082,104 @@ std::string CWallet::SendData(CWalletTx& wtxNew, bool fAskFee, const std::string
     return "";
 }
 
+std::string CWallet::SendFile(const std::vector<unsigned char>& vchFile, const std::string& strName, unsigned int nChunkSize, std::vector<CWalletTx>& vwtxChunks, CWalletTx& wtxManifest)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+
+    if (IsLocked())
+        return _("Error: Wallet locked, unable to create transaction!");
+
+    std::vector<std::vector<unsigned char> > vPayloads;
+    for (size_t nPos = 0; nPos < vchFile.size(); nPos += nChunkSize)
+        vPayloads.emplace_back(vchFile.begin() + nPos, vchFile.begin() + std::min(vchFile.size(), nPos + nChunkSize));
+    if (vPayloads.size() > MAX_FILE_CHUNKS)
+        return strprintf(_("File needs more than %u transactions"), MAX_FILE_CHUNKS);
+
+    CFileManifest manifest;
+    manifest.strName = strName;
+    manifest.nSize = vchFile.size();
+    CSHA256().Write(vchFile.data(), vchFile.size()).Finalize(manifest.hash.begin());
+
+    // All transactions pay their change to one key
+    CReserveKey reservekey(this);
+    CPubKey vchPubKey;
+    if (!reservekey.GetReservedKey(vchPubKey, true))
+        return _("Keypool ran out, please call keypoolrefill first");
+    CCoinControl coin_control;
+    coin_control.destChange = vchPubKey.GetID();
+
+    // Chunks are up to 128 KiB, more than -limitancestorsize allows a
+    // transaction with unconfirmed parents, so every transaction is funded
+    // only by confirmed coins, none of them shared with another transaction.
+    std::vector<COutput> vCoins;
+    AvailableCoins(vCoins, true, nullptr, 1, MAX_MONEY, MAX_MONEY, 0, 1);
+    vCoins.erase(std::remove_if(vCoins.begin(), vCoins.end(), [](const COutput& out) { return !out.fSpendable; }), vCoins.end());
+    std::sort(vCoins.begin(), vCoins.end(), [](const COutput& a, const COutput& b) {
+        return a.tx->tx->vout[a.i].nValue > b.tx->tx->vout[b.i].nValue;
+    });
+    size_t nNextCoin = 0;
+
+    // One fee estimate for all the transactions, charged per started kB
+    const CAmount nFeePerK = GetMinimumFee(1000, coin_control, ::mempool, ::feeEstimator, nullptr);
+
+    auto create = [&](const std::vector<unsigned char>& vchPayload, CWalletTx& wtx, std::string& strError) {
+        coin_control.fAllowOtherInputs = false;
+        coin_control.UnSelectAll();
+        CAmount nValue = 0, nFeeEstimate = 0;
+        unsigned int nInputs = 0;
+        do {
+            if (nNextCoin == vCoins.size()) {
+                strError = strprintf(_("Not enough confirmed coins to fund %u transactions"), vPayloads.size() + 1);
+                return false;
+            }
+            const COutput& out = vCoins[nNextCoin++];
+            coin_control.Select(COutPoint(out.tx->GetHash(), out.i));
+            nValue += out.tx->tx->vout[out.i].nValue;
+            nInputs++;
+            unsigned int nBytes = 10 + nInputs * 148 + 34 + GetSizeOfCompactSize(vchPayload.size()) + vchPayload.size();
+            nFeeEstimate = nFeePerK * (1 + nBytes / 1000);
+        } while (nValue < nFeeEstimate + MIN_CHANGE);
+        CAmount nFeeRet;
+        int nChangePosRet = -1;
+        return CreateTransaction(std::vector<CRecipient>(), wtx, reservekey, nFeeRet, nChangePosRet, strError, coin_control, EncodeBase64(vchPayload.data(), vchPayload.size()));
+    };
+
+    std::string strError;
+    vwtxChunks.assign(vPayloads.size(), CWalletTx());
+    for (size_t i = 0; i < vPayloads.size(); i++) {
+        if (!create(vPayloads[i], vwtxChunks[i], strError)) {
+            vwtxChunks.clear();
+            return strError;
+        }
+        manifest.vChunks.push_back(vwtxChunks[i].GetHash());
+    }
+
+    CDataStream ssManifest(SER_NETWORK, PROTOCOL_VERSION);
+    ssManifest << manifest;
+    if (!create(std::vector<unsigned char>(ssManifest.begin(), ssManifest.end()), wtxManifest, strError)) {
+        vwtxChunks.clear();
+        return strError;
+    }
+
+    // Broadcast the file in order, the manifest last. CommitTransaction keeps
+    // a transaction the mempool rejects, so a rejected chunk stops the file
+    // before a manifest pointing to it goes out; vwtxChunks is left with the
+    // chunks already broadcast.
+    const size_t nTransactions = vwtxChunks.size() + 1;
+    for (size_t i = 0; i < nTransactions; i++) {
+        CWalletTx& wtx = i < vwtxChunks.size() ? vwtxChunks[i] : wtxManifest;
+        CValidationState state;
+        if (!CommitTransaction(wtx, reservekey, g_connman.get(), state) || !state.IsValid()) {
+            vwtxChunks.resize(std::min(i, vwtxChunks.size()));
+            return strprintf(_("Error: Transaction %u of %u was rejected (%s)"), i + 1, nTransactions, state.GetRejectReason());
+        }
+    }
+    LogPrintf("SendFile(): stored %s (%u bytes) in %u transactions, manifest %s\n", strName, vchFile.size(), vwtxChunks.size(), wtxManifest.GetHash().ToString());
+
+    return "";
+}
+
 
 DBErrors CWallet::LoadWallet(bool& fFirstRunRet)
 {
@@ -950,6 +950,13 @@ public:
                            std::string& strFailReason, const CCoinControl& coin_control, const std::string &txData, bool sign = true);
     bool CommitTransaction(CWalletTx& wtxNew, CReserveKey& reservekey, CConnman* connman, CValidationState& state);
     std::string SendData(CWalletTx& wtxNew, bool fAskFee, const std::string& txData);
+    /**
+     * Store a file in data transactions of at most nChunkSize bytes, followed
+     * by a transaction with its manifest. All of them are created and signed
+     * before the first is broadcast. On error vwtxChunks holds the chunks
+     * that were broadcast all the same.
+     */
+    std::string SendFile(const std::vector<unsigned char>& vchFile, const std::string& strName, unsigned int nChunkSize, std::vector<CWalletTx>& vwtxChunks, CWalletTx& wtxManifest);
 
 
     void ListAccountCreditDebit(const std::string& strAccount, std::list<CAccountingEntry>& entries);
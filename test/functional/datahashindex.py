@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+# Copyright (c) 2017 The Datacoin developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the data hash index.
+
+Check that getdatabyhash finds the transactions of the active chain carrying a
+payload, that the index follows blocks being disconnected and reorganisations
+to another branch, and that it resumes from the last indexed block after a
+restart.
+"""
+import base64
+import hashlib
+import os
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+    connect_nodes_bi,
+    disconnect_nodes,
+    sync_blocks,
+    wait_until,
+)
+
+class DataHashIndexTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 2
+        self.extra_args = [["-datahashindex"], []]
+
+    def run_test(self):
+        assert_raises_rpc_error(-1, "Data hash index is not enabled", self.nodes[1].getdatabyhash, "00" * 32)
+
+        self.nodes[0].generate(101)
+        self.sync_all()
+        self.wait_synced()
+
+        assert_raises_rpc_error(-8, "sha256 must be a 64 character hex string", self.nodes[0].getdatabyhash, "00" * 31)
+        assert_raises_rpc_error(-8, "count must be between", self.nodes[0].getdatabyhash, "00" * 32, 0)
+
+        # Node 1 never sees the payloads, so that it can later mine a longer
+        # branch without them
+        disconnect_nodes(self.nodes[0], 1)
+        disconnect_nodes(self.nodes[1], 0)
+
+        # The same payload stored twice and one stored once
+        self.log.info("Index payloads")
+        data = os.urandom(1000)
+        other = os.urandom(1000)
+        txids = [self.nodes[0].senddata(base64.b64encode(data).decode('ascii')) for i in range(2)]
+        txid_other = self.nodes[0].senddata(base64.b64encode(other).decode('ascii'))
+
+        # Transactions are indexed once they are mined
+        assert_equal(self.nodes[0].getdatabyhash(sha256(data)), [])
+        blockhash = self.nodes[0].generate(1)[0]
+        height = self.nodes[0].getblockcount()
+
+        result = self.nodes[0].getdatabyhash(sha256(data))
+        assert_equal(sorted(entry['txid'] for entry in result), sorted(txids))
+        assert all(entry['height'] == height for entry in result)
+        assert_equal(len(self.nodes[0].getdatabyhash(sha256(data), 1)), 1)
+        assert_equal(self.nodes[0].getdatabyhash(sha256(other)), [{'txid': txid_other, 'height': height}])
+        assert_equal(self.nodes[0].getdatabyhash(sha256(b"")), [])
+
+        self.log.info("Follow a disconnected block")
+        self.nodes[0].invalidateblock(blockhash)
+        assert_equal(self.nodes[0].getdatabyhash(sha256(data)), [])
+        self.nodes[0].reconsiderblock(blockhash)
+        assert_equal(len(self.nodes[0].getdatabyhash(sha256(data))), 2)
+
+        # Node 0 reorganises to the longer branch of node 1, and mines the
+        # payloads again on top of it
+        self.log.info("Follow a reorganisation")
+        self.nodes[1].generate(3)
+        connect_nodes_bi(self.nodes, 0, 1)
+        sync_blocks(self.nodes)
+        assert_equal(self.nodes[0].getdatabyhash(sha256(data)), [])
+        self.nodes[0].generate(1)
+        self.sync_all()
+        height = self.nodes[0].getblockcount()
+        assert_equal(self.nodes[0].getdatabyhash(sha256(other)), [{'txid': txid_other, 'height': height}])
+
+        self.log.info("Check the index after a restart")
+        self.stop_nodes()
+        self.start_nodes()
+        self.wait_synced()
+        result = self.nodes[0].getdatabyhash(sha256(data))
+        assert_equal(sorted(entry['txid'] for entry in result), sorted(txids))
+        assert_equal(self.nodes[0].getdatabyhash(sha256(other)), [{'txid': txid_other, 'height': height}])
+
+    def wait_synced(self):
+        # The index answers RPC_IN_WARMUP until it has caught up with the tip
+        def synced():
+            try:
+                self.nodes[0].getdatabyhash("00" * 32)
+                return True
+            except Exception:
+                return False
+        wait_until(synced, timeout=60)
+
+def sha256(data):
+    return hashlib.sha256(data).hexdigest()
+
+if __name__ == '__main__':
+    DataHashIndexTest().main()
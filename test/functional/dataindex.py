@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+# Copyright (c) 2017 The Datacoin developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the data payload index.
+
+Store data payloads from empty up to MAX_TX_DATA_SIZE bytes and check that
+getdata returns them unchanged, on a node with -dataindex and on a node
+reading them through the transaction index, also after a restart.
+"""
+import base64
+import os
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+
+MAX_TX_DATA_SIZE = 128 * 1024
+
+class DataIndexTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 2
+        self.extra_args = [["-dataindex"], []]
+
+    def run_test(self):
+        self.nodes[0].generate(101)
+        self.sync_all()
+
+        payloads = {}
+
+        # senddata takes the payload in base64, of at most MAX_TX_DATA_SIZE
+        # characters. Each payload is mined at once so that the next
+        # transaction does not spend its unconfirmed change.
+        self.log.info("Store payloads with senddata")
+        for size in [0, 1, 1000, 65536, MAX_TX_DATA_SIZE * 3 // 4]:
+            data = os.urandom(size)
+            txid = self.nodes[0].senddata(base64.b64encode(data).decode('ascii'))
+            payloads[txid] = data
+            self.nodes[0].generate(1)
+
+        # A payload of MAX_TX_DATA_SIZE bytes only fits through storefile
+        self.log.info("Store a payload of MAX_TX_DATA_SIZE bytes")
+        data = os.urandom(MAX_TX_DATA_SIZE)
+        path = os.path.join(self.options.tmpdir, "payload.bin")
+        with open(path, 'wb') as f:
+            f.write(data)
+        result = self.nodes[0].storefile(path)
+        assert_equal(len(result['chunks']), 1)
+        payloads[result['chunks'][0]] = data
+        self.nodes[0].generate(1)
+        self.sync_all()
+
+        self.check_payloads(payloads)
+
+        self.log.info("Check the payloads after a restart")
+        self.stop_nodes()
+        self.start_nodes()
+        self.check_payloads(payloads)
+
+        assert_raises_rpc_error(-5, "No information available about transaction", self.nodes[0].getdata, "00" * 32)
+
+    def check_payloads(self, payloads):
+        for node in self.nodes:
+            for txid, data in payloads.items():
+                assert_equal(base64.b64decode(node.getdata(txid)), data)
+
+if __name__ == '__main__':
+    DataIndexTest().main()
@@ -10,7 +10,10 @@ from struct import *
 from io import BytesIO
 from codecs import encode
 
+import base64
+import hashlib
 import http.client
+import os
 import urllib.parse
 
 def deser_uint256(f):
@@ -21,9 +24,9 @@ def deser_uint256(f):
     return r
 
 #allows simple http get calls
-def http_get_call(host, port, path, response_object = 0):
+def http_get_call(host, port, path, response_object = 0, headers = {}):
     conn = http.client.HTTPConnection(host, port)
-    conn.request('GET', path)
+    conn.request('GET', path, headers=headers)
 
     if response_object:
         return conn.getresponse()
@@ -46,6 +49,7 @@ class RESTTest (BitcoinTestFramework):
     def set_test_params(self):
         self.setup_clean_chain = True
         self.num_nodes = 3
+        self.extra_args = [["-datahashindex", "-dataindex"], [], []]
 
     def setup_network(self, split=False):
         super().setup_network()
@@ -322,5 +326,102 @@ class RESTTest (BitcoinTestFramework):
         json_obj = json.loads(json_string)
         assert_equal(json_obj['bestblockhash'], bb_hash)
 
+        ##########################
+        # /rest/data/hash/       #
+        ##########################
+
+        data = os.urandom(1000)
+        data_hash = hashlib.sha256(data).hexdigest()
+        data_txid = self.nodes[0].senddata(base64.b64encode(data).decode('ascii'))
+        self.nodes[0].generate(1)
+        self.sync_all()
+        data_height = self.nodes[0].getblockcount()
+
+        json_string = http_get_call(url.hostname, url.port, '/rest/data/hash/'+data_hash+self.FORMAT_SEPARATOR+'json')
+        json_obj = json.loads(json_string)
+        assert_equal(json_obj, [{'txid': data_txid, 'height': data_height}])
+        assert_equal(json_obj, self.nodes[0].getdatabyhash(data_hash))
+
+        # the binary format is the serialized list of (txid, height)
+        response = http_get_call(url.hostname, url.port, '/rest/data/hash/'+data_hash+self.FORMAT_SEPARATOR+'bin', True)
+        assert_equal(response.status, 200)
+        response_bin = response.read()
+        assert_equal(len(response_bin), 1 + 32 + 4)
+        output = BytesIO(response_bin)
+        assert_equal(unpack("B", output.read(1))[0], 1)
+        assert_equal(hex(deser_uint256(output))[2:].zfill(64), data_txid)
+        assert_equal(unpack("<i", output.read(4))[0], data_height)
+
+        response = http_get_call(url.hostname, url.port, '/rest/data/hash/'+data_hash+self.FORMAT_SEPARATOR+'hex', True)
+        assert_equal(response.status, 200)
+        assert_equal(response.read().decode('utf-8').rstrip(), bytes_to_hex_str(response_bin))
+
+        # a payload nobody stored
+        json_string = http_get_call(url.hostname, url.port, '/rest/data/hash/'+'00'*32+self.FORMAT_SEPARATOR+'json')
+        assert_equal(json.loads(json_string), [])
+
+        response = http_get_call(url.hostname, url.port, '/rest/data/hash/'+data_hash[:-2]+self.FORMAT_SEPARATOR+'json', True)
+        assert_equal(response.status, 400)
+
+        # node 2 runs without -datahashindex
+        url2 = urllib.parse.urlparse(self.nodes[2].url)
+        response = http_get_call(url2.hostname, url2.port, '/rest/data/hash/'+data_hash+self.FORMAT_SEPARATOR+'json', True)
+        assert_equal(response.status, 404)
+
+        ##############
+        # /rest/data #
+        ##############
+
+        # node 0 reads payloads through -dataindex, node 2 through the transaction index
+        for data_url in [url, url2]:
+            self.check_rest_data(data_url, data_txid, data)
+
+    def check_rest_data(self, url, txid, data):
+        path = '/rest/data/'+txid+self.FORMAT_SEPARATOR+'bin'
+        size = len(data)
+        etag = '"' + hashlib.sha256(data).hexdigest() + '"'
+
+        # the whole payload, validated by its hash
+        response = http_get_call(url.hostname, url.port, path, True)
+        assert_equal(response.status, 200)
+        assert_equal(response.getheader('ETag'), etag)
+        assert_equal(response.getheader('Accept-Ranges'), 'bytes')
+        assert_equal(int(response.getheader('content-length')), size)
+        assert_equal(response.read(), data)
+
+        response = http_get_call(url.hostname, url.port, path, True, {'If-None-Match': etag})
+        assert_equal(response.status, 304)
+        assert_equal(response.read(), b'')
+
+        response = http_get_call(url.hostname, url.port, path, True, {'If-None-Match': '"' + '00'*32 + '"'})
+        assert_equal(response.status, 200)
+        assert_equal(response.read(), data)
+
+        # byte ranges: bounded, open-ended and suffix
+        for byte_range, start, end in [('10-19', 10, 19), ('100-', 100, size - 1), ('-100', size - 100, size - 1), ('900-5000', 900, size - 1), ('-5000', 0, size - 1)]:
+            response = http_get_call(url.hostname, url.port, path, True, {'Range': 'bytes=' + byte_range})
+            assert_equal(response.status, 206)
+            assert_equal(response.getheader('Content-Range'), 'bytes %d-%d/%d' % (start, end, size))
+            assert_equal(int(response.getheader('content-length')), end - start + 1)
+            assert_equal(response.read(), data[start:end + 1])
+
+        for byte_range in [str(size) + '-', '5000-5010', '-0']:
+            response = http_get_call(url.hostname, url.port, path, True, {'Range': 'bytes=' + byte_range})
+            assert_equal(response.status, 416)
+            assert_equal(response.getheader('Content-Range'), 'bytes */%d' % size)
+
+        # a range is only served while the payload still matches If-Range
+        response = http_get_call(url.hostname, url.port, path, True, {'Range': 'bytes=10-19', 'If-Range': etag})
+        assert_equal(response.status, 206)
+        assert_equal(response.read(), data[10:20])
+
+        response = http_get_call(url.hostname, url.port, path, True, {'Range': 'bytes=10-19', 'If-Range': '"' + '00'*32 + '"'})
+        assert_equal(response.status, 200)
+        assert_equal(response.getheader('Content-Range'), None)
+        assert_equal(response.read(), data)
+
+        response = http_get_call(url.hostname, url.port, '/rest/data/'+'00'*32+self.FORMAT_SEPARATOR+'bin', True)
+        assert_equal(response.status, 404)
+
 if __name__ == '__main__':
     RESTTest ().main ()
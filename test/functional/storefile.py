@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+# Copyright (c) 2017 The Datacoin developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test storefile and retrievefile.
+
+Store a file in several chunks, retrieve it on a node without a wallet, and
+check that retrievefile rejects manifests whose chunks are missing or do not
+hash to the file.
+"""
+import base64
+import hashlib
+import os
+import struct
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+    hex_str_to_bytes,
+)
+
+FILE_MANIFEST_MAGIC = 0x46435444
+
+def ser_manifest(name, data, chunks):
+    """Serialize a file manifest as storefile does"""
+    r = struct.pack("<Ii", FILE_MANIFEST_MAGIC, 1)
+    r += struct.pack("B", len(name)) + name.encode('utf-8')
+    r += struct.pack("<Q", len(data))
+    r += hashlib.sha256(data).digest()
+    r += struct.pack("B", len(chunks))
+    for txid in chunks:
+        r += hex_str_to_bytes(txid)[::-1]
+    return r
+
+class StoreFileTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 2
+        self.extra_args = [[], ["-disablewallet"]]
+
+    def run_test(self):
+        # Every transaction of a file is funded by a confirmed coin of its own
+        self.nodes[0].generate(120)
+        self.sync_all()
+
+        self.log.info("Store a file in several chunks")
+        data = os.urandom(2500)
+        path = os.path.join(self.options.tmpdir, "stored.bin")
+        with open(path, 'wb') as f:
+            f.write(data)
+        result = self.nodes[0].storefile(path, 1000)
+        assert_equal(result['size'], len(data))
+        assert_equal(result['sha256'], hashlib.sha256(data).hexdigest())
+        assert_equal(len(result['chunks']), 3)
+        chunks = result['chunks']
+        manifest = result['manifest']
+        self.nodes[0].generate(1)
+        self.sync_all()
+
+        for i, txid in enumerate(chunks):
+            assert_equal(base64.b64decode(self.nodes[1].getdata(txid)), data[i * 1000:(i + 1) * 1000])
+        assert_equal(base64.b64decode(self.nodes[1].getdata(manifest)), ser_manifest("stored.bin", data, chunks))
+
+        self.log.info("Retrieve the file")
+        path_out = os.path.join(self.options.tmpdir, "retrieved.bin")
+        result = self.nodes[1].retrievefile(manifest, path_out)
+        assert_equal(result['name'], "stored.bin")
+        assert_equal(result['size'], len(data))
+        assert_equal(result['sha256'], hashlib.sha256(data).hexdigest())
+        with open(path_out, 'rb') as f:
+            assert_equal(f.read(), data)
+
+        assert_raises_rpc_error(-8, "already exists", self.nodes[1].retrievefile, manifest, path_out)
+        assert_raises_rpc_error(-22, "Transaction is not a file manifest", self.nodes[1].retrievefile, chunks[0], os.path.join(self.options.tmpdir, "chunk.bin"))
+
+        # Manifests sent with senddata, referencing a chunk that does not
+        # exist and the chunks out of order
+        self.log.info("Reject a missing or tampered chunk")
+        missing = self.nodes[0].senddata(base64.b64encode(ser_manifest("missing.bin", data, [chunks[0], "00" * 32, chunks[2]])).decode('ascii'))
+        tampered = self.nodes[0].senddata(base64.b64encode(ser_manifest("tampered.bin", data, [chunks[1], chunks[0], chunks[2]])).decode('ascii'))
+        self.nodes[0].generate(1)
+        self.sync_all()
+
+        path_missing = os.path.join(self.options.tmpdir, "missing.bin")
+        assert_raises_rpc_error(-1, "Chunk " + "00" * 32 + " not found", self.nodes[1].retrievefile, missing, path_missing)
+        assert not os.path.exists(path_missing)
+
+        path_tampered = os.path.join(self.options.tmpdir, "tampered.bin")
+        assert_raises_rpc_error(-1, "File does not match its manifest", self.nodes[1].retrievefile, tampered, path_tampered)
+        assert not os.path.exists(path_tampered)
+
+if __name__ == '__main__':
+    StoreFileTest().main()
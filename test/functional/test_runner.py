@@ -87,6 +87,9 @@ BASE_SCRIPTS= [
     'txn_clone.py',
     'getchaintips.py',
     'rest.py',
+    'dataindex.py',
+    'datahashindex.py',
+    'storefile.py',
     'mempool_spendcoinbase.py',
     'mempool_reorg.py',
     'mempool_persist.py',